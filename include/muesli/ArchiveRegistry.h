@@ -20,11 +20,14 @@
 #ifndef MUESLI_ARCHIVEREGISTRY_H_
 #define MUESLI_ARCHIVEREGISTRY_H_
 
+#include <type_traits>
+
 #include "muesli/Tags.h"
 
 #include "muesli/detail/IncrementalTypeList.h"
 #include "muesli/detail/DelayStaticAssert.h"
 #include "muesli/detail/TemplateHolder.h"
+#include "muesli/detail/TypeList.h"
 
 namespace muesli
 {
@@ -47,6 +50,34 @@ struct TagTraits
 {
     static_assert(detail::DelayStaticAssert<Archive>::value, "no Tag registered for this Archive");
 };
+
+// concrete archives for MUESLI_SELECT_POLYMORPHIC_ARCHIVES
+template <typename... Archives>
+using ArchiveList = detail::TypeList<Archives...>;
+
+namespace detail
+{
+// the archives polymorphic types are registered for, void stands for all registered archives
+// this is implicitly instantiated by the first polymorphic registration, which fixes the
+// selection for the rest of the translation unit
+template <typename Tag>
+struct PolymorphicArchiveSelection
+{
+    using InputArchives = void;
+    using OutputArchives = void;
+};
+
+template <typename Archives>
+struct IsArchiveSelection : std::is_void<Archives>
+{
+};
+
+template <typename... Archives>
+struct IsArchiveSelection<TypeList<Archives...>>
+        : std::integral_constant<bool, (sizeof...(Archives) > 0)>
+{
+};
+} // namespace detail
 } // namespace muesli
 
 #define MUESLI_REGISTER_ARCHIVE(Category, Archive, ArchiveTag)                                     \
@@ -82,4 +113,33 @@ struct TagTraits
 #define MUESLI_REGISTER_OUTPUT_ARCHIVE(Archive, ArchiveTag)                                        \
     MUESLI_REGISTER_ARCHIVE(OutputArchive, Archive, ArchiveTag)
 
+// registers a concrete archive type which does not write to a registered OutputStream
+#define MUESLI_REGISTER_OUTPUT_ARCHIVE_INSTANCE(Archive)                                           \
+    MUESLI_ADD_TO_INCREMENTAL_TYPELIST(muesli::tags::OutputArchiveInstance, Archive)
+
+// restricts all polymorphic types to the given lists of concrete archives instead of every
+// combination of registered archives and streams, e.g.
+//   using PolymorphicOutputArchives = muesli::ArchiveList<JsonOutputArchive<StringOStream>>;
+//   MUESLI_SELECT_POLYMORPHIC_ARCHIVES(void, PolymorphicOutputArchives)
+// 'void' keeps all registered archives of that direction
+// the selection is made once, in a header which every translation unit registering polymorphic
+// types includes; a selection following the first polymorphic registration does not compile
+#define MUESLI_SELECT_POLYMORPHIC_ARCHIVES(InputArchiveList, OutputArchiveList)                    \
+    namespace muesli                                                                               \
+    {                                                                                              \
+    namespace detail                                                                               \
+    {                                                                                              \
+    template <>                                                                                    \
+    struct PolymorphicArchiveSelection<tags::PolymorphicArchives>                                  \
+    {                                                                                              \
+        static_assert(IsArchiveSelection<InputArchiveList>::value,                                 \
+                      "input archives must be void or a non-empty muesli::ArchiveList");           \
+        static_assert(IsArchiveSelection<OutputArchiveList>::value,                                \
+                      "output archives must be void or a non-empty muesli::ArchiveList");          \
+        using InputArchives = InputArchiveList;                                                    \
+        using OutputArchives = OutputArchiveList;                                                  \
+    };                                                                                             \
+    } /* namespace detail */                                                                       \
+    } /* namespace muesli */
+
 #endif // MUESLI_ARCHIVEREGISTRY_H_
@@ -0,0 +1,52 @@
+/*
+ * #%L
+ * %%
+ * Copyright (C) 2011 - 2016 BMW Car IT GmbH
+ * %%
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ * 
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ * 
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ * #L%
+ */
+
+#ifndef MUESLI_COLUMNAR_H_
+#define MUESLI_COLUMNAR_H_
+
+namespace muesli
+{
+
+// wrapper which tells the archive to serialize a container of flat structs column by column:
+// one array per field instead of one object per element
+template <typename Container>
+struct Columnar
+{
+    explicit Columnar(const Container* wrapped) : _wrapped(const_cast<Container*>(wrapped))
+    {
+    }
+
+    Container* _wrapped;
+};
+
+template <typename Container>
+Columnar<Container> make_columnar(Container& container)
+{
+    return Columnar<Container>(&container);
+}
+
+template <typename Container>
+Columnar<Container> make_columnar(const Container& container)
+{
+    return Columnar<Container>(&container);
+}
+
+} // namespace muesli
+
+#endif // MUESLI_COLUMNAR_H_
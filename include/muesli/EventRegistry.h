@@ -0,0 +1,64 @@
+/*
+ * #%L
+ * %%
+ * Copyright (C) 2011 - 2016 BMW Car IT GmbH
+ * %%
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ * 
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ * 
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ * #L%
+ */
+
+#ifndef MUESLI_EVENTREGISTRY_H_
+#define MUESLI_EVENTREGISTRY_H_
+
+#include "muesli/detail/DelayStaticAssert.h"
+
+// An EventReader is constructed from an InputStream and reports the serialized value as
+// RapidJSON SAX events to a handler passed to parse(handler).
+// An EventWriter is constructed from an OutputStream and is such a handler, its Flush() flushes
+// the OutputStream.
+
+namespace muesli
+{
+template <typename ArchiveTag>
+struct EventReaderTraits
+{
+    static_assert(detail::DelayStaticAssert<ArchiveTag>::value,
+                  "no EventReader registered for this ArchiveTag");
+};
+
+template <typename ArchiveTag>
+struct EventWriterTraits
+{
+    static_assert(detail::DelayStaticAssert<ArchiveTag>::value,
+                  "no EventWriter registered for this ArchiveTag");
+};
+} // namespace muesli
+
+#define MUESLI_REGISTER_EVENT(Category, Implementation, ArchiveTag)                                \
+    namespace muesli                                                                               \
+    {                                                                                              \
+    template <>                                                                                    \
+    struct Category##Traits<ArchiveTag>                                                            \
+    {                                                                                              \
+        template <typename... Ts>                                                                  \
+        using type = Implementation<Ts...>;                                                        \
+    };                                                                                             \
+    } /*namespace muesli */
+
+#define MUESLI_REGISTER_EVENT_READER(Reader, ArchiveTag)                                           \
+    MUESLI_REGISTER_EVENT(EventReader, Reader, ArchiveTag)
+
+#define MUESLI_REGISTER_EVENT_WRITER(Writer, ArchiveTag)                                           \
+    MUESLI_REGISTER_EVENT(EventWriter, Writer, ArchiveTag)
+
+#endif // MUESLI_EVENTREGISTRY_H_
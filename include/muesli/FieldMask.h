@@ -0,0 +1,149 @@
+/*
+ * #%L
+ * %%
+ * Copyright (C) 2011 - 2016 BMW Car IT GmbH
+ * %%
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ * 
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ * 
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ * #L%
+ */
+
+#ifndef MUESLI_FIELDMASK_H_
+#define MUESLI_FIELDMASK_H_
+
+#include <cstddef>
+#include <functional>
+#include <initializer_list>
+#include <map>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "muesli/detail/ThrowException.h"
+
+namespace muesli
+{
+
+// set of dotted field paths, e.g. "header.id", restricting which NameValuePairs an input archive
+// loads; a path selects the whole subtree of its last field, fields of array elements are
+// addressed through the array field; an empty mask selects all fields
+class FieldMask
+{
+public:
+    FieldMask() : _nodes(1, Node{{}, true})
+    {
+    }
+
+    FieldMask(std::initializer_list<std::string> paths) : FieldMask(paths.begin(), paths.end())
+    {
+    }
+
+    explicit FieldMask(const std::vector<std::string>& paths)
+            : FieldMask(paths.begin(), paths.end())
+    {
+    }
+
+    std::size_t getRoot() const
+    {
+        return 0;
+    }
+
+    // moves 'field' to its child 'name', returns false if the child is not selected
+    bool selectField(std::size_t& field, const char* name) const
+    {
+        const Node& node = _nodes[field];
+        if (node._selectsAll) {
+            return true;
+        }
+        auto it = node._children.find(name);
+        if (it == node._children.end()) {
+            return false;
+        }
+        field = it->second;
+        return true;
+    }
+
+    // the mask of the subtree below 'field', with 'field' as its root
+    FieldMask getSubmask(std::size_t field) const
+    {
+        FieldMask submask;
+        submask._nodes.clear();
+        submask.copySubtree(*this, field);
+        return submask;
+    }
+
+private:
+    struct Node
+    {
+        std::map<std::string, std::size_t, std::less<>> _children;
+        bool _selectsAll;
+    };
+
+    template <typename Iterator>
+    FieldMask(Iterator begin, Iterator end) : _nodes(1, Node{{}, begin == end})
+    {
+        for (; begin != end; ++begin) {
+            addPath(*begin);
+        }
+    }
+
+    void addPath(const std::string& path)
+    {
+        std::size_t field = getRoot();
+        std::size_t begin = 0;
+        while (!_nodes[field]._selectsAll) {
+            std::size_t end = path.find('.', begin);
+            if (end == std::string::npos) {
+                end = path.size();
+            }
+            if (end == begin) {
+                detail::throwException(
+                        std::invalid_argument("Invalid field path \"" + path + "\"."));
+            }
+            field = getOrAddChild(field, path.substr(begin, end - begin));
+            if (end == path.size()) {
+                _nodes[field]._children.clear();
+                _nodes[field]._selectsAll = true;
+            }
+            begin = end + 1;
+        }
+    }
+
+    std::size_t getOrAddChild(std::size_t field, std::string name)
+    {
+        auto it = _nodes[field]._children.find(name);
+        if (it != _nodes[field]._children.end()) {
+            return it->second;
+        }
+        const std::size_t child = _nodes.size();
+        _nodes.push_back(Node{{}, false});
+        _nodes[field]._children.emplace(std::move(name), child);
+        return child;
+    }
+
+    std::size_t copySubtree(const FieldMask& mask, std::size_t field)
+    {
+        const std::size_t copy = _nodes.size();
+        _nodes.push_back(Node{{}, mask._nodes[field]._selectsAll});
+        for (const auto& child : mask._nodes[field]._children) {
+            const std::size_t childCopy = copySubtree(mask, child.second);
+            _nodes[copy]._children.emplace(child.first, childCopy);
+        }
+        return copy;
+    }
+
+    std::vector<Node> _nodes;
+};
+
+} // namespace muesli
+
+#endif // MUESLI_FIELDMASK_H_
@@ -0,0 +1,109 @@
+/*
+ * #%L
+ * %%
+ * Copyright (C) 2011 - 2016 BMW Car IT GmbH
+ * %%
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ * 
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ * 
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ * #L%
+ */
+
+#ifndef MUESLI_LOADERROR_H_
+#define MUESLI_LOADERROR_H_
+
+#include <stdexcept>
+#include <string>
+#include <utility>
+
+#include "muesli/detail/ThrowException.h"
+#include "muesli/exceptions/ParseException.h"
+#include "muesli/exceptions/UnknownTypeException.h"
+#include "muesli/exceptions/ValueNotFoundException.h"
+
+namespace muesli
+{
+
+// first failure of a load which records errors instead of throwing
+// each code corresponds to the exception which is thrown otherwise
+class LoadError
+{
+public:
+    enum class Code {
+        None,
+        Parse,         // exceptions::ParseException
+        InvalidValue,  // std::invalid_argument
+        ValueNotFound, // exceptions::ValueNotFoundException
+        UnknownType    // exceptions::UnknownTypeException
+    };
+
+    LoadError() : _code(Code::None), _message()
+    {
+    }
+
+    explicit operator bool() const
+    {
+        return _code != Code::None;
+    }
+
+    Code getCode() const
+    {
+        return _code;
+    }
+
+    const std::string& getMessage() const
+    {
+        return _message;
+    }
+
+    // keeps the first error, later ones are usually follow-up errors
+    void set(Code code, std::string message)
+    {
+        if (_code == Code::None) {
+            _code = code;
+            _message = std::move(message);
+        }
+    }
+
+    void clear()
+    {
+        _code = Code::None;
+        _message.clear();
+    }
+
+private:
+    Code _code;
+    std::string _message;
+};
+
+namespace detail
+{
+
+[[noreturn]] inline void throwLoadError(LoadError::Code code, const std::string& message)
+{
+    switch (code) {
+    case LoadError::Code::Parse:
+        throwException(exceptions::ParseException(message));
+    case LoadError::Code::ValueNotFound:
+        throwException(exceptions::ValueNotFoundException(message));
+    case LoadError::Code::UnknownType:
+        throwException(exceptions::UnknownTypeException(message));
+    case LoadError::Code::None:
+    case LoadError::Code::InvalidValue:
+        break;
+    }
+    throwException(std::invalid_argument(message));
+}
+
+} // namespace detail
+} // namespace muesli
+
+#endif // MUESLI_LOADERROR_H_
@@ -0,0 +1,348 @@
+/*
+ * #%L
+ * %%
+ * Copyright (C) 2011 - 2016 BMW Car IT GmbH
+ * %%
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ * 
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ * 
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ * #L%
+ */
+
+#ifndef MUESLI_MEMORYRESOURCE_H_
+#define MUESLI_MEMORYRESOURCE_H_
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <new>
+#include <string>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace muesli
+{
+
+// source of memory for ResourceAllocator, modeled after std::pmr::memory_resource which is not
+// available in C++14
+class MemoryResource
+{
+public:
+    virtual ~MemoryResource() = default;
+
+    void* allocate(std::size_t bytes, std::size_t alignment = alignof(std::max_align_t))
+    {
+        return doAllocate(bytes, alignment);
+    }
+
+    void deallocate(void* ptr,
+                    std::size_t bytes,
+                    std::size_t alignment = alignof(std::max_align_t))
+    {
+        doDeallocate(ptr, bytes, alignment);
+    }
+
+    bool isEqual(const MemoryResource& other) const noexcept
+    {
+        return this == &other || doIsEqual(other);
+    }
+
+private:
+    virtual void* doAllocate(std::size_t bytes, std::size_t alignment) = 0;
+    virtual void doDeallocate(void* ptr, std::size_t bytes, std::size_t alignment) = 0;
+
+    virtual bool doIsEqual(const MemoryResource& other) const noexcept
+    {
+        std::ignore = other;
+        return false;
+    }
+};
+
+namespace detail
+{
+
+class NewDeleteMemoryResource : public MemoryResource
+{
+private:
+    void* doAllocate(std::size_t bytes, std::size_t alignment) override
+    {
+        std::ignore = alignment;
+        return ::operator new(bytes);
+    }
+
+    void doDeallocate(void* ptr, std::size_t bytes, std::size_t alignment) override
+    {
+        std::ignore = bytes;
+        std::ignore = alignment;
+        ::operator delete(ptr);
+    }
+};
+
+// nullptr selects the NewDeleteMemoryResource
+inline MemoryResource*& currentMemoryResource()
+{
+    static thread_local MemoryResource* current = nullptr;
+    return current;
+}
+
+} // namespace detail
+
+// resource which uses operator new and delete
+inline MemoryResource* getNewDeleteMemoryResource()
+{
+    static detail::NewDeleteMemoryResource newDeleteMemoryResource;
+    return &newDeleteMemoryResource;
+}
+
+// resource used by default constructed ResourceAllocators of the calling thread
+inline MemoryResource* getCurrentMemoryResource()
+{
+    MemoryResource* current = detail::currentMemoryResource();
+    return current != nullptr ? current : getNewDeleteMemoryResource();
+}
+
+// makes 'resource' the current resource of the calling thread until the end of the scope
+class ScopedMemoryResource
+{
+public:
+    explicit ScopedMemoryResource(MemoryResource* resource)
+            : _previous(detail::currentMemoryResource())
+    {
+        detail::currentMemoryResource() = resource;
+    }
+
+    ~ScopedMemoryResource()
+    {
+        detail::currentMemoryResource() = _previous;
+    }
+
+    ScopedMemoryResource(const ScopedMemoryResource&) = delete;
+    ScopedMemoryResource& operator=(const ScopedMemoryResource&) = delete;
+
+private:
+    MemoryResource* _previous;
+};
+
+// arena which hands out memory from growing chunks and frees it all at once when it is released
+// or destroyed; deallocate() does nothing, hence objects allocated from it have to be destroyed
+// before the arena
+class MonotonicMemoryResource : public MemoryResource
+{
+public:
+    explicit MonotonicMemoryResource(std::size_t initialChunkSize = 4096)
+            : _chunks(),
+              _current(nullptr),
+              _remaining(0),
+              _nextChunkSize(std::max<std::size_t>(initialChunkSize, 64)),
+              _allocatedBytes(0)
+    {
+    }
+
+    ~MonotonicMemoryResource() override
+    {
+        release();
+    }
+
+    MonotonicMemoryResource(const MonotonicMemoryResource&) = delete;
+    MonotonicMemoryResource& operator=(const MonotonicMemoryResource&) = delete;
+
+    void release()
+    {
+        for (void* chunk : _chunks) {
+            ::operator delete(chunk);
+        }
+        _chunks.clear();
+        _current = nullptr;
+        _remaining = 0;
+        _allocatedBytes = 0;
+    }
+
+    // number of bytes handed out since construction or the last release()
+    std::size_t getAllocatedBytes() const
+    {
+        return _allocatedBytes;
+    }
+
+private:
+    void* doAllocate(std::size_t bytes, std::size_t alignment) override
+    {
+        void* ptr = std::align(alignment, bytes, _current, _remaining);
+        if (ptr == nullptr) {
+            addChunk(bytes + alignment);
+            ptr = std::align(alignment, bytes, _current, _remaining);
+        }
+        _current = static_cast<char*>(ptr) + bytes;
+        _remaining -= bytes;
+        _allocatedBytes += bytes;
+        return ptr;
+    }
+
+    void doDeallocate(void* ptr, std::size_t bytes, std::size_t alignment) override
+    {
+        std::ignore = ptr;
+        std::ignore = bytes;
+        std::ignore = alignment;
+    }
+
+    void addChunk(std::size_t minimumSize)
+    {
+        const std::size_t size = std::max(_nextChunkSize, minimumSize);
+        _chunks.reserve(_chunks.size() + 1);
+        _current = ::operator new(size);
+        _chunks.push_back(_current);
+        _remaining = size;
+        _nextChunkSize = size * 2;
+    }
+
+    std::vector<void*> _chunks;
+    void* _current;
+    std::size_t _remaining;
+    std::size_t _nextChunkSize;
+    std::size_t _allocatedBytes;
+};
+
+// allocator which forwards to a MemoryResource, modeled after std::pmr::polymorphic_allocator
+// a default constructed allocator uses the current resource of the calling thread, so objects
+// created while an archive loads with a resource use it as well
+template <typename T>
+class ResourceAllocator
+{
+public:
+    using value_type = T;
+
+    ResourceAllocator() noexcept : _resource(getCurrentMemoryResource())
+    {
+    }
+
+    // implicit like std::pmr::polymorphic_allocator
+    ResourceAllocator(MemoryResource* resource) noexcept : _resource(resource)
+    {
+    }
+
+    template <typename U>
+    ResourceAllocator(const ResourceAllocator<U>& other) noexcept
+            : _resource(other.getResource())
+    {
+    }
+
+    T* allocate(std::size_t count)
+    {
+        return static_cast<T*>(_resource->allocate(count * sizeof(T), alignof(T)));
+    }
+
+    void deallocate(T* ptr, std::size_t count)
+    {
+        _resource->deallocate(ptr, count * sizeof(T), alignof(T));
+    }
+
+    // uses-allocator construction like std::pmr::polymorphic_allocator: elements which take a
+    // ResourceAllocator, e.g. the ResourceStrings of a ResourceVector, use the resource of their
+    // container instead of the current one
+    template <typename U, typename... Args>
+    void construct(U* ptr, Args&&... args)
+    {
+        constructWith(UsesAllocator<U, Args...>(), ptr, std::forward<Args>(args)...);
+    }
+
+    // copies of containers use the current resource instead of the one of the original
+    ResourceAllocator select_on_container_copy_construction() const
+    {
+        return ResourceAllocator();
+    }
+
+    MemoryResource* getResource() const noexcept
+    {
+        return _resource;
+    }
+
+private:
+    template <typename U, typename... Args>
+    struct IsLeadingAllocatorConstructible
+            : std::is_constructible<U,
+                                    std::allocator_arg_t,
+                                    const ResourceAllocator&,
+                                    Args...>
+    {
+    };
+
+    // 0: 'U' does not use an allocator, 1: the allocator is passed after std::allocator_arg,
+    // 2: the allocator is passed last
+    template <typename U, typename... Args>
+    struct UsesAllocator
+            : std::integral_constant<int,
+                                     !std::uses_allocator<U, ResourceAllocator>::value
+                                             ? 0
+                                             : IsLeadingAllocatorConstructible<U, Args...>::value
+                                                       ? 1
+                                                       : 2>
+    {
+    };
+
+    template <typename U, typename... Args>
+    void constructWith(std::integral_constant<int, 0>, U* ptr, Args&&... args)
+    {
+        ::new (static_cast<void*>(ptr)) U(std::forward<Args>(args)...);
+    }
+
+    template <typename U, typename... Args>
+    void constructWith(std::integral_constant<int, 1>, U* ptr, Args&&... args)
+    {
+        ::new (static_cast<void*>(ptr)) U(std::allocator_arg, *this, std::forward<Args>(args)...);
+    }
+
+    template <typename U, typename... Args>
+    void constructWith(std::integral_constant<int, 2>, U* ptr, Args&&... args)
+    {
+        const typename U::allocator_type allocator(_resource);
+        ::new (static_cast<void*>(ptr)) U(std::forward<Args>(args)..., allocator);
+    }
+
+    MemoryResource* _resource;
+};
+
+template <typename T, typename U>
+bool operator==(const ResourceAllocator<T>& lhs, const ResourceAllocator<U>& rhs) noexcept
+{
+    return lhs.getResource()->isEqual(*rhs.getResource());
+}
+
+template <typename T, typename U>
+bool operator!=(const ResourceAllocator<T>& lhs, const ResourceAllocator<U>& rhs) noexcept
+{
+    return !(lhs == rhs);
+}
+
+using ResourceString = std::basic_string<char, std::char_traits<char>, ResourceAllocator<char>>;
+
+template <typename T>
+using ResourceVector = std::vector<T, ResourceAllocator<T>>;
+
+namespace detail
+{
+
+// shared_ptrs are allocated from the current resource unless it is the default one
+template <typename T>
+std::shared_ptr<T> makeShared()
+{
+    MemoryResource* resource = getCurrentMemoryResource();
+    if (resource == getNewDeleteMemoryResource()) {
+        return std::make_shared<T>();
+    }
+    return std::allocate_shared<T>(ResourceAllocator<T>(resource));
+}
+
+} // namespace detail
+} // namespace muesli
+
+#endif // MUESLI_MEMORYRESOURCE_H_
@@ -0,0 +1,63 @@
+/*
+ * #%L
+ * %%
+ * Copyright (C) 2011 - 2016 BMW Car IT GmbH
+ * %%
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ * 
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ * 
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ * #L%
+ */
+
+#ifndef MUESLI_NAMEVALUEPAIRWITHDEFAULT_H_
+#define MUESLI_NAMEVALUEPAIRWITHDEFAULT_H_
+
+#include <type_traits>
+#include <utility>
+
+#include "muesli/NameValuePair.h"
+#include "muesli/Traits.h"
+
+namespace muesli
+{
+
+// NameValuePair whose value is set to '_default' when an input archive does not find the field,
+// instead of throwing a ValueNotFoundException; output archives write it like a NameValuePair
+template <typename T, typename Default>
+struct NameValuePairWithDefault
+{
+    NameValuePairWithDefault(const char* name, T& value, Default defaultValue)
+            : _name(name), _value(value), _default(std::move(defaultValue))
+    {
+    }
+
+    const char* _name;
+    T& _value;
+    Default _default;
+};
+
+// the wrapped value gets intro/outro through the NameValuePair it is forwarded to
+template <typename T, typename Default>
+struct SkipIntroOutroTraits<NameValuePairWithDefault<T, Default>> : std::true_type
+{
+};
+
+template <typename T, typename Default>
+NameValuePairWithDefault<T, std::decay_t<Default>> make_nvp_default(const char* name,
+                                                                    T& value,
+                                                                    Default&& defaultValue)
+{
+    return {name, value, std::forward<Default>(defaultValue)};
+}
+
+} // namespace muesli
+
+#endif // MUESLI_NAMEVALUEPAIRWITHDEFAULT_H_
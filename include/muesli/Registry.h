@@ -22,12 +22,7 @@
 
 #include <type_traits>
 
-#include <boost/mpl/transform.hpp>
-#include <boost/mpl/identity.hpp>
-#include <boost/mpl/size.hpp>
-
 #include "muesli/detail/CartesianTypeProduct.h"
-#include "muesli/detail/FlattenMplSequence.h"
 #include "muesli/detail/IncrementalTypeList.h"
 #include "muesli/detail/TypeList.h"
 #include "muesli/Tags.h"
@@ -41,12 +36,13 @@ using RegisteredInputStreams = MUESLI_GET_INCREMENTAL_TYPELIST(muesli::tags::Inp
 using RegisteredOutputArchives = MUESLI_GET_INCREMENTAL_TYPELIST(muesli::tags::OutputArchive);
 using RegisteredInputArchives = MUESLI_GET_INCREMENTAL_TYPELIST(muesli::tags::InputArchive);
 
+// archives which do not write to an OutputStream and are hence registered as concrete types
+using RegisteredOutputArchiveInstances =
+        MUESLI_GET_INCREMENTAL_TYPELIST(muesli::tags::OutputArchiveInstance);
+
 namespace detail
 {
 
-template <typename List>
-using ListSize = boost::mpl::size<List>;
-
 static_assert(0 != ListSize<RegisteredOutputStreams>::value, "no OutputStream registered");
 static_assert(0 != ListSize<RegisteredInputStreams>::value, "no InputStream registered");
 static_assert(0 != ListSize<RegisteredOutputArchives>::value, "no OutputArchive registered");
@@ -64,9 +60,11 @@ struct CombineArchiveAndStream
 };
 } // namespace detail
 
-using OutputArchiveTypeVector = detail::FlatCartesianTypeProduct<RegisteredOutputArchives,
-                                                                 RegisteredOutputStreams,
-                                                                 detail::CombineArchiveAndStream>;
+using OutputArchiveTypeVector = typename detail::Concat<
+        detail::FlatCartesianTypeProduct<RegisteredOutputArchives,
+                                         RegisteredOutputStreams,
+                                         detail::CombineArchiveAndStream>,
+        RegisteredOutputArchiveInstances>::type;
 using InputArchiveTypeVector = detail::FlatCartesianTypeProduct<RegisteredInputArchives,
                                                                 RegisteredInputStreams,
                                                                 detail::CombineArchiveAndStream>;
@@ -27,6 +27,8 @@ namespace tags
 {
 struct InputArchive;
 struct OutputArchive;
+struct OutputArchiveInstance;
+struct PolymorphicArchives;
 
 struct InputStream;
 struct OutputStream;
@@ -0,0 +1,48 @@
+/*
+ * #%L
+ * %%
+ * Copyright (C) 2011 - 2016 BMW Car IT GmbH
+ * %%
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ * 
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ * 
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ * #L%
+ */
+
+#ifndef MUESLI_TRANSCODER_H_
+#define MUESLI_TRANSCODER_H_
+
+#include "muesli/EventRegistry.h"
+
+namespace muesli
+{
+
+// converts a value serialized in the format of InputArchiveTag into the format of
+// OutputArchiveTag without loading it into C++ objects
+// the EventReader and EventWriter of both formats have to be registered, i.e. their archive
+// headers have to be included
+template <typename InputArchiveTag,
+          typename OutputArchiveTag,
+          typename InputStream,
+          typename OutputStream>
+void transcode(InputStream& inputStream, OutputStream& outputStream)
+{
+    using EventReader = typename EventReaderTraits<InputArchiveTag>::template type<InputStream>;
+    using EventWriter = typename EventWriterTraits<OutputArchiveTag>::template type<OutputStream>;
+    EventReader reader(inputStream);
+    EventWriter writer(outputStream);
+    reader.parse(writer);
+    writer.Flush();
+}
+
+} // namespace muesli
+
+#endif // MUESLI_TRANSCODER_H_
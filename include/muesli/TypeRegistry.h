@@ -20,20 +20,30 @@
 #ifndef MUESLI_TYPEREGISTRY_H_
 #define MUESLI_TYPEREGISTRY_H_
 
+#include <array>
+#include <cstddef>
+#include <cstdint>
 #include <unordered_map>
 #include <functional>
+#include <memory>
+#include <stdexcept>
 #include <string>
+#include <typeinfo>
 #include <typeindex>
 #include <type_traits>
 
-#include <boost/mpl/joint_view.hpp>
 #include <boost/optional.hpp>
 
 #include "muesli/detail/TypeList.h"
-#include "muesli/detail/FlattenMplSequence.h"
+#include "muesli/detail/CartesianTypeProduct.h"
 #include "muesli/detail/IncrementalTypeList.h"
+#include "muesli/detail/PerfectHashTable.h"
+#include "muesli/detail/PublishedSnapshot.h"
+#include "muesli/detail/ThrowException.h"
 #include "muesli/detail/VoidT.h"
 
+#include "muesli/ArchiveRegistry.h"
+#include "muesli/MemoryResource.h"
 #include "muesli/Registry.h"
 #include "muesli/SkipIntroOutroWrapper.h"
 #include "muesli/Tags.h"
@@ -62,6 +72,10 @@ protected:
 };
 } // namespace detail
 
+// while a RegistrationBatch exists, registrations in all type registries are published when the
+// last batch ends instead of one by one, e.g. to register all types of a plugin at once
+using RegistrationBatch = detail::PublicationBatch;
+
 template <typename Base, typename InputArchive>
 class TypeLoadRegistry : detail::TypeRegistryBase
 {
@@ -70,27 +84,199 @@ public:
     // deserialization
     // it returns a std::unique_ptr<Base>
     using LoadFunction = std::add_pointer_t<std::unique_ptr<Base>(InputArchive&)>;
+    // same as LoadFunction, but allocates the object together with its reference count
+    using SharedLoadFunction = std::add_pointer_t<std::shared_ptr<Base>(InputArchive&)>;
+    // loads into an existing object whose dynamic type is the registered type
+    using InPlaceLoadFunction = std::add_pointer_t<void(InputArchive&, Base*)>;
 
+    // 'typeName' may be the registered name or the registered alias of the type
     static boost::optional<LoadFunction> getLoadFunction(const std::string& typeName)
     {
-        return getFunction(typeName, getLoadFunctionMap());
+        return getLoadFunction(typeName.data(), typeName.size());
+    }
+
+    static boost::optional<LoadFunction> getLoadFunction(const char* typeName, std::size_t length)
+    {
+        boost::optional<LoadFunction> function;
+        if (boost::optional<LoadFunctions> functions = findLoadFunctions(typeName, length)) {
+            function = functions->_load;
+        }
+        return function;
+    }
+
+    static boost::optional<SharedLoadFunction> getSharedLoadFunction(const std::string& typeName)
+    {
+        return getSharedLoadFunction(typeName.data(), typeName.size());
+    }
+
+    static boost::optional<SharedLoadFunction> getSharedLoadFunction(const char* typeName,
+                                                                     std::size_t length)
+    {
+        boost::optional<SharedLoadFunction> function;
+        if (boost::optional<LoadFunctions> functions = findLoadFunctions(typeName, length)) {
+            function = functions->_loadShared;
+        }
+        return function;
+    }
+
+    // returns a function if the dynamic type 'typeId' has been registered as 'typeName'
+    static boost::optional<InPlaceLoadFunction> getInPlaceLoadFunction(
+            const std::type_index& typeId,
+            const std::string& typeName)
+    {
+        return getLoadFunctionTable().read([&](const Snapshot& snapshot) {
+            boost::optional<InPlaceLoadFunction> function;
+            auto it = snapshot._inPlaceLoadFunctions.find(typeId);
+            if (it != snapshot._inPlaceLoadFunctions.cend() &&
+                it->second.isRegisteredAs(typeName)) {
+                function = it->second._load;
+            }
+            return function;
+        });
+    }
+
+    // the first lookup after registrations publishes a snapshot of the registered types, with the
+    // names compiled into a perfect hash table, which serves all following lookups without
+    // locking; hence the registrations of static initialization are compiled once; within a
+    // RegistrationBatch the snapshot is published when the batch ends or freeze() is called
+    static void freeze()
+    {
+        getLoadFunctionTable().publish();
+    }
+
+    // true unless registrations wait for the next lookup or for an open RegistrationBatch
+    static bool isFrozen()
+    {
+        return getLoadFunctionTable().isPublished();
+    }
+
+    // registers a type, also safe at runtime while other threads load, e.g. from a plugin
+    // use a RegistrationBatch to publish several types at once, also if lookups happen meanwhile
+    // 'typeAlias' is nullptr for types registered without an alias
+    // throws std::invalid_argument if the name or alias is already taken by another type
+    static void insert(const std::string& typeName,
+                       const char* typeAlias,
+                       const std::type_index& typeId,
+                       LoadFunction loadFunction,
+                       SharedLoadFunction sharedLoadFunction,
+                       InPlaceLoadFunction inPlaceLoadFunction)
+    {
+        const LoadFunctions loadFunctions{loadFunction, sharedLoadFunction};
+        const InPlaceLoad inPlaceLoad{typeName, typeAlias ? typeAlias : "", inPlaceLoadFunction};
+        getLoadFunctionTable().modify([&](Registrations& registrations) {
+            registrations.checkUnclaimed(typeName, typeId);
+            if (typeAlias != nullptr) {
+                registrations.checkUnclaimed(typeAlias, typeId);
+            }
+            registrations.add(typeName, typeId, loadFunctions);
+            if (typeAlias != nullptr) {
+                registrations.add(typeAlias, typeId, loadFunctions);
+            }
+            registrations._inPlaceLoadFunctions.insert({typeId, inPlaceLoad});
+        });
     }
 
 private:
-    using TypeNameToLoadFunctionMap = std::unordered_map<std::string, LoadFunction>;
+    struct LoadFunctions
+    {
+        LoadFunction _load;
+        SharedLoadFunction _loadShared;
+    };
+
+    struct InPlaceLoad
+    {
+        bool isRegisteredAs(const std::string& typeName) const
+        {
+            return typeName == _typeName || (!_typeAlias.empty() && typeName == _typeAlias);
+        }
+
+        std::string _typeName;
+        std::string _typeAlias;
+        InPlaceLoadFunction _load;
+    };
+
+    using TypeIdToInPlaceLoadFunctionMap = std::unordered_map<std::type_index, InPlaceLoad>;
+
+    // a type registered with an alias has a second entry under its alias
+    struct Registrations
+    {
+        Registrations() : _loadFunctions(), _typeIds(), _inPlaceLoadFunctions()
+        {
+        }
 
-    static TypeNameToLoadFunctionMap& getLoadFunctionMap()
+        // a type would otherwise be loaded silently as the other type sharing its name
+        void checkUnclaimed(const std::string& name, const std::type_index& typeId) const
+        {
+            auto it = _typeIds.find(name);
+            if (it != _typeIds.cend() && it->second != typeId) {
+                detail::throwException(std::invalid_argument(
+                        "muesli: '" + name + "' is already registered for another type"));
+            }
+        }
+
+        void add(const std::string& name,
+                 const std::type_index& typeId,
+                 const LoadFunctions& loadFunctions)
+        {
+            _loadFunctions.insert({name, loadFunctions});
+            _typeIds.insert({name, typeId});
+        }
+
+        std::unordered_map<std::string, LoadFunctions> _loadFunctions;
+        // type registered under each name and alias
+        std::unordered_map<std::string, std::type_index> _typeIds;
+        TypeIdToInPlaceLoadFunctionMap _inPlaceLoadFunctions;
+    };
+
+    struct Snapshot
     {
-        static TypeNameToLoadFunctionMap loadFunctionMap;
-        return loadFunctionMap;
+        explicit Snapshot(const Registrations& registrations)
+                : _hashTable(), _inPlaceLoadFunctions(registrations._inPlaceLoadFunctions)
+        {
+            _hashTable.build(registrations._loadFunctions.cbegin(),
+                             registrations._loadFunctions.cend());
+        }
+
+        detail::PerfectHashTable<LoadFunctions> _hashTable;
+        TypeIdToInPlaceLoadFunctionMap _inPlaceLoadFunctions;
+    };
+
+    using LoadFunctionTable = detail::PublishedSnapshot<Registrations, Snapshot>;
+
+    static LoadFunctionTable& getLoadFunctionTable()
+    {
+        static LoadFunctionTable loadFunctionTable;
+        return loadFunctionTable;
+    }
+
+    static boost::optional<LoadFunctions> findLoadFunctions(const char* typeName,
+                                                            std::size_t length)
+    {
+        return getLoadFunctionTable().read([&](const Snapshot& snapshot) {
+            boost::optional<LoadFunctions> functions;
+            if (const LoadFunctions* found = snapshot._hashTable.find(typeName, length)) {
+                functions = *found;
+            }
+            return functions;
+        });
     }
 
 public:
     struct Inserter
     {
-        Inserter(const std::string& typeName, LoadFunction loadFunction)
+        Inserter(const std::string& typeName,
+                 const char* typeAlias,
+                 const std::type_index& typeId,
+                 LoadFunction loadFunction,
+                 SharedLoadFunction sharedLoadFunction,
+                 InPlaceLoadFunction inPlaceLoadFunction)
         {
-            getLoadFunctionMap().insert({typeName, loadFunction});
+            insert(typeName,
+                   typeAlias,
+                   typeId,
+                   loadFunction,
+                   sharedLoadFunction,
+                   inPlaceLoadFunction);
         }
     };
 };
@@ -106,16 +292,69 @@ public:
 
     static boost::optional<SaveFunction> getSaveFunction(const std::type_index& typeId)
     {
-        return getFunction(typeId, getSaveFunctionMap());
+        return getSaveFunctionTable().read([&](const TypeIdToSaveFunctionMap& saveFunctions) {
+            return getFunction(typeId, saveFunctions);
+        });
+    }
+
+    // same as above, but repeated lookups of the same type_info are answered from a small
+    // direct-mapped cache keyed on its address, which avoids hashing the type name
+    static boost::optional<SaveFunction> getSaveFunction(const std::type_info& typeInfo)
+    {
+        CacheEntry& entry = getSaveFunctionCache()[getCacheSlot(typeInfo)];
+        if (entry._typeInfo == &typeInfo) {
+            return entry._saveFunction;
+        }
+        // a type may have several type_info objects across shared libraries, the map compares
+        // type names and thus finds all of them
+        boost::optional<SaveFunction> function = getSaveFunction(std::type_index(typeInfo));
+        if (function) {
+            entry = CacheEntry{&typeInfo, *function};
+        }
+        return function;
+    }
+
+    // registers a type, also safe at runtime while other threads save, e.g. from a plugin
+    // the first lookup afterwards publishes the registrations, see TypeLoadRegistry::freeze()
+    static void insert(const std::type_index& typeId, SaveFunction saveFunction)
+    {
+        getSaveFunctionTable().modify([&](TypeIdToSaveFunctionMap& saveFunctions) {
+            saveFunctions.insert({typeId, saveFunction});
+        });
     }
 
 private:
     using TypeIdToSaveFunctionMap = std::unordered_map<std::type_index, SaveFunction>;
+    // lookups read an immutable copy of the map, see PublishedSnapshot
+    using SaveFunctionTable =
+            detail::PublishedSnapshot<TypeIdToSaveFunctionMap, TypeIdToSaveFunctionMap>;
+
+    // registrations never replace a save function, so cached entries never become stale
+    struct CacheEntry
+    {
+        const std::type_info* _typeInfo;
+        SaveFunction _saveFunction;
+    };
+
+    static constexpr std::size_t cacheSize = 16;
+    using SaveFunctionCache = std::array<CacheEntry, cacheSize>;
+
+    static SaveFunctionCache& getSaveFunctionCache()
+    {
+        static thread_local SaveFunctionCache saveFunctionCache{};
+        return saveFunctionCache;
+    }
 
-    static TypeIdToSaveFunctionMap& getSaveFunctionMap()
+    static std::size_t getCacheSlot(const std::type_info& typeInfo)
     {
-        static TypeIdToSaveFunctionMap saveFunctionMap;
-        return saveFunctionMap;
+        // type_info objects span at least 16 bytes, so the lowest address bits barely vary
+        return (reinterpret_cast<std::uintptr_t>(&typeInfo) >> 4) & (cacheSize - 1);
+    }
+
+    static SaveFunctionTable& getSaveFunctionTable()
+    {
+        static SaveFunctionTable saveFunctionTable;
+        return saveFunctionTable;
     }
 
 public:
@@ -123,7 +362,7 @@ public:
     {
         Inserter(const std::type_index& typeId, SaveFunction saveFunction)
         {
-            getSaveFunctionMap().insert({typeId, saveFunction});
+            insert(typeId, saveFunction);
         }
     };
 };
@@ -153,10 +392,20 @@ template <typename T, typename Base, typename InputArchive>
 const typename ::muesli::TypeLoadRegistry<Base, InputArchive>::Inserter
 RegisteredPolymorphicTypeLoadInstance<T, Base, InputArchive>::instance(
         muesli::RegisteredType<T>::name(),
+        detail::RegisteredTypeAlias<T>::alias(),
+        typeid(T),
         [](InputArchive& archive) -> std::unique_ptr<Base> {
             auto value = std::make_unique<T>();
             archive(SkipIntroOutroWrapper<T>(value.get()));
             return value;
+        },
+        [](InputArchive& archive) -> std::shared_ptr<Base> {
+            auto value = detail::makeShared<T>();
+            archive(SkipIntroOutroWrapper<T>(value.get()));
+            return value;
+        },
+        [](InputArchive& archive, Base* ptr) {
+            archive(SkipIntroOutroWrapper<T>(static_cast<T*>(ptr)));
         });
 
 template <typename T, typename Base, typename OutputArchive>
@@ -205,27 +454,31 @@ template <typename T,
           typename ArchiveTypeVector,
           template <typename> class CombineOperation>
 using GetPolymorphicInstancesTypeVector =
-        typename FlatCartesianTypeProduct<BasesTypeVector,
-                                          ArchiveTypeVector,
-                                          CombineOperation<T>>::type;
+        FlatCartesianTypeProduct<BasesTypeVector, ArchiveTypeVector, CombineOperation<T>>;
+
+// archives selected via MUESLI_SELECT_POLYMORPHIC_ARCHIVES, or all archives if void
+template <typename SelectedArchives, typename AllArchives>
+using SelectPolymorphicArchives =
+        std::conditional_t<std::is_void<SelectedArchives>::value, AllArchives, SelectedArchives>;
 
-template <typename T, typename BasesTypeVector>
+template <typename T,
+          typename BasesTypeVector,
+          typename InputArchives = InputArchiveTypeVector,
+          typename OutputArchives = OutputArchiveTypeVector>
 struct GetFullPolymorphicInstancesTypeList
 {
     using BaseByInputArchiveCartesianProduct =
             GetPolymorphicInstancesTypeVector<T,
                                               BasesTypeVector,
-                                              InputArchiveTypeVector,
+                                              InputArchives,
                                               CombineBaseAndInputArchiveForT>;
     using BaseByOutputArchiveCartesianProduct =
             GetPolymorphicInstancesTypeVector<T,
                                               BasesTypeVector,
-                                              OutputArchiveTypeVector,
+                                              OutputArchives,
                                               CombineBaseAndOutputArchiveForT>;
-    using BaseByInputOutputCartesianProduct =
-            typename boost::mpl::joint_view<BaseByInputArchiveCartesianProduct,
-                                            BaseByOutputArchiveCartesianProduct>::type;
-    using type = typename MplSequenceToTypeList<BaseByInputOutputCartesianProduct>::type;
+    using type = typename Concat<BaseByInputArchiveCartesianProduct,
+                                 BaseByOutputArchiveCartesianProduct>::type;
 };
 
 } // namespace detail
@@ -244,8 +497,35 @@ struct GetFullPolymorphicInstancesTypeList
     };                                                                                             \
     } /* namespace muesli */
 
+// registers T under a short alias in addition to its name, e.g. "TSE" or "7"
+// output archives write the alias instead of the name if they are told to, input archives
+// resolve both
+#define MUESLI_REGISTER_TYPE_WITH_ALIAS(T, Name, Alias)                                            \
+    namespace muesli                                                                               \
+    {                                                                                              \
+    template <>                                                                                    \
+    struct RegisteredType<T>                                                                       \
+    {                                                                                              \
+        static constexpr char const* name()                                                        \
+        {                                                                                          \
+            return Name;                                                                           \
+        }                                                                                          \
+        static constexpr char const* alias()                                                       \
+        {                                                                                          \
+            return Alias;                                                                          \
+        }                                                                                          \
+    };                                                                                             \
+    } /* namespace muesli */
+
 #define MUESLI_REGISTER_POLYMORPHIC_TYPE(T, Base, Name)                                            \
     MUESLI_REGISTER_TYPE(T, Name) /* register T as a "normal" type as well */                      \
+    MUESLI_DETAIL_REGISTER_POLYMORPHIC_TYPE(T, Base)
+
+#define MUESLI_REGISTER_POLYMORPHIC_TYPE_WITH_ALIAS(T, Base, Name, Alias)                          \
+    MUESLI_REGISTER_TYPE_WITH_ALIAS(T, Name, Alias)                                                \
+    MUESLI_DETAIL_REGISTER_POLYMORPHIC_TYPE(T, Base)
+
+#define MUESLI_DETAIL_REGISTER_POLYMORPHIC_TYPE(T, Base)                                           \
     namespace muesli                                                                               \
     {                                                                                              \
     namespace detail                                                                               \
@@ -262,6 +542,11 @@ struct GetFullPolymorphicInstancesTypeList
         static_assert(std::is_base_of<Base, T>::value, "Base must be a base class of T");          \
                                                                                                    \
         using BaseHierarchyTypeList = typename GetRegisteredBaseHierarchy<T>::type;                \
+        using ArchiveSelection = PolymorphicArchiveSelection<tags::PolymorphicArchives>;           \
+        using InputArchives = SelectPolymorphicArchives<ArchiveSelection::InputArchives,           \
+                                                        InputArchiveTypeVector>;                   \
+        using OutputArchives = SelectPolymorphicArchives<ArchiveSelection::OutputArchives,         \
+                                                         OutputArchiveTypeVector>;                 \
                                                                                                    \
         template <typename... Instances>                                                           \
         static auto dummyImpl(TypeList<Instances...>)                                              \
@@ -273,9 +558,8 @@ struct GetFullPolymorphicInstancesTypeList
         static auto dummy()                                                                        \
         {                                                                                          \
             assert(false); /* NOLINT */                                                            \
-            using BasesVector = typename TypeListToMplVector<BaseHierarchyTypeList>::type;         \
-            using InstanceTypeList =                                                               \
-                    typename GetFullPolymorphicInstancesTypeList<T, BasesVector>::type;            \
+            using InstanceTypeList = typename GetFullPolymorphicInstancesTypeList<                 \
+                    T, BaseHierarchyTypeList, InputArchives, OutputArchives>::type;                \
             return dummyImpl(InstanceTypeList{});                                                  \
         }                                                                                          \
     };                                                                                             \
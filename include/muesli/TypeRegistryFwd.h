@@ -20,6 +20,10 @@
 #ifndef MUESLI_TYPEREGISTRYFWD_H_
 #define MUESLI_TYPEREGISTRYFWD_H_
 
+#include <string>
+
+#include "muesli/detail/VoidT.h"
+
 namespace muesli
 {
 
@@ -32,6 +36,36 @@ class TypeSaveRegistry;
 template <typename Base, typename InputArchive>
 class TypeLoadRegistry;
 
+namespace detail
+{
+// the alias T was registered with via MUESLI_REGISTER_TYPE_WITH_ALIAS, nullptr otherwise
+template <typename T, typename Enable = void>
+struct RegisteredTypeAlias
+{
+    static constexpr char const* alias()
+    {
+        return nullptr;
+    }
+};
+
+template <typename T>
+struct RegisteredTypeAlias<T, VoidT<decltype(RegisteredType<T>::alias())>>
+{
+    static constexpr char const* alias()
+    {
+        return RegisteredType<T>::alias();
+    }
+};
+
+// true if 'typeName' is the registered name or alias of T
+template <typename T>
+bool isRegisteredAs(const std::string& typeName)
+{
+    const char* alias = RegisteredTypeAlias<T>::alias();
+    return typeName == RegisteredType<T>::name() || (alias != nullptr && typeName == alias);
+}
+} // namespace detail
+
 } // namespace muesli
 
 #endif // MUESLI_TYPEREGISTRYFWD_H_
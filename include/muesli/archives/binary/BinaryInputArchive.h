@@ -0,0 +1,880 @@
+/*
+ * #%L
+ * %%
+ * Copyright (C) 2011 - 2016 BMW Car IT GmbH
+ * %%
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ * 
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ * 
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ * #L%
+ */
+
+#ifndef MUESLI_ARCHIVES_BINARY_BINARYINPUTARCHIVE_H_
+#define MUESLI_ARCHIVES_BINARY_BINARYINPUTARCHIVE_H_
+
+#include <algorithm>
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <limits>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include <boost/optional.hpp>
+#include <boost/type_index.hpp>
+
+#include "muesli/ArchiveRegistry.h"
+#include "muesli/BaseArchive.h"
+#include "muesli/EventRegistry.h"
+#include "muesli/FieldMask.h"
+#include "muesli/NameValuePair.h"
+#include "muesli/NameValuePairWithDefault.h"
+#include "muesli/SkipIntroOutroWrapper.h"
+#include "muesli/Traits.h"
+#include "muesli/TypeRegistryFwd.h"
+#include "muesli/detail/Expansion.h"
+#include "muesli/detail/MakePointer.h"
+#include "muesli/detail/MapKeyConversion.h"
+#include "muesli/detail/ScopedAssignment.h"
+#include "muesli/exceptions/ParseException.h"
+#include "muesli/exceptions/UnknownTypeException.h"
+#include "muesli/exceptions/ValueNotFoundException.h"
+
+#include "muesli/archives/binary/Tag.h"
+#include "muesli/archives/binary/detail/BinaryReader.h"
+#include "muesli/archives/binary/detail/Encoding.h"
+#include "muesli/archives/binary/detail/traits.h"
+#include "muesli/archives/json/detail/traits.h"
+
+namespace muesli
+{
+
+// reads the encoding written by BinaryOutputArchive
+// the input is consumed in a single pass; fields which are read in the order in which they were
+// written are decoded directly, the values of keys which come before a requested one are
+// buffered until they are requested or their object ends, unknown fields are thereby skipped
+template <typename InputStream>
+class BinaryInputArchive
+        : public muesli::BaseArchive<muesli::tags::InputArchive, BinaryInputArchive<InputStream>>
+{
+    using Parent = muesli::BaseArchive<muesli::tags::InputArchive, BinaryInputArchive<InputStream>>;
+    using Marker = binary::detail::Marker;
+
+public:
+    explicit BinaryInputArchive(InputStream& stream) : BinaryInputArchive(stream, FieldMask())
+    {
+    }
+
+    // only loads the NameValuePairs selected by 'fieldMask', the others are skipped undecoded
+    BinaryInputArchive(InputStream& stream, FieldMask fieldMask)
+            : Parent(this),
+              _reader(stream),
+              _frames(),
+              _nextValueAbsent(false),
+              _packedBuffer(),
+              _fieldMask(std::move(fieldMask)),
+              _currentField(_fieldMask.getRoot())
+    {
+    }
+
+    // unless the field mask excludes the field 'name', calls 'loadField' with 'name' as current
+    // field and returns true; the previous field is restored afterwards, also if 'loadField' throws
+    template <typename LoadField>
+    bool loadField(const char* name, LoadField&& loadField)
+    {
+        std::size_t field = _currentField;
+        if (!_fieldMask.selectField(field, name)) {
+            return false;
+        }
+        const muesli::detail::ScopedAssignment<std::size_t> currentField(_currentField, field);
+        loadField();
+        return true;
+    }
+
+    // skips the value of 'key' if it is buffered or the next key of the current object
+    void skipField(const char* key)
+    {
+        Frame& frame = currentObject();
+        auto pending = findPendingValue(frame, key);
+        if (pending != frame._pendingValues.end()) {
+            frame._pendingValues.erase(pending);
+        } else if ((frame._hasKey || readKey(frame)) && frame._key == key) {
+            _reader.skipValue();
+            frame._hasKey = false;
+        }
+    }
+
+    // positions the archive at the value of 'key' within the current object
+    // the values of other keys which come first are buffered; a nullable field whose key is
+    // found neither in the buffer nor up to the end of the object is treated as absent
+    void setNextKey(const char* key, bool nullable)
+    {
+        Frame& frame = currentObject();
+        auto pending = findPendingValue(frame, key);
+        if (pending != frame._pendingValues.end()) {
+            _reader.replay(std::move(pending->second));
+            frame._pendingValues.erase(pending);
+            return;
+        }
+        while (true) {
+            if (!frame._hasKey && !readKey(frame)) {
+                if (nullable) {
+                    _nextValueAbsent = true;
+                    return;
+                }
+                throw exceptions::ValueNotFoundException("Could not find value for key \"" +
+                                                         std::string(key) + "\".");
+            }
+            frame._hasKey = false;
+            if (frame._key == key) {
+                return;
+            }
+            frame._pendingValues.emplace_back(std::move(frame._key), std::string());
+            _reader.captureValue(frame._pendingValues.back().second);
+        }
+    }
+
+    // true if 'key' is the next key of the current object, nothing is consumed
+    bool nextKeyIs(const char* key)
+    {
+        Frame& frame = currentObject();
+        return (frame._hasKey || readKey(frame)) && frame._key == key;
+    }
+
+    // true if the last setNextKey() found no value, the absence is consumed
+    bool consumeAbsentValue()
+    {
+        const bool absent = _nextValueAbsent;
+        _nextValueAbsent = false;
+        return absent;
+    }
+
+    // reads the next key of the current object, returns false at the end of the object
+    bool readNextKey(std::string& key)
+    {
+        Frame& frame = currentObject();
+        if (!frame._hasKey && !readKey(frame)) {
+            return false;
+        }
+        frame._hasKey = false;
+        key = frame._key;
+        return true;
+    }
+
+    void skipValue()
+    {
+        _reader.skipValue();
+    }
+
+    void readValue(bool& boolValue)
+    {
+        const Marker marker = _reader.readMarker();
+        if (marker == Marker::True || marker == Marker::False) {
+            boolValue = marker == Marker::True;
+        } else {
+            throw std::invalid_argument("Cannot read a Bool.");
+        }
+    }
+
+    void readValue(std::vector<bool>::reference& boolValue)
+    {
+        bool value;
+        readValue(value);
+        boolValue = value;
+    }
+
+    template <typename T>
+    std::enable_if_t<std::is_arithmetic<T>::value> readValue(T& value)
+    {
+        const Marker marker = _reader.readMarker();
+        if (marker != Marker::Null) {
+            readArithmeticValue(value, marker);
+        } else {
+            value = std::numeric_limits<T>::signaling_NaN();
+        }
+    }
+
+    void readArithmeticValue(double& doubleValue, Marker marker)
+    {
+        if (marker == Marker::Double) {
+            doubleValue = _reader.readDouble();
+        } else if (marker == Marker::Float) {
+            doubleValue = _reader.readFloat();
+        } else if (marker == Marker::UnsignedInteger) {
+            doubleValue = static_cast<double>(_reader.readVarint());
+        } else if (marker == Marker::SignedInteger) {
+            doubleValue = static_cast<double>(binary::detail::zigzagDecode(_reader.readVarint()));
+        } else {
+            throw std::invalid_argument("Cannot read a Double.");
+        }
+    }
+
+    void readArithmeticValue(float& floatValue, Marker marker)
+    {
+        double doubleValue;
+        readArithmeticValue(doubleValue, marker);
+        floatValue = static_cast<float>(doubleValue);
+    }
+
+    template <typename T>
+    std::enable_if_t<json::detail::IsSignedIntegerUpTo32bit<T>::value> readArithmeticValue(
+            T& intValue,
+            Marker marker)
+    {
+        intValue = readInteger<T>(marker, "Cannot read an Int.");
+    }
+
+    template <typename T>
+    std::enable_if_t<json::detail::IsUnsignedIntegerUpTo32bit<T>::value> readArithmeticValue(
+            T& intValue,
+            Marker marker)
+    {
+        intValue = readInteger<T>(marker, "Cannot read an Uint.");
+    }
+
+    void readArithmeticValue(std::int64_t& int64Value, Marker marker)
+    {
+        int64Value = readInteger<std::int64_t>(marker, "Cannot read an Int64.");
+    }
+
+    void readArithmeticValue(std::uint64_t& uint64Value, Marker marker)
+    {
+        uint64Value = readInteger<std::uint64_t>(marker, "Cannot read an UInt64.");
+    }
+
+    template <typename Traits, typename Allocator>
+    void readValue(std::basic_string<char, Traits, Allocator>& stringValue)
+    {
+        if (_reader.readMarker() == Marker::String) {
+            _reader.readString(stringValue);
+        } else {
+            throw std::invalid_argument("Cannot read a String.");
+        }
+    }
+
+    // decodes all elements of a PackedArray value at once
+    template <typename T>
+    void readPackedArray(std::vector<T>& array)
+    {
+        _reader.readMarker();
+        std::size_t count = 0;
+        const Marker elementMarker = _reader.readPackedArray(count, _packedBuffer);
+        if (count > _packedBuffer.size()) {
+            throw exceptions::ParseException("could not parse binary: invalid packed array");
+        }
+        array.resize(count);
+        const unsigned char* begin = reinterpret_cast<const unsigned char*>(_packedBuffer.data());
+        const unsigned char* end = begin + _packedBuffer.size();
+        if (decodePacked(array.data(), count, elementMarker, begin, end) != end) {
+            throw exceptions::ParseException("could not parse binary: invalid packed array");
+        }
+    }
+
+    void pushObject()
+    {
+        pushContainer(Marker::ObjectStart, FrameKind::Object, "object");
+    }
+
+    void pushArray()
+    {
+        pushContainer(Marker::ArrayStart, FrameKind::Array, "array");
+    }
+
+    // accepts a PackedArray as well as an array written element by element
+    void pushPackableArray()
+    {
+        if (_reader.peekMarker() == Marker::PackedArray) {
+            _frames.emplace_back(FrameKind::PackedArray);
+        } else {
+            pushArray();
+        }
+    }
+
+    void pushNullableNode()
+    {
+        if (_nextValueAbsent) {
+            _nextValueAbsent = false;
+            _frames.emplace_back(FrameKind::Null);
+            return;
+        }
+        const Marker marker = _reader.peekMarker();
+        FrameKind kind = FrameKind::Value;
+        if (marker == Marker::Null) {
+            kind = FrameKind::Null;
+        } else if (marker == Marker::ObjectStart) {
+            kind = FrameKind::Object;
+        } else if (marker == Marker::ArrayStart) {
+            kind = FrameKind::Array;
+        } else if (marker == Marker::PackedArray) {
+            kind = FrameKind::PackedArray;
+        }
+        if (kind == FrameKind::Null || kind == FrameKind::Object || kind == FrameKind::Array) {
+            _reader.readMarker();
+        }
+        _frames.emplace_back(kind);
+    }
+
+    void popNode()
+    {
+        assert(!_frames.empty());
+        const Frame& frame = _frames.back();
+        if (frame._kind == FrameKind::Object || frame._kind == FrameKind::Array) {
+            // skip whatever has not been read from the container
+            if (frame._hasKey) {
+                _reader.skipValue();
+            }
+            while (!currentValueIsAtEnd()) {
+                _reader.skipValue();
+            }
+            const Marker expectedEnd =
+                    frame._kind == FrameKind::Object ? Marker::ObjectEnd : Marker::ArrayEnd;
+            if (_reader.readMarker() != expectedEnd) {
+                throw exceptions::ParseException("could not parse binary: mismatching container end");
+            }
+        }
+        _frames.pop_back();
+    }
+
+    bool currentValueIsNull() const
+    {
+        return !_frames.empty() && _frames.back()._kind == FrameKind::Null;
+    }
+
+    bool currentValueIsPackedArray() const
+    {
+        return !_frames.empty() && _frames.back()._kind == FrameKind::PackedArray;
+    }
+
+    // true if all elements of the current array or object have been read
+    bool currentValueIsAtEnd() const
+    {
+        const Marker marker = _reader.peekMarker();
+        return marker == Marker::ArrayEnd || marker == Marker::ObjectEnd;
+    }
+
+private:
+    enum class FrameKind { Object, Array, PackedArray, Null, Value };
+
+    // keys with the encoded values which have been read past while looking for another key
+    using PendingValues = std::vector<std::pair<std::string, std::string>>;
+
+    struct Frame
+    {
+        explicit Frame(FrameKind kind) : _kind(kind), _hasKey(false), _key(), _pendingValues()
+        {
+        }
+
+        FrameKind _kind;
+        // key which has been read ahead but not been requested yet
+        bool _hasKey;
+        std::string _key;
+        PendingValues _pendingValues;
+    };
+
+    static PendingValues::iterator findPendingValue(Frame& frame, const char* key)
+    {
+        return std::find_if(frame._pendingValues.begin(),
+                            frame._pendingValues.end(),
+                            [key](const PendingValues::value_type& pendingValue) {
+                                return pendingValue.first == key;
+                            });
+    }
+
+    void pushContainer(Marker startMarker, FrameKind kind, const std::string& name)
+    {
+        const Marker marker = _reader.readMarker();
+        if (marker == startMarker) {
+            _frames.emplace_back(kind);
+        } else if (marker == Marker::Null) {
+            throw exceptions::ValueNotFoundException("Could not find a value for a not nullable " +
+                                                     name + ".");
+        } else {
+            throw std::invalid_argument("Cannot read an " + name + ".");
+        }
+    }
+
+    Frame& currentObject()
+    {
+        if (_frames.empty() || _frames.back()._kind != FrameKind::Object) {
+            throw std::invalid_argument("Cannot read a key outside of an object.");
+        }
+        return _frames.back();
+    }
+
+    bool readKey(Frame& frame)
+    {
+        if (_reader.peekMarker() == Marker::ObjectEnd) {
+            return false;
+        }
+        if (_reader.readMarker() != Marker::String) {
+            throw exceptions::ParseException("could not parse binary: expected a key");
+        }
+        _reader.readString(frame._key);
+        frame._hasKey = true;
+        return true;
+    }
+
+    template <typename T>
+    T readInteger(Marker marker, const char* error)
+    {
+        if (marker != Marker::UnsignedInteger && marker != Marker::SignedInteger) {
+            throw std::invalid_argument(error);
+        }
+        return convertInteger<T>(_reader.readVarint(), marker, error);
+    }
+
+    template <typename T>
+    static T convertInteger(std::uint64_t raw, Marker marker, const char* error)
+    {
+        if (marker == Marker::UnsignedInteger) {
+            if (raw > static_cast<std::uint64_t>(std::numeric_limits<T>::max())) {
+                throw std::invalid_argument(error);
+            }
+            return static_cast<T>(raw);
+        }
+        const std::int64_t value = binary::detail::zigzagDecode(raw);
+        if (value < 0) {
+            if (!std::is_signed<T>::value ||
+                value < static_cast<std::int64_t>(std::numeric_limits<T>::min())) {
+                throw std::invalid_argument(error);
+            }
+        } else if (static_cast<std::uint64_t>(value) >
+                   static_cast<std::uint64_t>(std::numeric_limits<T>::max())) {
+            throw std::invalid_argument(error);
+        }
+        return static_cast<T>(value);
+    }
+
+    template <typename T>
+    static std::enable_if_t<std::is_integral<T>::value, const unsigned char*> decodePacked(
+            T* values,
+            std::size_t count,
+            Marker elementMarker,
+            const unsigned char* begin,
+            const unsigned char* end)
+    {
+        if (elementMarker != Marker::UnsignedInteger && elementMarker != Marker::SignedInteger) {
+            throw std::invalid_argument("Cannot read an array of integers.");
+        }
+        return binary::detail::decodeVarints(
+                begin, end, values, count, [elementMarker](std::uint64_t raw) {
+                    return convertInteger<T>(raw, elementMarker, "Cannot read an array of integers.");
+                });
+    }
+
+    template <typename T>
+    static std::enable_if_t<std::is_floating_point<T>::value, const unsigned char*> decodePacked(
+            T* values,
+            std::size_t count,
+            Marker elementMarker,
+            const unsigned char* begin,
+            const unsigned char* end)
+    {
+        if (elementMarker == Marker::Double) {
+            return decodeFixed(values, count, begin, end, sizeof(double), [](std::uint64_t bits) {
+                return binary::detail::bitsToDouble(bits);
+            });
+        } else if (elementMarker == Marker::Float) {
+            return decodeFixed(values, count, begin, end, sizeof(float), [](std::uint64_t bits) {
+                return binary::detail::bitsToFloat(static_cast<std::uint32_t>(bits));
+            });
+        } else if (elementMarker == Marker::UnsignedInteger) {
+            return binary::detail::decodeVarints(begin, end, values, count, [](std::uint64_t raw) {
+                return static_cast<T>(raw);
+            });
+        } else if (elementMarker == Marker::SignedInteger) {
+            return binary::detail::decodeVarints(begin, end, values, count, [](std::uint64_t raw) {
+                return static_cast<T>(binary::detail::zigzagDecode(raw));
+            });
+        }
+        throw std::invalid_argument("Cannot read an array of floating point numbers.");
+    }
+
+    template <typename T, typename FromBits>
+    static const unsigned char* decodeFixed(T* values,
+                                            std::size_t count,
+                                            const unsigned char* begin,
+                                            const unsigned char* end,
+                                            std::size_t width,
+                                            FromBits fromBits)
+    {
+        if (static_cast<std::size_t>(end - begin) != count * width) {
+            throw exceptions::ParseException("could not parse binary: invalid packed array");
+        }
+        for (std::size_t i = 0; i < count; ++i) {
+            values[i] = static_cast<T>(fromBits(binary::detail::decodeFixed(begin, width)));
+            begin += width;
+        }
+        return begin;
+    }
+
+    binary::detail::BinaryReader<InputStream> _reader;
+    std::vector<Frame> _frames;
+    bool _nextValueAbsent;
+    std::string _packedBuffer;
+    FieldMask _fieldMask;
+    std::size_t _currentField;
+};
+
+namespace detail
+{
+template <std::size_t Index, typename InputStream, typename TupleType>
+void loadTupleElement(BinaryInputArchive<InputStream>& archive, TupleType& tuple)
+{
+    if (archive.currentValueIsAtEnd()) {
+        throw exceptions::ParseException("Failed to load tuple. Persisted tuple size is " +
+                                         std::to_string(Index) + ". Expected tuple size is " +
+                                         std::to_string(std::tuple_size<TupleType>::value));
+    }
+    archive(std::get<Index>(tuple));
+}
+
+template <typename InputStream, typename TupleType, std::size_t... Indicies>
+void loadTuple(BinaryInputArchive<InputStream>& archive,
+               TupleType& tuple,
+               std::index_sequence<Indicies...>)
+{
+    detail::Expansion{0, (loadTupleElement<Indicies>(archive, tuple), 0)...};
+}
+} // namespace detail
+
+template <typename InputStream, typename T>
+void intro(BinaryInputArchive<InputStream>& archive, const NameValuePair<T>& nameValuePair)
+{
+    std::ignore = archive;
+    std::ignore = nameValuePair;
+}
+
+template <typename InputStream, typename T>
+void outro(BinaryInputArchive<InputStream>& archive, const NameValuePair<T>& nameValuePair)
+{
+    std::ignore = archive;
+    std::ignore = nameValuePair;
+}
+
+template <typename InputStream, typename... Ts>
+void intro(BinaryInputArchive<InputStream>& archive, const std::tuple<Ts...>& tuple)
+{
+    std::ignore = tuple;
+    archive.pushArray();
+}
+
+template <typename InputStream, typename... Ts>
+void outro(BinaryInputArchive<InputStream>& archive, const std::tuple<Ts...>& tuple)
+{
+    std::ignore = tuple;
+    archive.popNode();
+}
+
+template <typename InputStream, typename T>
+std::enable_if_t<json::detail::IsObject<T>::value> intro(BinaryInputArchive<InputStream>& archive,
+                                                         const T& value)
+{
+    std::ignore = value;
+    archive.pushObject();
+}
+
+template <typename InputStream, typename T>
+std::enable_if_t<binary::detail::IsUnpackedArray<T>::value> intro(
+        BinaryInputArchive<InputStream>& archive,
+        const T& value)
+{
+    std::ignore = value;
+    archive.pushArray();
+}
+
+template <typename InputStream, typename T>
+std::enable_if_t<binary::detail::IsPackedArray<T>::value> intro(
+        BinaryInputArchive<InputStream>& archive,
+        const T& value)
+{
+    std::ignore = value;
+    archive.pushPackableArray();
+}
+
+template <typename InputStream, typename T>
+std::enable_if_t<json::detail::IsNullable<T>::value> intro(BinaryInputArchive<InputStream>& archive,
+                                                           const T& value)
+{
+    std::ignore = value;
+    archive.pushNullableNode();
+}
+
+template <typename InputStream, typename T>
+std::enable_if_t<json::detail::IsObject<T>::value || json::detail::IsArray<T>::value ||
+                 json::detail::IsNullable<T>::value>
+outro(BinaryInputArchive<InputStream>& archive, const T& value)
+{
+    std::ignore = value;
+    archive.popNode();
+}
+
+template <typename InputStream, typename T>
+std::enable_if_t<json::detail::IsPrimitive<T>::value> intro(
+        BinaryInputArchive<InputStream>& archive,
+        const T& value)
+{
+    std::ignore = archive;
+    std::ignore = value;
+}
+
+template <typename InputStream, typename T>
+std::enable_if_t<json::detail::IsPrimitive<T>::value> outro(
+        BinaryInputArchive<InputStream>& archive,
+        const T& value)
+{
+    std::ignore = archive;
+    std::ignore = value;
+}
+
+template <typename InputStream, typename T>
+std::enable_if_t<binary::detail::IsUnpackedArray<T>::value> load(
+        BinaryInputArchive<InputStream>& archive,
+        T& array)
+{
+    using ValueType = typename T::value_type;
+    array.clear();
+    auto inserter = std::inserter(array, array.begin());
+    while (!archive.currentValueIsAtEnd()) {
+        ValueType entry;
+        archive(entry);
+        inserter = std::move(entry);
+    }
+}
+
+template <typename InputStream, typename T>
+std::enable_if_t<binary::detail::IsPackedArray<T>::value> load(
+        BinaryInputArchive<InputStream>& archive,
+        T& array)
+{
+    using ValueType = typename T::value_type;
+    if (archive.currentValueIsPackedArray()) {
+        archive.readPackedArray(array);
+        return;
+    }
+    // the array has been written element by element, e.g. by a transcoder
+    array.clear();
+    while (!archive.currentValueIsAtEnd()) {
+        ValueType entry;
+        archive(entry);
+        array.push_back(entry);
+    }
+}
+
+template <typename InputStream, typename Map>
+std::enable_if_t<json::detail::IsMap<Map>::value> load(BinaryInputArchive<InputStream>& archive,
+                                                       Map& map)
+{
+    using T = typename Map::key_type;
+    using V = typename Map::mapped_type;
+    map.clear();
+    std::string keyString;
+    while (archive.readNextKey(keyString)) {
+        if (keyString == "_typeName") {
+            archive.skipValue();
+            continue;
+        }
+
+        T key;
+        detail::stringToType(keyString, key);
+
+        V value;
+        archive(value);
+        map.insert({std::move(key), std::move(value)});
+    }
+}
+
+template <typename InputStream, typename T>
+void load(BinaryInputArchive<InputStream>& archive, NameValuePair<T>& nameValuePair)
+{
+    const bool loaded = archive.loadField(nameValuePair._name, [&archive, &nameValuePair]() {
+        archive.setNextKey(nameValuePair._name, json::detail::IsNullable<std::decay_t<T>>::value);
+        archive(nameValuePair._value);
+    });
+    if (!loaded) {
+        archive.skipField(nameValuePair._name);
+    }
+}
+
+// like a nullable field, a field with a default is absent if its key is not found in its object
+template <typename InputStream, typename T, typename Default>
+void load(BinaryInputArchive<InputStream>& archive,
+          NameValuePairWithDefault<T, Default>& nameValuePair)
+{
+    const bool loaded = archive.loadField(nameValuePair._name, [&archive, &nameValuePair]() {
+        archive.setNextKey(nameValuePair._name, true);
+        if (archive.consumeAbsentValue()) {
+            nameValuePair._value = nameValuePair._default;
+        } else {
+            archive(nameValuePair._value);
+        }
+    });
+    if (!loaded) {
+        archive.skipField(nameValuePair._name);
+    }
+}
+
+template <typename InputStream, typename... Ts>
+void load(BinaryInputArchive<InputStream>& archive, std::tuple<Ts...>& tuple)
+{
+    detail::loadTuple(archive, tuple, std::index_sequence_for<Ts...>{});
+    if (!archive.currentValueIsAtEnd()) {
+        throw exceptions::ParseException("Failed to load tuple. Persisted tuple is longer than "
+                                         "the expected tuple size " +
+                                         std::to_string(sizeof...(Ts)));
+    }
+}
+
+template <typename InputStream, typename T>
+std::enable_if_t<json::detail::IsPrimitive<T>::value && !std::is_enum<T>::value> load(
+        BinaryInputArchive<InputStream>& archive,
+        T& value)
+{
+    archive.readValue(value);
+}
+
+// generic de-serialization for enum types having a wrapper class
+template <typename InputStream,
+          typename Enum,
+          typename Wrapper = typename EnumTraits<Enum>::Wrapper>
+void load(BinaryInputArchive<InputStream>& archive, Enum& value)
+{
+    std::string enumStringValue;
+    archive.readValue(enumStringValue);
+    value = Wrapper::getEnum(enumStringValue);
+}
+
+namespace detail
+{
+
+template <typename T, typename InputStream, typename Pointer>
+void loadPointerDirectly(BinaryInputArchive<InputStream>& archive, Pointer& ptr)
+{
+    auto loaded = makePointer<T>(ptr);
+    archive(SkipIntroOutroWrapper<T>(loaded.get()));
+    ptr = std::move(loaded);
+}
+
+template <typename Base, typename InputStream, typename Pointer>
+void loadPolymorphicPointerThroughRegistry(BinaryInputArchive<InputStream>& archive,
+                                           const std::string& typeName,
+                                           Pointer& ptr)
+{
+    using DecayedBase = std::decay_t<Base>;
+    // lookup in type registry
+    using TypeRegistry = muesli::TypeLoadRegistry<DecayedBase, BinaryInputArchive<InputStream>>;
+    auto loadFunction = getRegisteredLoadFunction<TypeRegistry>(typeName, ptr);
+    if (loadFunction) {
+        ptr = (*loadFunction)(archive);
+    } else {
+        throw exceptions::UnknownTypeException(
+                std::string("could not find input serializer for " +
+                            boost::typeindex::type_id<DecayedBase>().pretty_name()));
+    }
+}
+
+// generic de-serialization for non-polymorphic pointer types
+template <typename T, typename InputStream, typename Pointer>
+std::enable_if_t<!std::is_polymorphic<T>::value> loadPointer(
+        BinaryInputArchive<InputStream>& archive,
+        Pointer& ptr)
+{
+    if (archive.currentValueIsNull()) {
+        ptr = nullptr;
+    } else {
+        loadPointerDirectly<T>(archive, ptr);
+    }
+}
+
+// BinaryOutputArchive writes _typeName as the first key of an object; an object of a
+// non-abstract static type may have been written without it, see
+// BinaryOutputArchive::setWritePolymorphicTypeNamesOnly()
+template <typename Base, typename InputStream>
+std::string getTypeNameForPointer(BinaryInputArchive<InputStream>& archive)
+{
+    if (!std::is_abstract<Base>::value && !archive.nextKeyIs("_typeName")) {
+        return RegisteredType<std::decay_t<Base>>::name();
+    }
+    archive.setNextKey("_typeName", false);
+    std::string typeName;
+    archive.readValue(typeName);
+    return typeName;
+}
+
+// generic de-serialization for polymorphic, non-abstract pointer types
+template <typename Base, typename InputStream, typename Pointer>
+std::enable_if_t<std::is_polymorphic<Base>::value && !std::is_abstract<Base>::value> loadPointer(
+        BinaryInputArchive<InputStream>& archive,
+        Pointer& ptr)
+{
+    if (archive.currentValueIsNull()) {
+        ptr = nullptr;
+        return;
+    }
+    std::string typeName = getTypeNameForPointer<Base>(archive);
+    if (isRegisteredAs<std::decay_t<Base>>(typeName)) {
+        loadPointerDirectly<Base>(archive, ptr);
+    } else {
+        loadPolymorphicPointerThroughRegistry<Base>(archive, typeName, ptr);
+    }
+}
+
+// generic de-serialization for polymorphic abstract pointer types
+template <typename Base, typename InputStream, typename Pointer>
+std::enable_if_t<std::is_polymorphic<Base>::value && std::is_abstract<Base>::value> loadPointer(
+        BinaryInputArchive<InputStream>& archive,
+        Pointer& ptr)
+{
+    if (archive.currentValueIsNull()) {
+        ptr = nullptr;
+        return;
+    }
+    loadPolymorphicPointerThroughRegistry<Base>(archive, getTypeNameForPointer<Base>(archive), ptr);
+}
+
+} // namespace detail
+
+template <typename InputStream, typename T>
+void load(BinaryInputArchive<InputStream>& archive, std::shared_ptr<T>& ptr)
+{
+    detail::loadPointer<T>(archive, ptr);
+}
+
+template <typename InputStream, typename T>
+void load(BinaryInputArchive<InputStream>& archive, std::unique_ptr<T>& ptr)
+{
+    detail::loadPointer<T>(archive, ptr);
+}
+
+template <typename InputStream, typename T>
+void load(BinaryInputArchive<InputStream>& archive, boost::optional<T>& opt)
+{
+    if (archive.currentValueIsNull()) {
+        opt = boost::none;
+    } else {
+        T wrapped;
+        archive(SkipIntroOutroWrapper<T>(&wrapped));
+        opt = std::move(wrapped);
+    }
+}
+
+} // namespace muesli
+
+MUESLI_REGISTER_INPUT_ARCHIVE(muesli::BinaryInputArchive, muesli::tags::binary)
+MUESLI_REGISTER_EVENT_READER(muesli::binary::detail::BinaryReader, muesli::tags::binary)
+
+#endif // MUESLI_ARCHIVES_BINARY_BINARYINPUTARCHIVE_H_
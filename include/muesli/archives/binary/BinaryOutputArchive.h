@@ -0,0 +1,504 @@
+/*
+ * #%L
+ * %%
+ * Copyright (C) 2011 - 2016 BMW Car IT GmbH
+ * %%
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ * 
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ * 
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ * #L%
+ */
+
+#ifndef MUESLI_ARCHIVES_BINARY_BINARYOUTPUTARCHIVE_H_
+#define MUESLI_ARCHIVES_BINARY_BINARYOUTPUTARCHIVE_H_
+
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include <boost/optional.hpp>
+#include <boost/type_index.hpp>
+
+#include "muesli/ArchiveRegistry.h"
+#include "muesli/BaseArchive.h"
+#include "muesli/EventRegistry.h"
+#include "muesli/NameValuePair.h"
+#include "muesli/NameValuePairWithDefault.h"
+#include "muesli/Traits.h"
+#include "muesli/TypeRegistryFwd.h"
+#include "muesli/detail/Expansion.h"
+#include "muesli/detail/MapKeyConversion.h"
+#include "muesli/exceptions/UnknownTypeException.h"
+
+#include "muesli/archives/binary/Tag.h"
+#include "muesli/archives/binary/detail/BinaryWriter.h"
+#include "muesli/archives/binary/detail/traits.h"
+#include "muesli/archives/json/detail/traits.h"
+
+namespace muesli
+{
+
+// writes a compact, self-describing binary encoding
+// integers are written as LEB128 varints, signed integers are zigzag encoded beforehand
+template <typename OutputStream>
+class BinaryOutputArchive
+        : public muesli::BaseArchive<muesli::tags::OutputArchive, BinaryOutputArchive<OutputStream>>
+{
+    using Parent =
+            muesli::BaseArchive<muesli::tags::OutputArchive, BinaryOutputArchive<OutputStream>>;
+
+public:
+    explicit BinaryOutputArchive(OutputStream& stream)
+            : Parent(this),
+              _writer(stream),
+              _writeTypeAliases(false),
+              _writePolymorphicTypeNamesOnly(false),
+              _typeNameRequested(false)
+    {
+    }
+
+    // writes the registered alias as _typeName for types registered with one
+    void setWriteTypeAliases(bool writeTypeAliases)
+    {
+        _writeTypeAliases = writeTypeAliases;
+    }
+
+    bool writesTypeAliases() const
+    {
+        return _writeTypeAliases;
+    }
+
+    // writes _typeName only where loading needs it to select the dynamic type, i.e. for objects
+    // saved through a polymorphic pointer whose static type differs from the dynamic type
+    void setWritePolymorphicTypeNamesOnly(bool writePolymorphicTypeNamesOnly)
+    {
+        _writePolymorphicTypeNamesOnly = writePolymorphicTypeNamesOnly;
+    }
+
+    bool writesPolymorphicTypeNamesOnly() const
+    {
+        return _writePolymorphicTypeNamesOnly;
+    }
+
+    // the next object is saved as the dynamic type of a polymorphic pointer
+    void requestTypeName()
+    {
+        _typeNameRequested = true;
+    }
+
+    // true if the object being saved gets a _typeName, a pending request is consumed
+    bool consumeTypeNameRequest()
+    {
+        const bool requested = _typeNameRequested;
+        _typeNameRequested = false;
+        return requested || !_writePolymorphicTypeNamesOnly;
+    }
+
+    void writeKey(const std::string& key)
+    {
+        _writer.Key(key.c_str(), key.size());
+    }
+
+    void writeValue(bool boolValue)
+    {
+        _writer.Bool(boolValue);
+    }
+
+    template <typename T>
+    std::enable_if_t<std::is_arithmetic<T>::value> writeValue(const T& value)
+    {
+        if (!std::isnan(value)) {
+            writeArithmeticValue(value);
+        } else {
+            _writer.Null();
+        }
+    }
+
+    void writeArithmeticValue(const double& doubleValue)
+    {
+        _writer.Double(doubleValue);
+    }
+
+    void writeArithmeticValue(const float& floatValue)
+    {
+        _writer.Float(floatValue);
+    }
+
+    void writeArithmeticValue(const std::int64_t& int64Value)
+    {
+        _writer.Int64(int64Value);
+    }
+
+    void writeArithmeticValue(const std::uint64_t& uint64Value)
+    {
+        _writer.Uint64(uint64Value);
+    }
+
+    template <typename T>
+    std::enable_if_t<json::detail::IsSignedIntegerUpTo32bit<T>::value> writeArithmeticValue(
+            const T& value)
+    {
+        _writer.Int(value);
+    }
+
+    template <typename T>
+    std::enable_if_t<json::detail::IsUnsignedIntegerUpTo32bit<T>::value> writeArithmeticValue(
+            const T& value)
+    {
+        _writer.Uint(value);
+    }
+
+    template <typename T>
+    void writePackedArray(const std::vector<T>& values)
+    {
+        _writer.PackedArray(values.data(), values.size());
+    }
+
+    void writeValue(const std::string& stringValue)
+    {
+        _writer.String(stringValue);
+    }
+
+    // strings with other allocators, e.g. ResourceString
+    template <typename Traits, typename Allocator>
+    void writeValue(const std::basic_string<char, Traits, Allocator>& stringValue)
+    {
+        _writer.String(stringValue.data(), stringValue.size());
+    }
+
+    void writeValue(const char* value)
+    {
+        _writer.String(value);
+    }
+
+    void writeValue(const std::nullptr_t& value)
+    {
+        std::ignore = value;
+        _writer.Null();
+    }
+
+    void startObject()
+    {
+        _writer.StartObject();
+    }
+
+    void endObject()
+    {
+        _writer.EndObject();
+    }
+
+    void startArray()
+    {
+        _writer.StartArray();
+    }
+
+    void endArray()
+    {
+        _writer.EndArray();
+    }
+
+private:
+    binary::detail::BinaryWriter<OutputStream> _writer;
+    bool _writeTypeAliases;
+    bool _writePolymorphicTypeNamesOnly;
+    bool _typeNameRequested;
+};
+
+template <typename OutputStream, typename... Ts>
+void intro(BinaryOutputArchive<OutputStream>& archive, const std::tuple<Ts...>& tuple)
+{
+    std::ignore = tuple;
+    archive.startArray();
+}
+
+template <typename OutputStream, typename... Ts>
+void outro(BinaryOutputArchive<OutputStream>& archive, const std::tuple<Ts...>& tuple)
+{
+    std::ignore = tuple;
+    archive.endArray();
+}
+
+template <typename OutputStream, typename TupleType, std::size_t... Indicies>
+void saveTuple(BinaryOutputArchive<OutputStream>& archive,
+               const TupleType& tuple,
+               std::index_sequence<Indicies...>)
+{
+    detail::Expansion{0, (archive(std::get<Indicies>(tuple)), 0)...};
+}
+
+template <typename OutputStream, typename... Ts>
+void save(BinaryOutputArchive<OutputStream>& archive, const std::tuple<Ts...>& tuple)
+{
+    saveTuple(archive, tuple, std::index_sequence_for<Ts...>{});
+}
+
+template <typename OutputStream, typename T>
+std::enable_if_t<!json::detail::IsNullable<std::decay_t<T>>::value> intro(
+        BinaryOutputArchive<OutputStream>& archive,
+        const NameValuePair<T>& nameValuePair)
+{
+    archive.writeKey(nameValuePair._name);
+}
+
+template <typename OutputStream, typename T>
+std::enable_if_t<json::detail::IsNullable<std::decay_t<T>>::value> intro(
+        BinaryOutputArchive<OutputStream>& archive,
+        const NameValuePair<T>& nameValuePair)
+{
+    if (nameValuePair._value) {
+        archive.writeKey(nameValuePair._name);
+    }
+}
+
+template <typename OutputStream, typename T>
+void outro(BinaryOutputArchive<OutputStream>& archive, const NameValuePair<T>& nameValuePair)
+{
+    std::ignore = archive;
+    std::ignore = nameValuePair;
+}
+
+namespace detail
+{
+template <typename T, typename OutputStream>
+std::enable_if_t<json::detail::HasRegisteredTypeName<T>::value> writeTypeName(
+        BinaryOutputArchive<OutputStream>& archive)
+{
+    if (!archive.consumeTypeNameRequest()) {
+        return;
+    }
+    const char* typeName = muesli::RegisteredType<T>::name();
+    if (archive.writesTypeAliases() && RegisteredTypeAlias<T>::alias() != nullptr) {
+        typeName = RegisteredTypeAlias<T>::alias();
+    }
+    archive(muesli::make_nvp("_typeName", typeName));
+}
+
+template <typename T, typename OutputStream>
+std::enable_if_t<!json::detail::HasRegisteredTypeName<T>::value> writeTypeName(
+        BinaryOutputArchive<OutputStream>& archive)
+{
+    // do nothing
+    std::ignore = archive;
+}
+} // namespace detail
+
+template <typename OutputStream, typename T>
+std::enable_if_t<json::detail::IsObject<T>::value> intro(BinaryOutputArchive<OutputStream>& archive,
+                                                         const T& value)
+{
+    archive.startObject();
+    detail::writeTypeName<T>(archive);
+    std::ignore = value;
+}
+
+template <typename OutputStream, typename T>
+std::enable_if_t<json::detail::IsObject<T>::value> outro(BinaryOutputArchive<OutputStream>& archive,
+                                                         const T& value)
+{
+    archive.endObject();
+    std::ignore = value;
+}
+
+template <typename OutputStream, typename T>
+std::enable_if_t<json::detail::IsPrimitive<T>::value || binary::detail::IsPackedArray<T>::value>
+intro(BinaryOutputArchive<OutputStream>& archive, const T& value)
+{
+    std::ignore = archive;
+    std::ignore = value;
+}
+
+template <typename OutputStream, typename T>
+std::enable_if_t<json::detail::IsPrimitive<T>::value || binary::detail::IsPackedArray<T>::value>
+outro(BinaryOutputArchive<OutputStream>& archive, const T& value)
+{
+    std::ignore = archive;
+    std::ignore = value;
+}
+
+template <typename OutputStream, typename T>
+std::enable_if_t<binary::detail::IsUnpackedArray<T>::value> intro(
+        BinaryOutputArchive<OutputStream>& archive,
+        const T& value)
+{
+    archive.startArray();
+    std::ignore = value;
+}
+
+template <typename OutputStream, typename T>
+std::enable_if_t<binary::detail::IsUnpackedArray<T>::value> outro(
+        BinaryOutputArchive<OutputStream>& archive,
+        const T& value)
+{
+    archive.endArray();
+    std::ignore = value;
+}
+
+template <typename OutputStream, typename T>
+std::enable_if_t<binary::detail::IsUnpackedArray<T>::value> save(
+        BinaryOutputArchive<OutputStream>& archive,
+        const T& array)
+{
+    for (const typename T::value_type& element : array) {
+        archive(element);
+    }
+}
+
+// vectors of numbers are written as a single PackedArray value
+template <typename OutputStream, typename T>
+std::enable_if_t<binary::detail::IsPackedArray<T>::value> save(
+        BinaryOutputArchive<OutputStream>& archive,
+        const T& array)
+{
+    archive.writePackedArray(array);
+}
+
+template <typename OutputStream, typename Map>
+auto save(BinaryOutputArchive<OutputStream>& archive, const Map& map)
+        -> decltype(typename Map::mapped_type(), void())
+{
+    for (const auto& entry : map) {
+        auto value(entry.second);
+        archive(muesli::make_nvp(toString(entry.first), value));
+    }
+}
+
+template <typename OutputStream, typename T>
+void save(BinaryOutputArchive<OutputStream>& archive, const NameValuePair<T>& nameValuePair)
+{
+    archive(nameValuePair._value);
+}
+
+template <typename OutputStream, typename T, typename Default>
+void save(BinaryOutputArchive<OutputStream>& archive,
+          const NameValuePairWithDefault<T, Default>& nameValuePair)
+{
+    archive(make_nvp(nameValuePair._name, nameValuePair._value));
+}
+
+template <typename OutputStream, typename T>
+std::enable_if_t<json::detail::IsPrimitive<T>::value && !std::is_enum<T>::value> save(
+        BinaryOutputArchive<OutputStream>& archive,
+        const T& value)
+{
+    archive.writeValue(value);
+}
+
+// generic serialization for enum types having a wrapper class
+template <typename OutputStream,
+          typename Enum,
+          typename Wrapper = typename EnumTraits<Enum>::Wrapper>
+void save(BinaryOutputArchive<OutputStream>& archive, Enum value)
+{
+    archive.writeValue(Wrapper::getLiteral(value));
+}
+
+namespace detail
+{
+
+template <typename OutputStream, typename T>
+void savePointerDirectly(BinaryOutputArchive<OutputStream>& archive, const T* ptr)
+{
+    archive(*ptr);
+}
+
+template <typename OutputStream, typename Base>
+void savePolymorphicPointerThroughRegistry(BinaryOutputArchive<OutputStream>& archive,
+                                           const Base* ptr,
+                                           const std::type_info& ptrInfo)
+{
+    // lookup in type registry
+    using TypeRegistry =
+            muesli::TypeSaveRegistry<std::decay_t<Base>, BinaryOutputArchive<OutputStream>>;
+    using SaveFunction = typename TypeRegistry::SaveFunction;
+    boost::optional<SaveFunction> saveFunction = TypeRegistry::getSaveFunction(ptrInfo);
+    if (saveFunction) {
+        archive.requestTypeName();
+        (*saveFunction)(archive, ptr);
+    } else {
+        throw exceptions::UnknownTypeException(
+                std::string("could not find output serializer for " +
+                            boost::typeindex::type_id_runtime(*ptr).pretty_name()));
+    }
+}
+
+// generic serialization for non-polymorphic pointer types
+template <typename OutputStream, typename T>
+std::enable_if_t<!std::is_polymorphic<T>::value> savePointer(
+        BinaryOutputArchive<OutputStream>& archive,
+        const T* ptr)
+{
+    if (ptr != nullptr) {
+        savePointerDirectly(archive, ptr);
+    }
+}
+
+// generic serialization for polymorphic, non-abstract pointer types
+template <typename OutputStream, typename Base>
+std::enable_if_t<std::is_polymorphic<Base>::value && !std::is_abstract<Base>::value> savePointer(
+        BinaryOutputArchive<OutputStream>& archive,
+        const Base* ptr)
+{
+    if (ptr != nullptr) {
+        const std::type_info& ptrInfo = typeid(*ptr);
+        static const std::type_info& typeInfo = typeid(Base);
+
+        if (ptrInfo == typeInfo) {
+            savePointerDirectly(archive, ptr);
+        } else {
+            savePolymorphicPointerThroughRegistry(archive, ptr, ptrInfo);
+        }
+    }
+}
+
+// generic serialization for polymorphic, abstract pointer types
+template <typename OutputStream, typename Base>
+std::enable_if_t<std::is_polymorphic<Base>::value && std::is_abstract<Base>::value> savePointer(
+        BinaryOutputArchive<OutputStream>& archive,
+        const Base* ptr)
+{
+    if (ptr != nullptr) {
+        savePolymorphicPointerThroughRegistry(archive, ptr, typeid(*ptr));
+    }
+}
+} // namespace detail
+
+template <typename OutputStream, typename T>
+void save(BinaryOutputArchive<OutputStream>& archive, const std::shared_ptr<T>& ptr)
+{
+    detail::savePointer(archive, ptr.get());
+}
+
+template <typename OutputStream, typename T>
+void save(BinaryOutputArchive<OutputStream>& archive, const std::unique_ptr<T>& ptr)
+{
+    detail::savePointer(archive, ptr.get());
+}
+
+template <typename OutputStream, typename T>
+void save(BinaryOutputArchive<OutputStream>& archive, const boost::optional<T>& opt)
+{
+    if (opt) {
+        archive(opt.get());
+    }
+}
+
+} // namespace muesli
+
+MUESLI_REGISTER_OUTPUT_ARCHIVE(muesli::BinaryOutputArchive, muesli::tags::binary)
+MUESLI_REGISTER_EVENT_WRITER(muesli::binary::detail::BinaryWriter, muesli::tags::binary)
+
+#endif // MUESLI_ARCHIVES_BINARY_BINARYOUTPUTARCHIVE_H_
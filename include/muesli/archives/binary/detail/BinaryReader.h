@@ -0,0 +1,403 @@
+/*
+ * #%L
+ * %%
+ * Copyright (C) 2011 - 2016 BMW Car IT GmbH
+ * %%
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ * 
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ * 
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ * #L%
+ */
+
+#ifndef MUESLI_ARCHIVES_BINARY_DETAIL_BINARYREADER_H_
+#define MUESLI_ARCHIVES_BINARY_DETAIL_BINARYREADER_H_
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "muesli/detail/ReadFromStream.h"
+#include "muesli/exceptions/ParseException.h"
+
+#include "muesli/archives/binary/detail/Encoding.h"
+
+namespace muesli
+{
+namespace binary
+{
+namespace detail
+{
+
+// reads binary encoded values from a muesli InputStream
+// the stream is read through read(Char*, std::size_t), which reports the end of the input, so
+// truncated input causes a ParseException; length prefixes are not trusted, strings grow with the
+// bytes actually read
+// values which have been captured before may be replayed, they are read before the stream
+template <typename InputStream>
+class BinaryReader
+{
+    using Char = typename InputStream::Char;
+    static_assert(sizeof(Char) == 1, "BinaryReader requires a byte oriented InputStream");
+
+public:
+    explicit BinaryReader(InputStream& stream) : _stream(stream), _replays(), _capture(nullptr)
+    {
+    }
+
+    // non-copyable
+    BinaryReader(const BinaryReader&) = delete;
+    BinaryReader& operator=(const BinaryReader&) = delete;
+
+    Marker peekMarker() const
+    {
+        if (!_replays.empty()) {
+            const Replay& replay = _replays.back();
+            return toMarker(replay._bytes[replay._position]);
+        }
+        return toMarker(_stream.peek());
+    }
+
+    Marker readMarker()
+    {
+        return toMarker(readByte());
+    }
+
+    std::uint64_t readVarint()
+    {
+        std::uint64_t value = 0;
+        for (unsigned int shift = 0; shift < 64; shift += 7) {
+            const unsigned char byte = readByte();
+            if (isVarintOverflow(shift, byte)) {
+                break;
+            }
+            value |= static_cast<std::uint64_t>(byte & 0x7F) << shift;
+            if ((byte & 0x80) == 0) {
+                return value;
+            }
+        }
+        throw exceptions::ParseException("could not parse binary: invalid varint");
+    }
+
+    double readDouble()
+    {
+        unsigned char bytes[sizeof(double)];
+        readBytes(bytes, sizeof(bytes));
+        return bitsToDouble(decodeFixed(bytes, sizeof(bytes)));
+    }
+
+    float readFloat()
+    {
+        unsigned char bytes[sizeof(float)];
+        readBytes(bytes, sizeof(bytes));
+        return bitsToFloat(static_cast<std::uint32_t>(decodeFixed(bytes, sizeof(bytes))));
+    }
+
+    // reads the payload of a String value whose marker has already been read
+    template <typename String>
+    void readString(String& value)
+    {
+        value.clear();
+        unsigned char chunk[chunkSize];
+        for (std::uint64_t remaining = readVarint(); remaining > 0;) {
+            const std::size_t length = static_cast<std::size_t>(
+                    std::min<std::uint64_t>(remaining, sizeof(chunk)));
+            readBytes(chunk, length);
+            value.append(reinterpret_cast<const char*>(chunk), length);
+            remaining -= length;
+        }
+    }
+
+    // reads the remainder of a PackedArray value whose marker has already been read
+    Marker readPackedArray(std::size_t& count, std::string& payload)
+    {
+        const Marker elementMarker = readMarker();
+        count = readVarint();
+        readString(payload);
+        return elementMarker;
+    }
+
+    // skips one complete value including nested containers
+    void skipValue()
+    {
+        std::size_t depth = 0;
+        do {
+            switch (readMarker()) {
+            case Marker::Null:
+            case Marker::False:
+            case Marker::True:
+                break;
+            case Marker::UnsignedInteger:
+            case Marker::SignedInteger:
+                readVarint();
+                break;
+            case Marker::Float:
+                skipBytes(sizeof(float));
+                break;
+            case Marker::Double:
+                skipBytes(sizeof(double));
+                break;
+            case Marker::String:
+                skipBytes(readVarint());
+                break;
+            case Marker::ArrayStart:
+            case Marker::ObjectStart:
+                ++depth;
+                break;
+            case Marker::ArrayEnd:
+            case Marker::ObjectEnd:
+                if (depth == 0) {
+                    throw exceptions::ParseException(
+                            "could not parse binary: unexpected end of container");
+                }
+                --depth;
+                break;
+            case Marker::PackedArray:
+                readMarker();
+                readVarint();
+                skipBytes(readVarint());
+                break;
+            }
+        } while (depth > 0);
+    }
+
+    // skips one complete value and appends its encoding to 'bytes'
+    void captureValue(std::string& bytes)
+    {
+        struct CaptureScope
+        {
+            ~CaptureScope()
+            {
+                _reader._capture = nullptr;
+            }
+            BinaryReader& _reader;
+        } scope{*this};
+        _capture = &bytes;
+        skipValue();
+    }
+
+    // makes the next reads return 'bytes' before continuing with the current input
+    void replay(std::string bytes)
+    {
+        if (!bytes.empty()) {
+            _replays.push_back(Replay{std::move(bytes), 0});
+        }
+    }
+
+    // reports one complete value as RapidJSON SAX events to 'handler'
+    // memory usage is bounded by the nesting depth and the longest string or packed array, which
+    // cannot be longer than the input
+    template <typename Handler>
+    void parse(Handler& handler)
+    {
+        std::vector<Container> containers;
+        std::string string;
+        do {
+            bool accepted = true;
+            bool valueCompleted = true;
+            const Marker marker = readMarker();
+            if (!containers.empty() && containers.back() == Container::ObjectKey &&
+                marker != Marker::String && marker != Marker::ObjectEnd) {
+                throw exceptions::ParseException("could not parse binary: expected a key");
+            }
+            switch (marker) {
+            case Marker::Null:
+                accepted = handler.Null();
+                break;
+            case Marker::False:
+                accepted = handler.Bool(false);
+                break;
+            case Marker::True:
+                accepted = handler.Bool(true);
+                break;
+            case Marker::UnsignedInteger:
+                accepted = handler.Uint64(readVarint());
+                break;
+            case Marker::SignedInteger:
+                accepted = handler.Int64(zigzagDecode(readVarint()));
+                break;
+            case Marker::Float:
+                accepted = handler.Double(readFloat());
+                break;
+            case Marker::Double:
+                accepted = handler.Double(readDouble());
+                break;
+            case Marker::String:
+                readString(string);
+                if (!containers.empty() && containers.back() == Container::ObjectKey) {
+                    containers.back() = Container::ObjectValue;
+                    accepted = handler.Key(string.data(), string.size(), true);
+                    valueCompleted = false;
+                } else {
+                    accepted = handler.String(string.data(), string.size(), true);
+                }
+                break;
+            case Marker::ArrayStart:
+                containers.push_back(Container::Array);
+                accepted = handler.StartArray();
+                valueCompleted = false;
+                break;
+            case Marker::ObjectStart:
+                containers.push_back(Container::ObjectKey);
+                accepted = handler.StartObject();
+                valueCompleted = false;
+                break;
+            case Marker::ArrayEnd:
+                popContainer(containers, Container::Array);
+                accepted = handler.EndArray(0);
+                break;
+            case Marker::ObjectEnd:
+                popContainer(containers, Container::ObjectKey);
+                accepted = handler.EndObject(0);
+                break;
+            case Marker::PackedArray:
+                accepted = parsePackedArray(handler, string);
+                break;
+            }
+            if (!accepted) {
+                throw exceptions::ParseException("could not transcode: value rejected by writer");
+            }
+            if (valueCompleted && !containers.empty() &&
+                containers.back() == Container::ObjectValue) {
+                containers.back() = Container::ObjectKey;
+            }
+        } while (!containers.empty());
+    }
+
+private:
+    enum class Container { Array, ObjectKey, ObjectValue };
+
+    struct Replay
+    {
+        std::string _bytes;
+        std::size_t _position;
+    };
+
+    static constexpr std::size_t chunkSize = 4096;
+
+    static void popContainer(std::vector<Container>& containers, Container expected)
+    {
+        if (containers.empty() || containers.back() != expected) {
+            throw exceptions::ParseException("could not parse binary: unexpected end of container");
+        }
+        containers.pop_back();
+    }
+
+    // the payload is read as a whole, so that it can be checked against the element count
+    template <typename Handler>
+    bool parsePackedArray(Handler& handler, std::string& payload)
+    {
+        std::size_t count = 0;
+        const Marker elementMarker = readPackedArray(count, payload);
+        const unsigned char* it = reinterpret_cast<const unsigned char*>(payload.data());
+        const unsigned char* end = it + payload.size();
+        bool accepted = handler.StartArray();
+        for (std::size_t i = 0; accepted && i < count; ++i) {
+            if (elementMarker == Marker::UnsignedInteger) {
+                accepted = handler.Uint64(decodeVarint(it, end));
+            } else if (elementMarker == Marker::SignedInteger) {
+                accepted = handler.Int64(zigzagDecode(decodeVarint(it, end)));
+            } else if (elementMarker == Marker::Float) {
+                const std::uint64_t bits = decodePackedFixed(it, end, sizeof(float));
+                accepted = handler.Double(bitsToFloat(static_cast<std::uint32_t>(bits)));
+            } else if (elementMarker == Marker::Double) {
+                accepted = handler.Double(bitsToDouble(decodePackedFixed(it, end, sizeof(double))));
+            } else {
+                throw exceptions::ParseException("could not parse binary: invalid packed array");
+            }
+        }
+        if (accepted && it != end) {
+            throw exceptions::ParseException("could not parse binary: invalid packed array");
+        }
+        return accepted && handler.EndArray(0);
+    }
+
+    static std::uint64_t decodePackedFixed(const unsigned char*& it,
+                                           const unsigned char* end,
+                                           std::size_t length)
+    {
+        if (static_cast<std::size_t>(end - it) < length) {
+            throw exceptions::ParseException("could not parse binary: invalid packed array");
+        }
+        const std::uint64_t bits = decodeFixed(it, length);
+        it += length;
+        return bits;
+    }
+
+    static Marker toMarker(Char character)
+    {
+        const unsigned char byte = static_cast<unsigned char>(character);
+        if (!isValidMarker(byte)) {
+            throw exceptions::ParseException(
+                    "could not parse binary: unexpected end of input or invalid marker");
+        }
+        return static_cast<Marker>(byte);
+    }
+
+    unsigned char readByte()
+    {
+        unsigned char byte;
+        readBytes(&byte, 1);
+        return byte;
+    }
+
+    void readBytes(unsigned char* bytes, std::size_t length)
+    {
+        while (length > 0) {
+            std::size_t count;
+            if (!_replays.empty()) {
+                Replay& replay = _replays.back();
+                count = replay._bytes.copy(
+                        reinterpret_cast<char*>(bytes), length, replay._position);
+                replay._position += count;
+                if (replay._position == replay._bytes.size()) {
+                    _replays.pop_back();
+                }
+            } else {
+                count = muesli::detail::readFromStream(
+                        _stream, reinterpret_cast<Char*>(bytes), length);
+                if (count == 0) {
+                    throw exceptions::ParseException(
+                            "could not parse binary: unexpected end of input");
+                }
+            }
+            if (_capture != nullptr) {
+                _capture->append(reinterpret_cast<const char*>(bytes), count);
+            }
+            bytes += count;
+            length -= count;
+        }
+    }
+
+    void skipBytes(std::uint64_t length)
+    {
+        unsigned char chunk[chunkSize];
+        while (length > 0) {
+            const std::size_t count =
+                    static_cast<std::size_t>(std::min<std::uint64_t>(length, sizeof(chunk)));
+            readBytes(chunk, count);
+            length -= count;
+        }
+    }
+
+    InputStream& _stream;
+    // captured values which are read before '_stream', the last one is read first
+    std::vector<Replay> _replays;
+    // receives a copy of every byte read while captureValue() is running
+    std::string* _capture;
+};
+
+} // namespace detail
+} // namespace binary
+} // namespace muesli
+
+#endif // MUESLI_ARCHIVES_BINARY_DETAIL_BINARYREADER_H_
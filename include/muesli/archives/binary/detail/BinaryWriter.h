@@ -0,0 +1,258 @@
+/*
+ * #%L
+ * %%
+ * Copyright (C) 2011 - 2016 BMW Car IT GmbH
+ * %%
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ * 
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ * 
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ * #L%
+ */
+
+#ifndef MUESLI_ARCHIVES_BINARY_DETAIL_BINARYWRITER_H_
+#define MUESLI_ARCHIVES_BINARY_DETAIL_BINARYWRITER_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <tuple>
+#include <type_traits>
+
+#include "muesli/archives/binary/detail/Encoding.h"
+
+namespace muesli
+{
+namespace binary
+{
+namespace detail
+{
+
+// writes binary encoded values to a muesli OutputStream
+// the interface follows the one of RapidJSON's Writer
+template <typename OutputStream>
+class BinaryWriter
+{
+    using Char = typename OutputStream::Char;
+    static_assert(sizeof(Char) == 1, "BinaryWriter requires a byte oriented OutputStream");
+
+public:
+    explicit BinaryWriter(OutputStream& stream) : _stream(stream), _buffer()
+    {
+    }
+
+    bool Null()
+    {
+        return putMarker(Marker::Null);
+    }
+
+    bool Bool(bool value)
+    {
+        return putMarker(value ? Marker::True : Marker::False);
+    }
+
+    bool Int(int value)
+    {
+        return Int64(value);
+    }
+
+    bool Uint(unsigned value)
+    {
+        return Uint64(value);
+    }
+
+    bool Int64(std::int64_t value)
+    {
+        return putVarint(Marker::SignedInteger, zigzagEncode(value));
+    }
+
+    bool Uint64(std::uint64_t value)
+    {
+        return putVarint(Marker::UnsignedInteger, value);
+    }
+
+    bool Double(double value)
+    {
+        return putFixed(Marker::Double, doubleToBits(value), sizeof(double));
+    }
+
+    bool Float(float value)
+    {
+        return putFixed(Marker::Float, floatToBits(value), sizeof(float));
+    }
+
+    // only used by RapidJSON's Reader if numbers are parsed as strings
+    bool RawNumber(const char* value, std::size_t length, bool copy = false)
+    {
+        std::ignore = copy;
+        _buffer.assign(value, length);
+        if (_buffer.find_first_of(".eE") != std::string::npos) {
+            return Double(std::strtod(_buffer.c_str(), nullptr));
+        } else if (!_buffer.empty() && _buffer[0] == '-') {
+            return Int64(std::strtoll(_buffer.c_str(), nullptr, 10));
+        }
+        return Uint64(std::strtoull(_buffer.c_str(), nullptr, 10));
+    }
+
+    bool String(const char* value, std::size_t length, bool copy = false)
+    {
+        std::ignore = copy;
+        putVarint(Marker::String, length);
+        write(reinterpret_cast<const unsigned char*>(value), length);
+        return true;
+    }
+
+    bool String(const char* value)
+    {
+        return String(value, std::strlen(value));
+    }
+
+    bool String(const std::string& value)
+    {
+        return String(value.data(), value.size());
+    }
+
+    bool Key(const char* key, std::size_t length, bool copy = false)
+    {
+        return String(key, length, copy);
+    }
+
+    bool StartObject()
+    {
+        return putMarker(Marker::ObjectStart);
+    }
+
+    bool EndObject(std::size_t memberCount = 0)
+    {
+        std::ignore = memberCount;
+        return putMarker(Marker::ObjectEnd);
+    }
+
+    bool StartArray()
+    {
+        return putMarker(Marker::ArrayStart);
+    }
+
+    bool EndArray(std::size_t elementCount = 0)
+    {
+        std::ignore = elementCount;
+        return putMarker(Marker::ArrayEnd);
+    }
+
+    // writes all values with a single marker; integers are encoded into one buffer in a tight loop
+    template <typename T>
+    std::enable_if_t<std::is_integral<T>::value> PackedArray(const T* values, std::size_t count)
+    {
+        _buffer.resize(count * maxVarintLength);
+        unsigned char* out = reinterpret_cast<unsigned char*>(&_buffer[0]);
+        std::size_t length = 0;
+        for (std::size_t i = 0; i < count; ++i) {
+            length += encodeVarint(toVarint(values[i]), out + length);
+        }
+        putPackedHeader(std::is_signed<T>::value ? Marker::SignedInteger : Marker::UnsignedInteger,
+                        count,
+                        length);
+        write(out, length);
+    }
+
+    template <typename T>
+    std::enable_if_t<std::is_floating_point<T>::value> PackedArray(const T* values,
+                                                                   std::size_t count)
+    {
+        const std::size_t length = count * sizeof(T);
+        _buffer.resize(length);
+        unsigned char* out = reinterpret_cast<unsigned char*>(&_buffer[0]);
+        for (std::size_t i = 0; i < count; ++i) {
+            encodeFixed(toBits(values[i]), sizeof(T), out + i * sizeof(T));
+        }
+        putPackedHeader(sizeof(T) == sizeof(float) ? Marker::Float : Marker::Double, count, length);
+        write(out, length);
+    }
+
+    void Flush()
+    {
+        _stream.flush();
+    }
+
+private:
+    template <typename T>
+    static std::enable_if_t<std::is_signed<T>::value, std::uint64_t> toVarint(T value)
+    {
+        return zigzagEncode(value);
+    }
+
+    template <typename T>
+    static std::enable_if_t<std::is_unsigned<T>::value, std::uint64_t> toVarint(T value)
+    {
+        return value;
+    }
+
+    static std::uint64_t toBits(double value)
+    {
+        return doubleToBits(value);
+    }
+
+    static std::uint64_t toBits(float value)
+    {
+        return floatToBits(value);
+    }
+
+    bool putMarker(Marker marker)
+    {
+        _stream.put(static_cast<Char>(marker));
+        return true;
+    }
+
+    bool putVarint(Marker marker, std::uint64_t value)
+    {
+        unsigned char bytes[1 + maxVarintLength];
+        bytes[0] = static_cast<unsigned char>(marker);
+        write(bytes, 1 + encodeVarint(value, bytes + 1));
+        return true;
+    }
+
+    bool putFixed(Marker marker, std::uint64_t bits, std::size_t length)
+    {
+        unsigned char bytes[1 + sizeof(std::uint64_t)];
+        bytes[0] = static_cast<unsigned char>(marker);
+        encodeFixed(bits, length, bytes + 1);
+        write(bytes, 1 + length);
+        return true;
+    }
+
+    void putPackedHeader(Marker elementMarker, std::size_t count, std::size_t payloadSize)
+    {
+        unsigned char bytes[2 + 2 * maxVarintLength];
+        bytes[0] = static_cast<unsigned char>(Marker::PackedArray);
+        bytes[1] = static_cast<unsigned char>(elementMarker);
+        std::size_t length = 2;
+        length += encodeVarint(count, bytes + length);
+        length += encodeVarint(payloadSize, bytes + length);
+        write(bytes, length);
+    }
+
+    void write(const unsigned char* bytes, std::size_t length)
+    {
+        if (length > 0) {
+            _stream.write(reinterpret_cast<const Char*>(bytes), length);
+        }
+    }
+
+    OutputStream& _stream;
+    std::string _buffer;
+};
+
+} // namespace detail
+} // namespace binary
+} // namespace muesli
+
+#endif // MUESLI_ARCHIVES_BINARY_DETAIL_BINARYWRITER_H_
@@ -0,0 +1,188 @@
+/*
+ * #%L
+ * %%
+ * Copyright (C) 2011 - 2016 BMW Car IT GmbH
+ * %%
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ * 
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ * 
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ * #L%
+ */
+
+#ifndef MUESLI_ARCHIVES_BINARY_DETAIL_ENCODING_H_
+#define MUESLI_ARCHIVES_BINARY_DETAIL_ENCODING_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+#include "muesli/exceptions/ParseException.h"
+
+namespace muesli
+{
+namespace binary
+{
+namespace detail
+{
+
+// first byte of every encoded value
+// 0x00 is not used so that peeking at the end of the input, where InputStreams return '\0',
+// is detected
+enum class Marker : unsigned char {
+    Null = 0x01,
+    False = 0x02,
+    True = 0x03,
+    UnsignedInteger = 0x04, // LEB128 varint
+    SignedInteger = 0x05,   // zigzag encoded LEB128 varint
+    Float = 0x06,           // 4 bytes little endian
+    Double = 0x07,          // 8 bytes little endian
+    String = 0x08,          // varint length followed by the characters
+    ArrayStart = 0x09,
+    ArrayEnd = 0x0A,
+    ObjectStart = 0x0B, // followed by alternating String keys and values
+    ObjectEnd = 0x0C,
+    PackedArray = 0x0D // element marker, varint count, varint payload size, payload
+};
+
+inline bool isValidMarker(unsigned char byte)
+{
+    return byte >= static_cast<unsigned char>(Marker::Null) &&
+           byte <= static_cast<unsigned char>(Marker::PackedArray);
+}
+
+// maximum number of bytes of a LEB128 encoded 64 bit value
+constexpr std::size_t maxVarintLength = 10;
+
+// maps signed values to unsigned ones so that small magnitudes result in short varints
+inline std::uint64_t zigzagEncode(std::int64_t value)
+{
+    return (static_cast<std::uint64_t>(value) << 1) ^ static_cast<std::uint64_t>(value >> 63);
+}
+
+inline std::int64_t zigzagDecode(std::uint64_t value)
+{
+    return static_cast<std::int64_t>(value >> 1) ^ -static_cast<std::int64_t>(value & 1);
+}
+
+// writes 'value' as LEB128 varint to 'out' and returns the number of bytes written
+inline std::size_t encodeVarint(std::uint64_t value, unsigned char* out)
+{
+    std::size_t length = 0;
+    while (value >= 0x80) {
+        out[length++] = static_cast<unsigned char>(value | 0x80);
+        value >>= 7;
+    }
+    out[length++] = static_cast<unsigned char>(value);
+    return length;
+}
+
+// the last of maxVarintLength bytes only holds the highest bit of the value, higher bits would
+// overflow and a continuation bit would make the varint overlong
+inline bool isVarintOverflow(unsigned int shift, unsigned char byte)
+{
+    return shift == 7 * (maxVarintLength - 1) && byte > 1;
+}
+
+// decodes a single LEB128 varint and advances 'it' behind it
+inline std::uint64_t decodeVarint(const unsigned char*& it, const unsigned char* end)
+{
+    std::uint64_t value = 0;
+    for (unsigned int shift = 0; shift < 64 && it != end; shift += 7) {
+        const unsigned char byte = *it++;
+        if (isVarintOverflow(shift, byte)) {
+            break;
+        }
+        value |= static_cast<std::uint64_t>(byte & 0x7F) << shift;
+        if ((byte & 0x80) == 0) {
+            return value;
+        }
+    }
+    throw exceptions::ParseException("could not parse binary: invalid varint");
+}
+
+// decodes 'count' varints into 'out' converting each of them with 'convert'
+// runs of single byte varints are detected eight bytes at a time
+template <typename T, typename Convert>
+const unsigned char* decodeVarints(const unsigned char* it,
+                                   const unsigned char* end,
+                                   T* out,
+                                   std::size_t count,
+                                   Convert convert)
+{
+    constexpr std::uint64_t continuationBits = 0x8080808080808080ULL;
+    std::size_t index = 0;
+    while (index < count) {
+        if (count - index >= 8 && end - it >= 8) {
+            std::uint64_t word;
+            std::memcpy(&word, it, sizeof(word));
+            if ((word & continuationBits) == 0) {
+                for (std::size_t i = 0; i < 8; ++i) {
+                    out[index + i] = convert(static_cast<std::uint64_t>(it[i]));
+                }
+                it += 8;
+                index += 8;
+                continue;
+            }
+        }
+        out[index++] = convert(decodeVarint(it, end));
+    }
+    return it;
+}
+
+inline void encodeFixed(std::uint64_t bits, std::size_t length, unsigned char* out)
+{
+    for (std::size_t i = 0; i < length; ++i) {
+        out[i] = static_cast<unsigned char>(bits >> (8 * i));
+    }
+}
+
+inline std::uint64_t decodeFixed(const unsigned char* in, std::size_t length)
+{
+    std::uint64_t bits = 0;
+    for (std::size_t i = 0; i < length; ++i) {
+        bits |= static_cast<std::uint64_t>(in[i]) << (8 * i);
+    }
+    return bits;
+}
+
+inline std::uint64_t doubleToBits(double value)
+{
+    std::uint64_t bits;
+    std::memcpy(&bits, &value, sizeof(bits));
+    return bits;
+}
+
+inline double bitsToDouble(std::uint64_t bits)
+{
+    double value;
+    std::memcpy(&value, &bits, sizeof(value));
+    return value;
+}
+
+inline std::uint32_t floatToBits(float value)
+{
+    std::uint32_t bits;
+    std::memcpy(&bits, &value, sizeof(bits));
+    return bits;
+}
+
+inline float bitsToFloat(std::uint32_t bits)
+{
+    float value;
+    std::memcpy(&value, &bits, sizeof(value));
+    return value;
+}
+
+} // namespace detail
+} // namespace binary
+} // namespace muesli
+
+#endif // MUESLI_ARCHIVES_BINARY_DETAIL_ENCODING_H_
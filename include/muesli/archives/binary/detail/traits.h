@@ -0,0 +1,75 @@
+/*
+ * #%L
+ * %%
+ * Copyright (C) 2011 - 2016 BMW Car IT GmbH
+ * %%
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ * 
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ * 
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ * #L%
+ */
+
+#ifndef MUESLI_ARCHIVES_BINARY_DETAIL_TRAITS_H_
+#define MUESLI_ARCHIVES_BINARY_DETAIL_TRAITS_H_
+
+#include <cstdint>
+#include <type_traits>
+#include <vector>
+
+#include "muesli/detail/IsTypeWithinList.h"
+
+#include "muesli/archives/json/detail/traits.h"
+
+namespace muesli
+{
+namespace binary
+{
+namespace detail
+{
+
+// element types which are stored in a single PackedArray value
+template <typename T>
+struct IsPackable
+{
+    static constexpr bool value = muesli::detail::IsTypeWithinList<T,
+                                                                   std::int8_t,
+                                                                   std::int16_t,
+                                                                   std::int32_t,
+                                                                   std::int64_t,
+                                                                   std::uint8_t,
+                                                                   std::uint16_t,
+                                                                   std::uint32_t,
+                                                                   std::uint64_t,
+                                                                   float,
+                                                                   double>::value;
+};
+
+template <typename T>
+struct IsPackedArray : std::false_type
+{
+};
+
+template <typename T>
+struct IsPackedArray<std::vector<T>> : std::integral_constant<bool, IsPackable<T>::value>
+{
+};
+
+template <typename T>
+struct IsUnpackedArray
+{
+    static constexpr bool value = json::detail::IsArray<T>::value && !IsPackedArray<T>::value;
+};
+
+} // namespace detail
+} // namespace binary
+} // namespace muesli
+
+#endif // MUESLI_ARCHIVES_BINARY_DETAIL_TRAITS_H_
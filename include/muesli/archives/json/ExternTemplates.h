@@ -0,0 +1,88 @@
+/*
+ * #%L
+ * %%
+ * Copyright (C) 2011 - 2016 BMW Car IT GmbH
+ * %%
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ * 
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ * 
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ * #L%
+ */
+
+#ifndef MUESLI_ARCHIVES_JSON_EXTERNTEMPLATES_H_
+#define MUESLI_ARCHIVES_JSON_EXTERNTEMPLATES_H_
+
+#include <cstdint>
+#include <istream>
+#include <ostream>
+#include <string>
+#include <vector>
+
+#include "muesli/archives/json/JsonInputArchive.h"
+#include "muesli/archives/json/JsonOutputArchive.h"
+#include "muesli/streams/AnyIStream.h"
+#include "muesli/streams/AnyOStream.h"
+#include "muesli/streams/StdIStreamWrapper.h"
+#include "muesli/streams/StdOStreamWrapper.h"
+#include "muesli/streams/StringIStream.h"
+#include "muesli/streams/StringOStream.h"
+
+// Explicit instantiations of the JSON archives for the standard streams and of the loads and
+// saves of primitives and vectors of primitives. The muesli_json library compiles them once and
+// defines MUESLI_JSON_EXTERN_TEMPLATES for its users, which turns the lists below into extern
+// template declarations, so that translation units including this header do not instantiate
+// them again.
+
+#define MUESLI_JSON_FOR_EACH_PRIMITIVE(MACRO, Prefix, Stream)                                      \
+    MACRO(Prefix, Stream, bool)                                                                    \
+    MACRO(Prefix, Stream, std::int8_t)                                                             \
+    MACRO(Prefix, Stream, std::int16_t)                                                            \
+    MACRO(Prefix, Stream, std::int32_t)                                                            \
+    MACRO(Prefix, Stream, std::int64_t)                                                            \
+    MACRO(Prefix, Stream, std::uint8_t)                                                            \
+    MACRO(Prefix, Stream, std::uint16_t)                                                           \
+    MACRO(Prefix, Stream, std::uint32_t)                                                           \
+    MACRO(Prefix, Stream, std::uint64_t)                                                           \
+    MACRO(Prefix, Stream, float)                                                                   \
+    MACRO(Prefix, Stream, double)                                                                  \
+    MACRO(Prefix, Stream, std::string)
+
+#define MUESLI_JSON_INSTANTIATE_SAVE(Prefix, Stream, T)                                            \
+    Prefix template void muesli::save(muesli::JsonOutputArchive<Stream>&, const T&);               \
+    Prefix template void muesli::save(muesli::JsonOutputArchive<Stream>&, const std::vector<T>&);
+
+#define MUESLI_JSON_INSTANTIATE_LOAD(Prefix, Stream, T)                                            \
+    Prefix template void muesli::load(muesli::JsonInputArchive<Stream>&, T&);                      \
+    Prefix template void muesli::load(muesli::JsonInputArchive<Stream>&, std::vector<T>&);
+
+#define MUESLI_JSON_INSTANTIATE_OUTPUT_ARCHIVE(Prefix, Stream)                                     \
+    Prefix template class rapidjson::Writer<                                                       \
+            muesli::json::detail::RapidJsonOutputStreamAdapter<Stream>>;                           \
+    Prefix template class muesli::JsonOutputArchive<Stream>;                                       \
+    MUESLI_JSON_FOR_EACH_PRIMITIVE(MUESLI_JSON_INSTANTIATE_SAVE, Prefix, Stream)
+
+#define MUESLI_JSON_INSTANTIATE_INPUT_ARCHIVE(Prefix, Stream)                                      \
+    Prefix template class muesli::JsonInputArchive<Stream>;                                        \
+    MUESLI_JSON_FOR_EACH_PRIMITIVE(MUESLI_JSON_INSTANTIATE_LOAD, Prefix, Stream)
+
+#define MUESLI_JSON_INSTANTIATE_ARCHIVES(Prefix)                                                   \
+    MUESLI_JSON_INSTANTIATE_OUTPUT_ARCHIVE(Prefix, muesli::StringOStream)                          \
+    MUESLI_JSON_INSTANTIATE_OUTPUT_ARCHIVE(Prefix, muesli::StdOStreamWrapper<std::ostream>)        \
+    MUESLI_JSON_INSTANTIATE_OUTPUT_ARCHIVE(Prefix, muesli::AnyOStream)                             \
+    MUESLI_JSON_INSTANTIATE_INPUT_ARCHIVE(Prefix, muesli::StringIStream)                           \
+    MUESLI_JSON_INSTANTIATE_INPUT_ARCHIVE(Prefix, muesli::StdIStreamWrapper<std::istream>)         \
+    MUESLI_JSON_INSTANTIATE_INPUT_ARCHIVE(Prefix, muesli::AnyIStream)
+
+#ifdef MUESLI_JSON_EXTERN_TEMPLATES
+MUESLI_JSON_INSTANTIATE_ARCHIVES(extern)
+#endif // MUESLI_JSON_EXTERN_TEMPLATES
+
+#endif // MUESLI_ARCHIVES_JSON_EXTERNTEMPLATES_H_
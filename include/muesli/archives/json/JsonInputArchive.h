@@ -20,14 +20,15 @@
 #define MUESLI_ARCHIVES_JSON_JSONINPUTARCHIVE_H_
 
 #include <cstdint>
+#include <cstring>
 #include <iterator>
 #include <memory>
 #include <stack>
 #include <string>
 #include <tuple>
+#include <typeinfo>
 #include <vector>
 
-#include <boost/lexical_cast.hpp>
 #include <boost/type_index.hpp>
 #include <boost/optional.hpp>
 
@@ -35,24 +36,40 @@
 #define RAPIDJSON_HAS_STDSTRING 1
 #include <rapidjson/document.h>
 #include <rapidjson/error/en.h>
+#include <rapidjson/stringbuffer.h>
+#include <rapidjson/writer.h>
 #undef RAPIDJSON_HAS_STDSTRING
 #else
 #include <rapidjson/document.h>
 #include <rapidjson/error/en.h>
+#include <rapidjson/stringbuffer.h>
+#include <rapidjson/writer.h>
 #endif // RAPIDJSON_HAS_STDSTRING
 
 #include "muesli/ArchiveRegistry.h"
 #include "muesli/BaseArchive.h"
+#include "muesli/Columnar.h"
+#include "muesli/EventRegistry.h"
+#include "muesli/FieldMask.h"
+#include "muesli/LoadError.h"
+#include "muesli/MemoryResource.h"
 #include "muesli/NameValuePair.h"
+#include "muesli/NameValuePairWithDefault.h"
 #include "muesli/SkipIntroOutroWrapper.h"
 #include "muesli/Traits.h"
 #include "muesli/TypeRegistryFwd.h"
 #include "muesli/detail/Expansion.h"
+#include "muesli/detail/MakePointer.h"
+#include "muesli/detail/MapKeyConversion.h"
+#include "muesli/detail/ScopedAssignment.h"
 #include "muesli/exceptions/ValueNotFoundException.h"
 #include "muesli/exceptions/UnknownTypeException.h"
 #include "muesli/exceptions/ParseException.h"
 
+#include "muesli/archives/json/RawJson.h"
 #include "muesli/archives/json/detail/traits.h"
+#include "muesli/archives/json/detail/JsonEventReader.h"
+#include "muesli/archives/json/detail/JsonPointer.h"
 #include "muesli/archives/json/detail/RapidJsonInputStreamAdapter.h"
 #include "muesli/archives/json/Tag.h"
 
@@ -67,26 +84,84 @@ class JsonInputArchive
     using Value = rapidjson::Document::GenericValue;
 
 public:
-    explicit JsonInputArchive(InputStream& stream)
-            : Parent(this),
-              _document(),
-              _nextKey(),
-              _nextKeyValid(false),
-              _nextIndex(0),
-              _nextIndexValid(false),
-              _stack(),
-              _stateHistoryStack(),
-              _isRoot(true)
+    explicit JsonInputArchive(InputStream& stream) : JsonInputArchive(stream, FieldMask())
     {
-        using AdaptedStream = json::detail::RapidJsonInputStreamAdapter<InputStream>;
-        AdaptedStream adaptedStream(stream);
-        _document.ParseStream<0>(adaptedStream);
-        if (_document.HasParseError()) {
-            throw exceptions::ParseException(
-                    std::string("could not parse JSON: ") +
-                    rapidjson::GetParseError_En(_document.GetParseError()));
+    }
+
+    // only loads the NameValuePairs selected by 'fieldMask'
+    JsonInputArchive(InputStream& stream, FieldMask fieldMask)
+            : JsonInputArchive(&_document, nullptr, std::move(fieldMask))
+    {
+        parse(stream);
+    }
+
+    // records the first error in 'error' instead of throwing an exception,
+    // everything following the error is skipped
+    JsonInputArchive(InputStream& stream, LoadError& error, FieldMask fieldMask = FieldMask())
+            : JsonInputArchive(&_document, &error, std::move(fieldMask))
+    {
+        parse(stream);
+    }
+
+    // reads from an already parsed value, e.g. the payload of an envelope, without parsing again
+    // the document owning 'value' has to outlive the archive
+    explicit JsonInputArchive(const rapidjson::Value& value, FieldMask fieldMask = FieldMask())
+            : JsonInputArchive(&value, nullptr, std::move(fieldMask))
+    {
+    }
+
+    JsonInputArchive(const rapidjson::Value& value,
+                     LoadError& error,
+                     FieldMask fieldMask = FieldMask())
+            : JsonInputArchive(&value, &error, std::move(fieldMask))
+    {
+    }
+
+    // the root points into the archive's own document when it has parsed a stream
+    JsonInputArchive(const JsonInputArchive&) = delete;
+    JsonInputArchive& operator=(const JsonInputArchive&) = delete;
+
+    // throws the exception matching 'code' unless errors are recorded
+    void reportError(LoadError::Code code, std::string message) const
+    {
+        if (_error == nullptr) {
+            detail::throwLoadError(code, message);
+        }
+        _error->set(code, std::move(message));
+    }
+
+    bool recordsErrors() const
+    {
+        return _error != nullptr;
+    }
+
+    bool hasError() const
+    {
+        return _error != nullptr && *_error;
+    }
+
+    // while loading, 'resource' is the current memory resource: it is used for shared_ptrs and for
+    // default constructed ResourceAllocators, e.g. the ones of ResourceString and ResourceVector
+    // nullptr keeps the current resource of the calling thread
+    void setMemoryResource(MemoryResource* resource)
+    {
+        _memoryResource = resource;
+    }
+
+    MemoryResource* getMemoryResource() const
+    {
+        return _memoryResource;
+    }
+
+    template <typename... Ts>
+    void operator()(Ts&&... args)
+    {
+        if (_memoryResource == nullptr || detail::currentMemoryResource() == _memoryResource) {
+            Parent::operator()(std::forward<Ts>(args)...);
+        } else {
+            ScopedMemoryResource scopedMemoryResource(_memoryResource);
+            Parent::operator()(std::forward<Ts>(args)...);
         }
-        _stack.push(&_document);
     }
 
     void setNextKey(const std::string& nextKey)
@@ -107,13 +182,72 @@ public:
         this->_nextIndexValid = true;
     }
 
+    // calls 'loadRow' for the rows [0, size) until an error is recorded, while it runs the values
+    // of the current object are looked up at index "row" of the member arrays; the previous row
+    // is restored afterwards, also if 'loadRow' throws
+    template <typename LoadRow>
+    void forEachRow(std::uint64_t size, LoadRow&& loadRow)
+    {
+        const muesli::detail::ScopedAssignment<std::size_t> rowDepth(_rowDepth, _stack.size());
+        const muesli::detail::ScopedAssignment<std::size_t> row(_row, 0);
+        for (; _row < size && !hasError(); ++_row) {
+            loadRow();
+        }
+    }
+
+    // reports an error unless every member array of the current object holds 'size' rows, which
+    // bounds the size of a columnar container by the input
+    bool checkColumnSizes(std::uint64_t size) const
+    {
+        const Value& columns = *_stack.top();
+        if (!columns.IsObject()) {
+            reportError(LoadError::Code::InvalidValue, "Cannot read columns.");
+            return false;
+        }
+        for (auto it = columns.MemberBegin(); it != columns.MemberEnd(); ++it) {
+            if (std::strcmp(it->name.GetString(), "_size") == 0) {
+                continue;
+            }
+            if (!it->value.IsArray() || it->value.Size() != size) {
+                reportError(LoadError::Code::ValueNotFound,
+                            "Column \"" + std::string(it->name.GetString()) + "\" does not have " +
+                                    std::to_string(size) + " rows.");
+                return false;
+            }
+        }
+        return true;
+    }
+
+    // the part of the field mask which applies below the current field
+    FieldMask getCurrentFieldMask() const
+    {
+        return _fieldMask.getSubmask(_currentField);
+    }
+
+    // unless the field mask excludes the field 'name', calls 'loadField' with 'name' as current
+    // field and returns true; the previous field is restored afterwards, also if 'loadField' throws
+    template <typename LoadField>
+    bool loadField(const char* name, LoadField&& loadField)
+    {
+        std::size_t field = _currentField;
+        if (!_fieldMask.selectField(field, name)) {
+            return false;
+        }
+        const muesli::detail::ScopedAssignment<std::size_t> currentField(_currentField, field);
+        loadField();
+        return true;
+    }
+
     void readValue(bool& boolValue)
     {
         const Value* nextValue = getNextValue(true);
+        if (nextValue == nullptr) {
+            return;
+        }
         if (nextValue->IsBool()) {
             boolValue = nextValue->GetBool();
         } else {
-            throw std::invalid_argument("Cannot read a Bool.");
+            reportError(LoadError::Code::InvalidValue, "Cannot read a Bool.");
         }
     }
 
@@ -128,6 +262,9 @@ public:
     std::enable_if_t<std::is_arithmetic<T>::value> readValue(T& value)
     {
         const Value* nextValue = getNextValue(true);
+        if (nextValue == nullptr) {
+            return;
+        }
         if (!nextValue->IsNull()) {
             readArithmeticValue(value, nextValue);
         } else {
@@ -140,7 +277,7 @@ public:
         if (value->IsDouble() || value->IsInt()) {
             doubleValue = value->GetDouble();
         } else {
-            throw std::invalid_argument("Cannot read a Double.");
+            reportError(LoadError::Code::InvalidValue, "Cannot read a Double.");
         }
     }
 
@@ -159,7 +296,7 @@ public:
         if (value->IsInt()) {
             intValue = value->GetInt();
         } else {
-            throw std::invalid_argument("Cannot read an Int.");
+            reportError(LoadError::Code::InvalidValue, "Cannot read an Int.");
         }
     }
 
@@ -171,7 +308,7 @@ public:
         if (value->IsUint()) {
             intValue = value->GetUint();
         } else {
-            throw std::invalid_argument("Cannot read an Uint.");
+            reportError(LoadError::Code::InvalidValue, "Cannot read an Uint.");
         }
     }
 
@@ -180,7 +317,7 @@ public:
         if (value->IsInt64()) {
             int64Value = value->GetInt64();
         } else {
-            throw std::invalid_argument("Cannot read an Int64.");
+            reportError(LoadError::Code::InvalidValue, "Cannot read an Int64.");
         }
     }
 
@@ -189,20 +326,67 @@ public:
         if (value->IsUint64()) {
             uint64Value = value->GetUint64();
         } else {
-            throw std::invalid_argument("Cannot read an UInt64.");
+            reportError(LoadError::Code::InvalidValue, "Cannot read an UInt64.");
         }
     }
 
     void readValue(std::string& stringValue) const
     {
         const Value* nextValue = getNextValue(true);
+        if (nextValue == nullptr) {
+            return;
+        }
         if (nextValue->IsString()) {
             stringValue = nextValue->GetString();
         } else {
-            throw std::invalid_argument("Cannot read a String.");
+            reportError(LoadError::Code::InvalidValue, "Cannot read a String.");
         }
     }
 
+    // strings with other allocators, e.g. ResourceString
+    template <typename Traits, typename Allocator>
+    void readValue(std::basic_string<char, Traits, Allocator>& stringValue) const
+    {
+        const Value* nextValue = getNextValue(true);
+        if (nextValue == nullptr) {
+            return;
+        }
+        if (nextValue->IsString()) {
+            stringValue.assign(nextValue->GetString(), nextValue->GetStringLength());
+        } else {
+            reportError(LoadError::Code::InvalidValue, "Cannot read a String.");
+        }
+    }
+
+    // like readValue, but without copying the string
+    void validateString() const
+    {
+        const Value* nextValue = getNextValue(true);
+        if (nextValue != nullptr && !nextValue->IsString()) {
+            reportError(LoadError::Code::InvalidValue, "Cannot read a String.");
+        }
+    }
+
+    // serializes the next value back into compact JSON
+    void readRawValue(std::string& json) const
+    {
+        const Value* nextValue = getNextValue(true);
+        if (nextValue == nullptr || _validating) {
+            return;
+        }
+        rapidjson::StringBuffer buffer;
+        rapidjson::Writer<rapidjson::StringBuffer> writer(buffer);
+        nextValue->Accept(writer);
+        json.assign(buffer.GetString(), buffer.GetSize());
+    }
+
+    // the current value, which is only valid as long as the archive's document; nullptr after
+    // reporting that the value is missing, or if an error has been recorded before
+    const rapidjson::Value* readJsonValue() const
+    {
+        return getNextValue(true);
+    }
+
     std::size_t getArraySize() const
     {
         assert(currentValueIsArray());
@@ -234,26 +418,49 @@ public:
             return;
         }
         const Value* nextValue = getNextValue(true);
-        if (!nextValue->IsNull()) {
-            _stack.push(nextValue);
-        } else {
-            throw exceptions::ValueNotFoundException(
-                    "Could not find a value for a not nullable object.");
+        if (nextValue != nullptr && nextValue->IsNull()) {
+            reportError(LoadError::Code::ValueNotFound,
+                        "Could not find a value for a not nullable object.");
+            nextValue = nullptr;
         }
+        // after an error the current value is pushed again, so that popNode stays balanced
+        _stack.push(nextValue != nullptr ? nextValue : _stack.top());
+        resetNextPosition();
     }
 
     void pushNullableNode()
     {
         _stack.push(getNextValue());
+        resetNextPosition();
     }
 
     void popNode()
     {
         _stack.pop();
-        _nextKeyValid = false;
-        _nextIndexValid = false;
+        resetNextPosition();
     }
 
+    // saves the stack of visited values and restores it at the end of the scope
+    class ScopedState
+    {
+    public:
+        explicit ScopedState(JsonInputArchive& archive) : _archive(archive)
+        {
+            _archive.pushState();
+        }
+
+        ~ScopedState()
+        {
+            _archive.popState();
+        }
+
+        ScopedState(const ScopedState&) = delete;
+        ScopedState& operator=(const ScopedState&) = delete;
+
+    private:
+        JsonInputArchive& _archive;
+    };
+
     void pushState()
     {
         _stateHistoryStack.push(_stack);
@@ -273,27 +480,162 @@ public:
         return _stack.top() == nullptr || _stack.top()->IsNull();
     }
 
+    // true if the current object has a member for the next key
+    bool hasNextValue() const
+    {
+        return _stack.top()->IsObject() && _nextKeyValid &&
+               _stack.top()->FindMember(_nextKey) != _stack.top()->MemberEnd();
+    }
+
+    // checks that the input can be loaded as T and reports the error a load would report at the
+    // first mismatch; loaded strings are not copied and containers do not keep their elements,
+    // but T itself is default constructed and pointers are allocated as in a load, polymorphic
+    // ones through the type registry
+    template <typename T>
+    void validate()
+    {
+        T value;
+        const muesli::detail::ScopedAssignment<bool> validating(_validating, true);
+        (*this)(value);
+    }
+
+    bool isValidating() const
+    {
+        return _validating;
+    }
+
+    // loads into the existing 'value': elements of vectors, values of maps and optionals which
+    // exist already are loaded in place and keep their allocations, vectors only grow or shrink
+    // at the tail
+    template <typename T>
+    void reload(T& value)
+    {
+        const muesli::detail::ScopedAssignment<bool> reloading(_reloading, true);
+        (*this)(value);
+    }
+
+    bool isReloading() const
+    {
+        return _reloading;
+    }
+
+    // loads 'value' from the value referenced by an RFC 6901 JSON pointer, e.g. "/header/id",
+    // which is resolved from the root value of the archive
+    template <typename T>
+    void loadAt(const std::string& pointer, T& value)
+    {
+        const Value* target = _root;
+        for (const std::string& token : json::detail::parseJsonPointer(pointer)) {
+            target = findChild(*target, token);
+            if (target == nullptr) {
+                reportError(LoadError::Code::ValueNotFound,
+                            "Could not find value for JSON pointer \"" + pointer + "\".");
+                return;
+            }
+        }
+        const ScopedState scopedState(*this);
+        const muesli::detail::ScopedAssignment<bool> notRoot(_isRoot, false);
+        _stack.push(target);
+        resetNextPosition();
+        (*this)(value);
+    }
+
 private:
-    const Value* getNextValue(bool throwOnNotFound = false) const
+    JsonInputArchive(const Value* root, LoadError* error, FieldMask fieldMask)
+            : Parent(this),
+              _document(),
+              _root(root),
+              _nextKey(),
+              _nextKeyValid(false),
+              _nextIndex(0),
+              _nextIndexValid(false),
+              _stack(),
+              _stateHistoryStack(),
+              _isRoot(true),
+              _row(0),
+              _rowDepth(0),
+              _fieldMask(std::move(fieldMask)),
+              _currentField(_fieldMask.getRoot()),
+              _validating(false),
+              _reloading(false),
+              _error(error),
+              _memoryResource(nullptr)
+    {
+        _stack.push(_root);
+    }
+
+    void parse(InputStream& stream)
+    {
+        using AdaptedStream = json::detail::RapidJsonInputStreamAdapter<InputStream>;
+        AdaptedStream adaptedStream(stream);
+        _document.ParseStream<0>(adaptedStream);
+        if (_document.HasParseError()) {
+            reportError(LoadError::Code::Parse,
+                        std::string("could not parse JSON: ") +
+                                rapidjson::GetParseError_En(_document.GetParseError()));
+        }
+    }
+
+    static const Value* findChild(const Value& parent, const std::string& token)
+    {
+        if (parent.IsObject()) {
+            Value::ConstMemberIterator it = parent.FindMember(token);
+            return it != parent.MemberEnd() ? &(it->value) : nullptr;
+        }
+        std::size_t index = 0;
+        if (parent.IsArray() && json::detail::parseArrayIndex(token, index) &&
+            index < parent.Size()) {
+            return &parent[static_cast<rapidjson::SizeType>(index)];
+        }
+        return nullptr;
+    }
+
+    // the key or index has been used to navigate into the value
+    void resetNextPosition()
     {
+        _nextKeyValid = false;
+        _nextIndexValid = false;
+    }
+
+    // returns nullptr if there is no value or if an error has been recorded before
+    const Value* getNextValue(bool required = false) const
+    {
+        if (hasError()) {
+            return nullptr;
+        }
         if (_stack.top()->IsArray() && _nextIndexValid) {
             return &(_stack.top()->operator[](_nextIndex));
         } else if (_stack.top()->IsObject() && _nextKeyValid) {
             Value::ConstMemberIterator it = _stack.top()->FindMember(_nextKey);
             if (it != _stack.top()->MemberEnd()) {
+                if (_rowDepth == _stack.size()) {
+                    return getRowValue(it->value);
+                }
                 return &(it->value);
             }
-            if (throwOnNotFound) {
-                throw exceptions::ValueNotFoundException("Could not find value for key \"" +
-                                                         _nextKey + "\".");
+            if (required) {
+                reportError(LoadError::Code::ValueNotFound,
+                            "Could not find value for key \"" + _nextKey + "\".");
             }
             return nullptr;
         }
         return _stack.top();
     }
 
+    const Value* getRowValue(const Value& column) const
+    {
+        if (!column.IsArray() || _row >= column.Size()) {
+            reportError(LoadError::Code::ValueNotFound,
+                        "Could not find row " + std::to_string(_row) + " for key \"" + _nextKey +
+                                "\".");
+            return nullptr;
+        }
+        return &column[static_cast<rapidjson::SizeType>(_row)];
+    }
+
 private:
     rapidjson::Document _document;
+    const Value* _root;
     std::string _nextKey;
     bool _nextKeyValid;
     std::size_t _nextIndex;
@@ -302,6 +644,14 @@ private:
     ValueStack _stack;
     std::stack<ValueStack> _stateHistoryStack;
     bool _isRoot;
+    std::size_t _row;
+    std::size_t _rowDepth;
+    FieldMask _fieldMask;
+    std::size_t _currentField;
+    bool _validating;
+    bool _reloading;
+    LoadError* _error;
+    MemoryResource* _memoryResource;
 };
 
 namespace detail
@@ -322,45 +672,108 @@ void loadTuple(JsonInputArchive<InputStream>& archive,
 }
 
 template <typename T>
-std::enable_if_t<!std::is_enum<T>::value && !std::is_same<T, std::string>::value> stringToType(
-        const std::string& string,
-        T& type)
+std::enable_if_t<json::detail::IsArray<T>::value> reserveArray(T& array, std::size_t size)
 {
-    type = boost::lexical_cast<T>(string);
+    array.reserve(size);
 }
 
 template <typename T>
-std::enable_if_t<std::is_same<T, std::string>::value> stringToType(const std::string& string,
-                                                                   T& type)
+void reserveArray(std::set<T>& array, std::size_t size)
 {
-    type = string;
+    std::ignore = array;
+    std::ignore = size;
 }
 
-template <typename Enum, typename Wrapper = typename EnumTraits<Enum>::Wrapper>
-std::enable_if_t<std::is_enum<Enum>::value> stringToType(const std::string& literal,
-                                                         Enum& enumValue)
+template <typename... Ts>
+void reserveArray(boost::multi_index_container<Ts...>& array, std::size_t size)
 {
-    enumValue = Wrapper::getEnum(literal);
+    std::ignore = array;
+    std::ignore = size;
 }
 
-template <typename T>
-std::enable_if_t<json::detail::IsArray<T>::value> reserveArray(T& array, std::size_t size)
+// loads the elements of 'array' in place, returns false if the container does not support it
+template <typename InputStream, typename T>
+bool reloadArray(JsonInputArchive<InputStream>& archive, T& array, std::size_t size)
 {
-    array.reserve(size);
+    std::ignore = archive;
+    std::ignore = array;
+    std::ignore = size;
+    return false;
 }
 
-template <typename T>
-void reserveArray(std::set<T>& array, std::size_t size)
+template <typename InputStream, typename T, typename Allocator>
+bool reloadArray(JsonInputArchive<InputStream>& archive,
+                 std::vector<T, Allocator>& array,
+                 std::size_t size)
 {
-    std::ignore = array;
-    std::ignore = size;
+    array.resize(size);
+    for (std::size_t i = 0; i < size; i++) {
+        archive.setNextIndex(i);
+        archive(array[i]);
+    }
+    return true;
 }
 
-template <typename... Ts>
-void reserveArray(boost::multi_index_container<Ts...>& array, std::size_t size)
+template <typename InputStream, typename Allocator>
+bool reloadArray(JsonInputArchive<InputStream>& archive,
+                 std::vector<bool, Allocator>& array,
+                 std::size_t size)
 {
+    std::ignore = archive;
     std::ignore = array;
     std::ignore = size;
+    return false;
+}
+
+// converts the key of a map entry, returns false if an error has been recorded instead
+template <typename InputStream, typename T>
+bool loadMapKey(JsonInputArchive<InputStream>& archive, const std::string& keyString, T& key)
+{
+    if (!archive.recordsErrors()) {
+        stringToType(keyString, key);
+    } else if (!tryStringToType(keyString, key)) {
+        archive.reportError(LoadError::Code::InvalidValue,
+                            "Cannot convert map key \"" + keyString + "\".");
+        return false;
+    }
+    return true;
+}
+
+// loads the values of entries which exist already in place, entries missing in the input are
+// removed
+template <typename InputStream, typename Map>
+void reloadMap(JsonInputArchive<InputStream>& archive, Map& map)
+{
+    using T = typename Map::key_type;
+    using V = typename Map::mapped_type;
+    for (auto entry = map.begin(); entry != map.end();) {
+        archive.setNextKey(toString(entry->first));
+        entry = archive.hasNextValue() ? std::next(entry) : map.erase(entry);
+    }
+    for (rapidjson::Document::ConstMemberIterator itr = archive.getMemberBegin();
+         itr != archive.getMemberEnd();
+         ++itr) {
+
+        std::string keyString(itr->name.GetString());
+        if (keyString == "_typeName") {
+            continue;
+        }
+
+        T key;
+        if (!loadMapKey(archive, keyString, key)) {
+            return;
+        }
+        auto entry = map.find(key);
+        if (entry == map.end()) {
+            entry = map.insert(map.end(), typename Map::value_type(std::move(key), V()));
+        }
+
+        archive.setNextKey(std::move(keyString));
+        archive(entry->second);
+        if (archive.hasError()) {
+            return;
+        }
+    }
 }
 
 } // namespace detail
@@ -426,8 +839,22 @@ std::enable_if_t<json::detail::IsArray<T>::value> load(JsonInputArchive<InputStr
                                                        T& array)
 {
     using ValueType = typename T::value_type;
+    if (archive.hasError()) {
+        return;
+    }
     if (archive.currentValueIsArray()) {
         std::size_t arraySize = archive.getArraySize();
+        if (archive.isReloading() && detail::reloadArray(archive, array, arraySize)) {
+            return;
+        }
+        if (archive.isValidating()) {
+            ValueType entry;
+            for (std::size_t i = 0; i < arraySize; i++) {
+                archive.setNextIndex(i);
+                archive(entry);
+            }
+            return;
+        }
         array.clear();
         detail::reserveArray(array, arraySize);
         auto inserter = std::inserter(array, array.begin());
@@ -438,7 +865,7 @@ std::enable_if_t<json::detail::IsArray<T>::value> load(JsonInputArchive<InputStr
             inserter = std::move(entry);
         }
     } else {
-        throw std::invalid_argument("Cannot read an array.");
+        archive.reportError(LoadError::Code::InvalidValue, "Cannot read an array.");
     }
 }
 
@@ -448,6 +875,14 @@ std::enable_if_t<json::detail::IsMap<Map>::value> load(JsonInputArchive<InputStr
 {
     using T = typename Map::key_type;
     using V = typename Map::mapped_type;
+    if (archive.hasError()) {
+        map.clear();
+        return;
+    }
+    if (archive.isReloading()) {
+        detail::reloadMap(archive, map);
+        return;
+    }
     map.clear();
     for (rapidjson::Document::ConstMemberIterator itr = archive.getMemberBegin();
          itr != archive.getMemberEnd();
@@ -459,37 +894,111 @@ std::enable_if_t<json::detail::IsMap<Map>::value> load(JsonInputArchive<InputStr
         }
 
         T key;
-        detail::stringToType(keyString, key);
+        if (!detail::loadMapKey(archive, keyString, key)) {
+            return;
+        }
 
         archive.setNextKey(std::move(keyString));
         V value;
         archive(value);
-        map.insert({std::move(key), std::move(value)});
+        if (archive.hasError()) {
+            return;
+        }
+        if (!archive.isValidating()) {
+            map.insert({std::move(key), std::move(value)});
+        }
     }
 }
 
 template <typename InputStream, typename T>
 void load(JsonInputArchive<InputStream>& archive, NameValuePair<T>& nameValuePair)
 {
-    archive.setNextKey(nameValuePair._name);
-    archive(nameValuePair._value);
+    archive.loadField(nameValuePair._name, [&archive, &nameValuePair]() {
+        archive.setNextKey(nameValuePair._name);
+        archive(nameValuePair._value);
+    });
+}
+
+template <typename InputStream, typename T, typename Default>
+void load(JsonInputArchive<InputStream>& archive,
+          NameValuePairWithDefault<T, Default>& nameValuePair)
+{
+    if (archive.hasError()) {
+        return;
+    }
+    archive.loadField(nameValuePair._name, [&archive, &nameValuePair]() {
+        archive.setNextKey(nameValuePair._name);
+        if (archive.hasNextValue()) {
+            archive(nameValuePair._value);
+        } else {
+            nameValuePair._value = nameValuePair._default;
+        }
+    });
+}
+
+template <typename InputStream>
+void load(JsonInputArchive<InputStream>& archive, std::string& value)
+{
+    if (archive.isValidating()) {
+        archive.validateString();
+    } else {
+        archive.readValue(value);
+    }
+}
+
+template <typename InputStream>
+void load(JsonInputArchive<InputStream>& archive, RawJson& rawJson)
+{
+    std::string json;
+    archive.readRawValue(json);
+    rawJson.setJson(std::move(json));
+}
+
+template <typename InputStream, typename Container>
+void load(JsonInputArchive<InputStream>& archive, Columnar<Container>& columnar)
+{
+    using ValueType = typename Container::value_type;
+    std::uint64_t size = 0;
+    archive.setNextKey("_size");
+    archive(size);
+    if (archive.hasError() || !archive.checkColumnSizes(size)) {
+        return;
+    }
+    Container& container = *columnar._wrapped;
+    if (!archive.isValidating()) {
+        container.clear();
+        detail::reserveArray(container, size);
+    }
+    auto inserter = std::inserter(container, container.begin());
+    archive.forEachRow(size, [&archive, &inserter]() {
+        ValueType entry;
+        archive(SkipIntroOutroWrapper<ValueType>(&entry));
+        if (!archive.isValidating()) {
+            inserter = std::move(entry);
+        }
+    });
 }
 
 template <typename InputStream, typename... Ts>
 void load(JsonInputArchive<InputStream>& archive, std::tuple<Ts...>& tuple)
 {
+    if (archive.hasError()) {
+        return;
+    }
     if (archive.currentValueIsArray()) {
         const std::size_t arraySize = archive.getArraySize();
 
         if (arraySize != sizeof...(Ts)) {
-            throw exceptions::ParseException(
-                    "Failed to load tuple. Persisted tuple size is " + std::to_string(arraySize) +
-                    ". Expected tuple size is " + std::to_string(sizeof...(Ts)));
+            archive.reportError(LoadError::Code::Parse,
+                                "Failed to load tuple. Persisted tuple size is " +
+                                        std::to_string(arraySize) + ". Expected tuple size is " +
+                                        std::to_string(sizeof...(Ts)));
+            return;
         }
 
         detail::loadTuple(archive, tuple, std::index_sequence_for<Ts...>{});
     } else {
-        throw std::invalid_argument("Cannot read a Tuple.");
+        archive.reportError(LoadError::Code::InvalidValue, "Cannot read a Tuple.");
     }
 }
 
@@ -509,102 +1018,151 @@ void load(JsonInputArchive<InputStream>& archive, Enum& value)
 {
     std::string enumStringValue;
     archive.readValue(enumStringValue);
-    value = Wrapper::getEnum(enumStringValue);
+    if (archive.hasError()) {
+        return;
+    }
+    if (!archive.recordsErrors()) {
+        value = Wrapper::getEnum(enumStringValue);
+    } else if (!detail::tryGetEnum<Wrapper>(enumStringValue, value)) {
+        archive.reportError(LoadError::Code::InvalidValue,
+                            "Unknown enum literal \"" + enumStringValue + "\".");
+    }
 }
 
 namespace detail
 {
 
-template <typename T, typename InputStream>
-std::unique_ptr<T> loadPointerDirectly(JsonInputArchive<InputStream>& archive)
+template <typename T, typename InputStream, typename Pointer>
+void loadPointerDirectly(JsonInputArchive<InputStream>& archive, Pointer& ptr)
 {
-    auto ptr = std::make_unique<T>();
-    archive(SkipIntroOutroWrapper<T>(ptr.get()));
-    return ptr;
+    auto loaded = makePointer<T>(ptr);
+    archive(SkipIntroOutroWrapper<T>(loaded.get()));
+    ptr = std::move(loaded);
 }
 
-template <typename Base, typename InputStream>
-std::unique_ptr<Base> loadPolymorphicPointerThroughRegistry(JsonInputArchive<InputStream>& archive,
-                                                            const std::string& typeName)
+template <typename Base, typename InputStream, typename Pointer>
+void loadPolymorphicPointerThroughRegistry(JsonInputArchive<InputStream>& archive,
+                                           const std::string& typeName,
+                                           Pointer& ptr)
 {
     using DecayedBase = std::decay_t<Base>;
     // lookup in type registry
     using TypeRegistry = muesli::TypeLoadRegistry<DecayedBase, JsonInputArchive<InputStream>>;
-    using LoadFunction = typename TypeRegistry::LoadFunction;
-    boost::optional<LoadFunction> loadFunction = TypeRegistry::getLoadFunction(typeName);
+    auto loadFunction = getRegisteredLoadFunction<TypeRegistry>(typeName, ptr);
     if (loadFunction) {
-        return (*loadFunction)(archive);
+        ptr = (*loadFunction)(archive);
     } else {
-        throw exceptions::UnknownTypeException(
-                std::string("could not find input serializer for " +
-                            boost::typeindex::type_id<DecayedBase>().pretty_name()));
+        ptr = nullptr;
+        archive.reportError(LoadError::Code::UnknownType,
+                            std::string("could not find input serializer for " +
+                                        boost::typeindex::type_id<DecayedBase>().pretty_name()));
     }
 }
 
+// in reload mode an existing pointee is loaded in place if its dynamic type is 'typeName'
+template <typename Base, typename InputStream, typename Pointer>
+bool reloadPolymorphicPointee(JsonInputArchive<InputStream>& archive,
+                              const std::string& typeName,
+                              Pointer& ptr)
+{
+    if (!ptr || !archive.isReloading()) {
+        return false;
+    }
+    using DecayedBase = std::decay_t<Base>;
+    using TypeRegistry = muesli::TypeLoadRegistry<DecayedBase, JsonInputArchive<InputStream>>;
+    auto loadFunction = TypeRegistry::getInPlaceLoadFunction(typeid(*ptr), typeName);
+    if (!loadFunction) {
+        return false;
+    }
+    (*loadFunction)(archive, ptr.get());
+    return true;
+}
+
 // generic de-serialization for non-polymorphic pointer types
-template <typename T, typename InputStream>
-std::enable_if_t<!std::is_polymorphic<T>::value, std::unique_ptr<T>> loadPointer(
-        JsonInputArchive<InputStream>& archive)
+template <typename T, typename InputStream, typename Pointer>
+std::enable_if_t<!std::is_polymorphic<T>::value> loadPointer(
+        JsonInputArchive<InputStream>& archive,
+        Pointer& ptr)
 {
     if (archive.currentValueIsNull()) {
-        return nullptr;
+        ptr = nullptr;
+    } else if (ptr && archive.isReloading()) {
+        archive(SkipIntroOutroWrapper<T>(ptr.get()));
+    } else {
+        loadPointerDirectly<T>(archive, ptr);
     }
-    return loadPointerDirectly<T>(archive);
 }
 
-template <typename InputStream>
+// an object of a non-abstract static type may have been written without _typeName, see
+// JsonOutputArchive::setWritePolymorphicTypeNamesOnly()
+template <typename Base, typename InputStream>
 std::string getTypeNameForPointer(JsonInputArchive<InputStream>& archive)
 {
     archive.setNextKey("_typeName");
+    if (!std::is_abstract<Base>::value && !archive.hasNextValue()) {
+        return RegisteredType<std::decay_t<Base>>::name();
+    }
     std::string typeName;
     archive.readValue(typeName);
     return typeName;
 }
 
 // generic de-serialization for polymorphic, non-abstract pointer types
-template <typename Base, typename InputStream>
-std::enable_if_t<std::is_polymorphic<Base>::value && !std::is_abstract<Base>::value,
-                 std::unique_ptr<Base>>
-loadPointer(JsonInputArchive<InputStream>& archive)
+template <typename Base, typename InputStream, typename Pointer>
+std::enable_if_t<std::is_polymorphic<Base>::value && !std::is_abstract<Base>::value> loadPointer(
+        JsonInputArchive<InputStream>& archive,
+        Pointer& ptr)
 {
     if (archive.currentValueIsNull()) {
-        return nullptr;
+        ptr = nullptr;
+        return;
     }
-    static const std::string baseTypeName = RegisteredType<std::decay_t<Base>>::name();
-    std::string typeName = getTypeNameForPointer(archive);
-    if (baseTypeName == typeName) {
-        return loadPointerDirectly<Base>(archive);
-    } else {
-        return loadPolymorphicPointerThroughRegistry<Base>(archive, typeName);
+    std::string typeName = getTypeNameForPointer<Base>(archive);
+    if (archive.hasError()) {
+        ptr = nullptr;
+    } else if (isRegisteredAs<std::decay_t<Base>>(typeName)) {
+        if (ptr && archive.isReloading() && typeid(*ptr) == typeid(Base)) {
+            archive(SkipIntroOutroWrapper<Base>(ptr.get()));
+        } else {
+            loadPointerDirectly<Base>(archive, ptr);
+        }
+    } else if (!reloadPolymorphicPointee<Base>(archive, typeName, ptr)) {
+        loadPolymorphicPointerThroughRegistry<Base>(archive, typeName, ptr);
     }
 }
 
 // generic de-serialization for polymorphic abstract pointer types
-template <typename Base, typename InputStream>
-std::enable_if_t<std::is_polymorphic<Base>::value && std::is_abstract<Base>::value,
-                 std::unique_ptr<Base>>
-loadPointer(JsonInputArchive<InputStream>& archive)
+template <typename Base, typename InputStream, typename Pointer>
+std::enable_if_t<std::is_polymorphic<Base>::value && std::is_abstract<Base>::value> loadPointer(
+        JsonInputArchive<InputStream>& archive,
+        Pointer& ptr)
 {
     if (archive.currentValueIsNull()) {
-        return nullptr;
+        ptr = nullptr;
+        return;
+    }
+    std::string typeName = getTypeNameForPointer<Base>(archive);
+    if (archive.hasError()) {
+        ptr = nullptr;
+    } else if (!reloadPolymorphicPointee<Base>(archive, typeName, ptr)) {
+        loadPolymorphicPointerThroughRegistry<Base>(archive, typeName, ptr);
     }
-    return loadPolymorphicPointerThroughRegistry<Base>(archive, getTypeNameForPointer(archive));
 }
 
 } // namespace detail
 
+// shared_ptrs are created by make_shared, in reload mode an existing pointee is loaded in place,
+// which is observed by all of its owners
 template <typename InputStream, typename T>
 void load(JsonInputArchive<InputStream>& archive, std::shared_ptr<T>& ptr)
 {
-    // forward to raw pointer implementation
-    ptr = detail::loadPointer<T>(archive);
+    detail::loadPointer<T>(archive, ptr);
 }
 
 template <typename InputStream, typename T>
 void load(JsonInputArchive<InputStream>& archive, std::unique_ptr<T>& ptr)
 {
-    // forward to raw pointer implementation
-    ptr = detail::loadPointer<T>(archive);
+    detail::loadPointer<T>(archive, ptr);
 }
 
 template <typename InputStream, typename T>
@@ -612,6 +1170,8 @@ void load(JsonInputArchive<InputStream>& archive, boost::optional<T>& opt)
 {
     if (archive.currentValueIsNull()) {
         opt = boost::none;
+    } else if (opt && archive.isReloading()) {
+        archive(SkipIntroOutroWrapper<T>(opt.get_ptr()));
     } else {
         T wrapped;
         archive(SkipIntroOutroWrapper<T>(&wrapped));
@@ -622,5 +1182,6 @@ void load(JsonInputArchive<InputStream>& archive, boost::optional<T>& opt)
 } // namespace muesli
 
 MUESLI_REGISTER_INPUT_ARCHIVE(muesli::JsonInputArchive, muesli::tags::json)
+MUESLI_REGISTER_EVENT_READER(muesli::json::detail::JsonEventReader, muesli::tags::json)
 
 #endif // MUESLI_ARCHIVES_JSON_JSONINPUTARCHIVE_H_
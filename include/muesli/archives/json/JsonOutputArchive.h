@@ -27,32 +27,54 @@
 #include <type_traits>
 #include <utility>
 
-#include <boost/lexical_cast.hpp>
 #include <boost/optional.hpp>
 #include <boost/type_index.hpp>
 
 #ifndef RAPIDJSON_HAS_STDSTRING
 #define RAPIDJSON_HAS_STDSTRING 1
+#include <rapidjson/rapidjson.h>
 #include <rapidjson/writer.h>
 #undef RAPIDJSON_HAS_STDSTRING
 #else
+#include <rapidjson/rapidjson.h>
 #include <rapidjson/writer.h>
 #endif // RAPIDJSON_HAS_STDSTRING
 
 #include "muesli/ArchiveRegistry.h"
 #include "muesli/BaseArchive.h"
+#include "muesli/Columnar.h"
+#include "muesli/EventRegistry.h"
 #include "muesli/NameValuePair.h"
+#include "muesli/NameValuePairWithDefault.h"
 #include "muesli/Traits.h"
 #include "muesli/TypeRegistryFwd.h"
+#include "muesli/detail/ColumnCollector.h"
+#include "muesli/detail/MapKeyConversion.h"
 #include "muesli/exceptions/UnknownTypeException.h"
 
+#include "muesli/archives/json/RawJson.h"
 #include "muesli/archives/json/Tag.h"
+#include "muesli/archives/json/detail/JsonEventWriter.h"
 #include "muesli/archives/json/detail/RapidJsonOutputStreamAdapter.h"
 #include "muesli/archives/json/detail/traits.h"
 
 namespace muesli
 {
 
+namespace json
+{
+namespace detail
+{
+// adapter wrapping the OutputStream and writer which JsonOutputArchive<OutputStream> writes to
+template <typename OutputStream>
+struct JsonWriterTraits
+{
+    using AdaptedStream = RapidJsonOutputStreamAdapter<OutputStream>;
+    using Writer = rapidjson::Writer<AdaptedStream>;
+};
+} // namespace detail
+} // namespace json
+
 template <typename OutputStream>
 class JsonOutputArchive
         : public muesli::BaseArchive<muesli::tags::OutputArchive, JsonOutputArchive<OutputStream>>
@@ -62,8 +84,50 @@ class JsonOutputArchive
 
 public:
     explicit JsonOutputArchive(OutputStream& stream)
-            : Parent(this), _outputStream(stream), _writer(_outputStream)
+            : Parent(this),
+              _outputStream(stream),
+              _writer(_outputStream),
+              _writeTypeAliases(false),
+              _writePolymorphicTypeNamesOnly(false),
+              _typeNameRequested(false)
+    {
+    }
+
+    // writes the registered alias as _typeName for types registered with one
+    void setWriteTypeAliases(bool writeTypeAliases)
     {
+        _writeTypeAliases = writeTypeAliases;
+    }
+
+    bool writesTypeAliases() const
+    {
+        return _writeTypeAliases;
+    }
+
+    // writes _typeName only where loading needs it to select the dynamic type, i.e. for objects
+    // saved through a polymorphic pointer whose static type differs from the dynamic type
+    void setWritePolymorphicTypeNamesOnly(bool writePolymorphicTypeNamesOnly)
+    {
+        _writePolymorphicTypeNamesOnly = writePolymorphicTypeNamesOnly;
+    }
+
+    bool writesPolymorphicTypeNamesOnly() const
+    {
+        return _writePolymorphicTypeNamesOnly;
+    }
+
+    // the next object is saved as the dynamic type of a polymorphic pointer
+    void requestTypeName()
+    {
+        _typeNameRequested = true;
+    }
+
+    // true if the object being saved gets a _typeName, a pending request is consumed
+    bool consumeTypeNameRequest()
+    {
+        const bool requested = _typeNameRequested;
+        _typeNameRequested = false;
+        return requested || !_writePolymorphicTypeNamesOnly;
     }
 
     void writeKey(const std::string& key)
@@ -125,17 +189,44 @@ public:
         _writer.String(stringValue);
     }
 
+    // strings with other allocators, e.g. ResourceString
+    template <typename Traits, typename Allocator>
+    void writeValue(const std::basic_string<char, Traits, Allocator>& stringValue)
+    {
+        _writer.String(stringValue.data(), static_cast<rapidjson::SizeType>(stringValue.size()));
+    }
+
     void writeValue(const char* value)
     {
         _writer.String(value);
     }
 
+    void writeValue(const char* value, std::size_t length)
+    {
+        _writer.String(value, static_cast<rapidjson::SizeType>(length));
+    }
+
     void writeValue(const std::nullptr_t& value)
     {
         std::ignore = value;
         _writer.Null();
     }
 
+    // writes already serialized JSON without validating it
+    void writeRawValue(const std::string& json)
+    {
+        if (json.empty()) {
+            _writer.Null();
+            return;
+        }
+        _writer.RawValue(json.data(), json.size(), getRawValueType(json.front()));
+    }
+
+    void writeJsonValue(const rapidjson::Value& value)
+    {
+        value.Accept(_writer);
+    }
+
     void startObject()
     {
         _writer.StartObject();
@@ -157,9 +248,32 @@ public:
     }
 
 private:
-    using AdaptedStream = json::detail::RapidJsonOutputStreamAdapter<OutputStream>;
-    AdaptedStream _outputStream;
-    rapidjson::Writer<AdaptedStream> _writer;
+    static rapidjson::Type getRawValueType(char firstCharacter)
+    {
+        switch (firstCharacter) {
+        case '{':
+            return rapidjson::kObjectType;
+        case '[':
+            return rapidjson::kArrayType;
+        case '"':
+            return rapidjson::kStringType;
+        case 't':
+            return rapidjson::kTrueType;
+        case 'f':
+            return rapidjson::kFalseType;
+        case 'n':
+            return rapidjson::kNullType;
+        default:
+            return rapidjson::kNumberType;
+        }
+    }
+
+    using WriterTraits = json::detail::JsonWriterTraits<OutputStream>;
+    typename WriterTraits::AdaptedStream _outputStream;
+    typename WriterTraits::Writer _writer;
+    bool _writeTypeAliases;
+    bool _writePolymorphicTypeNamesOnly;
+    bool _typeNameRequested;
 };
 
 template <typename OutputStream, typename... Ts>
@@ -221,7 +335,14 @@ template <typename T, typename OutputStream>
 std::enable_if_t<json::detail::HasRegisteredTypeName<T>::value> writeTypeName(
         JsonOutputArchive<OutputStream>& archive)
 {
-    archive(muesli::make_nvp("_typeName", muesli::RegisteredType<T>::name()));
+    if (!archive.consumeTypeNameRequest()) {
+        return;
+    }
+    const char* typeName = muesli::RegisteredType<T>::name();
+    if (archive.writesTypeAliases() && RegisteredTypeAlias<T>::alias() != nullptr) {
+        typeName = RegisteredTypeAlias<T>::alias();
+    }
+    archive(muesli::make_nvp("_typeName", typeName));
 }
 
 template <typename T, typename OutputStream>
@@ -293,27 +414,6 @@ std::enable_if_t<json::detail::IsArray<T>::value> save(JsonOutputArchive<OutputS
     }
 }
 
-template <typename T>
-std::enable_if_t<std::is_same<std::string, T>::value, std::string> toString(const T& key)
-{
-    return key;
-}
-
-template <typename Enum, typename Wrapper = typename EnumTraits<Enum>::Wrapper>
-std::enable_if_t<std::is_enum<Enum>::value, std::string> toString(const Enum& key)
-{
-    return Wrapper::getLiteral(key);
-}
-
-template <typename T>
-std::enable_if_t<!std::is_same<std::string, T>::value && !std::is_enum<T>::value &&
-                         json::detail::IsPrimitive<T>::value,
-                 std::string>
-toString(const T& key)
-{
-    return boost::lexical_cast<std::string>(key);
-}
-
 template <typename OutputStream, typename Map>
 auto save(JsonOutputArchive<OutputStream>& archive, const Map& map)
         -> decltype(typename Map::mapped_type(), void())
@@ -330,6 +430,13 @@ void save(JsonOutputArchive<OutputStream>& archive, const NameValuePair<T>& name
     archive(nameValuePair._value);
 }
 
+template <typename OutputStream, typename T, typename Default>
+void save(JsonOutputArchive<OutputStream>& archive,
+          const NameValuePairWithDefault<T, Default>& nameValuePair)
+{
+    archive(make_nvp(nameValuePair._name, nameValuePair._value));
+}
+
 template <typename OutputStream, typename T>
 std::enable_if_t<json::detail::IsPrimitive<T>::value && !std::is_enum<T>::value> save(
         JsonOutputArchive<OutputStream>& archive,
@@ -347,6 +454,68 @@ void save(JsonOutputArchive<OutputStream>& archive, Enum value)
     archive.writeValue(Wrapper::getLiteral(value));
 }
 
+template <typename OutputStream>
+void save(JsonOutputArchive<OutputStream>& archive, const RawJson& rawJson)
+{
+    archive.writeRawValue(rawJson.getJson());
+}
+
+namespace detail
+{
+template <typename OutputStream>
+void saveColumnValues(JsonOutputArchive<OutputStream>& archive, const Column& column)
+{
+    switch (column._type) {
+    case Column::Type::Bool:
+        for (std::uint64_t value : column._unsignedIntegers) {
+            archive.writeValue(value != 0);
+        }
+        break;
+    case Column::Type::Integer:
+        for (std::int64_t value : column._integers) {
+            archive.writeValue(value);
+        }
+        break;
+    case Column::Type::UnsignedInteger:
+        for (std::uint64_t value : column._unsignedIntegers) {
+            archive.writeValue(value);
+        }
+        break;
+    case Column::Type::Double:
+        for (double value : column._doubles) {
+            archive.writeValue(value);
+        }
+        break;
+    case Column::Type::String: {
+        std::size_t begin = 0;
+        for (std::size_t end : column._stringEndOffsets) {
+            archive.writeValue(column._stringBlob.data() + begin, end - begin);
+            begin = end;
+        }
+        break;
+    }
+    }
+}
+} // namespace detail
+
+// containers wrapped by Columnar are written as an object holding the number of rows in "_size"
+// and one array per field
+template <typename OutputStream, typename Container>
+void save(JsonOutputArchive<OutputStream>& archive, const Columnar<Container>& columnar)
+{
+    detail::ColumnCollector collector;
+    for (const typename Container::value_type& row : *columnar._wrapped) {
+        collector.collectRow(row);
+    }
+    archive(muesli::make_nvp("_size", static_cast<std::uint64_t>(collector.getRowCount())));
+    for (const detail::Column& column : collector.getColumns()) {
+        archive.writeKey(column._name);
+        archive.startArray();
+        detail::saveColumnValues(archive, column);
+        archive.endArray();
+    }
+}
+
 namespace detail
 {
 
@@ -367,6 +536,7 @@ void savePolymorphicPointerThroughRegistry(JsonOutputArchive<OutputStream>& arch
     using SaveFunction = typename TypeRegistry::SaveFunction;
     boost::optional<SaveFunction> saveFunction = TypeRegistry::getSaveFunction(ptrInfo);
     if (saveFunction) {
+        archive.requestTypeName();
         (*saveFunction)(archive, ptr);
     } else {
         throw exceptions::UnknownTypeException(
@@ -439,5 +609,6 @@ void save(JsonOutputArchive<OutputStream>& archive, const boost::optional<T>& op
 } // namespace muesli
 
 MUESLI_REGISTER_OUTPUT_ARCHIVE(muesli::JsonOutputArchive, muesli::tags::json)
+MUESLI_REGISTER_EVENT_WRITER(muesli::json::detail::JsonEventWriter, muesli::tags::json)
 
 #endif // MUESLI_ARCHIVES_JSON_JSONOUTPUTARCHIVE_H_
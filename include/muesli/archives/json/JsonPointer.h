@@ -0,0 +1,55 @@
+/*
+ * #%L
+ * %%
+ * Copyright (C) 2011 - 2016 BMW Car IT GmbH
+ * %%
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ * 
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ * 
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ * #L%
+ */
+
+#ifndef MUESLI_ARCHIVES_JSON_JSONPOINTER_H_
+#define MUESLI_ARCHIVES_JSON_JSONPOINTER_H_
+
+#include <string>
+
+#include "muesli/detail/ThrowException.h"
+#include "muesli/exceptions/ValueNotFoundException.h"
+#include "muesli/streams/StringIStream.h"
+
+#include "muesli/archives/json/JsonInputArchive.h"
+#include "muesli/archives/json/detail/JsonPointer.h"
+
+namespace muesli
+{
+
+// loads 'value' from the value referenced by an RFC 6901 JSON pointer within 'json'
+// the values in front of it are skipped without being parsed, so only the referenced value is
+// turned into a document; use JsonInputArchive::loadAt to access several values
+template <typename T>
+void loadJsonAt(const std::string& json, const std::string& pointer, T& value)
+{
+    const char* valueBegin = nullptr;
+    const char* valueEnd = nullptr;
+    json::detail::JsonPointerScanner scanner(json.data(), json.data() + json.size());
+    if (!scanner.find(json::detail::parseJsonPointer(pointer), valueBegin, valueEnd)) {
+        muesli::detail::throwException(exceptions::ValueNotFoundException(
+                "Could not find value for JSON pointer \"" + pointer + "\"."));
+    }
+    muesli::StringIStream stream(std::string(valueBegin, valueEnd));
+    muesli::JsonInputArchive<muesli::StringIStream> jsonInputArchive(stream);
+    jsonInputArchive(value);
+}
+
+} // namespace muesli
+
+#endif // MUESLI_ARCHIVES_JSON_JSONPOINTER_H_
@@ -0,0 +1,252 @@
+/*
+ * #%L
+ * %%
+ * Copyright (C) 2011 - 2016 BMW Car IT GmbH
+ * %%
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ * 
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ * 
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ * #L%
+ */
+
+#ifndef MUESLI_ARCHIVES_JSON_JSONVALUEOUTPUTARCHIVE_H_
+#define MUESLI_ARCHIVES_JSON_JSONVALUEOUTPUTARCHIVE_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <tuple>
+#include <vector>
+
+#ifndef RAPIDJSON_HAS_STDSTRING
+#define RAPIDJSON_HAS_STDSTRING 1
+#include <rapidjson/document.h>
+#include <rapidjson/error/en.h>
+#undef RAPIDJSON_HAS_STDSTRING
+#else
+#include <rapidjson/document.h>
+#include <rapidjson/error/en.h>
+#endif // RAPIDJSON_HAS_STDSTRING
+
+#include "muesli/ArchiveRegistry.h"
+#include "muesli/exceptions/ParseException.h"
+
+#include "muesli/archives/json/JsonOutputArchive.h"
+
+namespace muesli
+{
+
+// target of a JsonValueOutputArchive: the value which is built and the allocator used for it,
+// usually a rapidjson::Document and its allocator
+class JsonValueOutput
+{
+public:
+    using Allocator = rapidjson::Value::AllocatorType;
+
+    JsonValueOutput(rapidjson::Value& value, Allocator& allocator)
+            : _value(value), _allocator(allocator)
+    {
+    }
+
+    rapidjson::Value& getValue() const
+    {
+        return _value;
+    }
+
+    Allocator& getAllocator() const
+    {
+        return _allocator;
+    }
+
+private:
+    rapidjson::Value& _value;
+    Allocator& _allocator;
+};
+
+namespace json
+{
+namespace detail
+{
+
+// implements the writer interface used by JsonOutputArchive by building a rapidjson::Value tree
+class JsonValueWriter
+{
+public:
+    explicit JsonValueWriter(JsonValueOutput& output)
+            : _target(output.getValue()),
+              _allocator(output.getAllocator()),
+              _containers(),
+              _key()
+    {
+    }
+
+    bool Null()
+    {
+        rapidjson::Value value;
+        add(value);
+        return true;
+    }
+
+    bool Bool(bool boolValue)
+    {
+        rapidjson::Value value(boolValue);
+        add(value);
+        return true;
+    }
+
+    bool Int(int intValue)
+    {
+        rapidjson::Value value(intValue);
+        add(value);
+        return true;
+    }
+
+    bool Uint(unsigned uintValue)
+    {
+        rapidjson::Value value(uintValue);
+        add(value);
+        return true;
+    }
+
+    bool Int64(std::int64_t int64Value)
+    {
+        rapidjson::Value value(int64Value);
+        add(value);
+        return true;
+    }
+
+    bool Uint64(std::uint64_t uint64Value)
+    {
+        rapidjson::Value value(uint64Value);
+        add(value);
+        return true;
+    }
+
+    bool Double(double doubleValue)
+    {
+        rapidjson::Value value(doubleValue);
+        add(value);
+        return true;
+    }
+
+    // strings are always copied into the tree, like rapidjson::Writer the handler ignores 'copy'
+    bool String(const char* stringValue, rapidjson::SizeType length, bool copy = false)
+    {
+        std::ignore = copy;
+        rapidjson::Value value(stringValue, length, _allocator);
+        add(value);
+        return true;
+    }
+
+    bool String(const char* stringValue)
+    {
+        return String(stringValue, static_cast<rapidjson::SizeType>(std::strlen(stringValue)));
+    }
+
+    bool String(const std::string& stringValue)
+    {
+        return String(stringValue.data(), static_cast<rapidjson::SizeType>(stringValue.size()));
+    }
+
+    bool Key(const char* key, rapidjson::SizeType length, bool copy = false)
+    {
+        std::ignore = copy;
+        _key.SetString(key, length, _allocator);
+        return true;
+    }
+
+    // parses already serialized JSON into the tree
+    bool RawValue(const char* json, std::size_t length, rapidjson::Type type)
+    {
+        std::ignore = type;
+        rapidjson::Document document;
+        document.Parse(json, length);
+        if (document.HasParseError()) {
+            throw exceptions::ParseException(std::string("could not parse JSON: ") +
+                                             rapidjson::GetParseError_En(document.GetParseError()));
+        }
+        rapidjson::Value value(document, _allocator);
+        add(value);
+        return true;
+    }
+
+    bool StartObject()
+    {
+        rapidjson::Value value(rapidjson::kObjectType);
+        _containers.push_back(&add(value));
+        return true;
+    }
+
+    bool EndObject(rapidjson::SizeType memberCount = 0)
+    {
+        std::ignore = memberCount;
+        _containers.pop_back();
+        return true;
+    }
+
+    bool StartArray()
+    {
+        rapidjson::Value value(rapidjson::kArrayType);
+        _containers.push_back(&add(value));
+        return true;
+    }
+
+    bool EndArray(rapidjson::SizeType elementCount = 0)
+    {
+        std::ignore = elementCount;
+        _containers.pop_back();
+        return true;
+    }
+
+private:
+    // moves 'value' into the current container and returns its new location
+    // only the innermost open container grows, so the locations of the open containers are stable
+    rapidjson::Value& add(rapidjson::Value& value)
+    {
+        if (_containers.empty()) {
+            _target = value;
+            return _target;
+        }
+        rapidjson::Value& container = *_containers.back();
+        if (container.IsArray()) {
+            container.PushBack(value, _allocator);
+            return container[container.Size() - 1];
+        }
+        container.AddMember(_key, value, _allocator);
+        return container.MemberBegin()[container.MemberCount() - 1].value;
+    }
+
+    rapidjson::Value& _target;
+    JsonValueOutput::Allocator& _allocator;
+    std::vector<rapidjson::Value*> _containers;
+    rapidjson::Value _key;
+};
+
+template <>
+struct JsonWriterTraits<JsonValueOutput>
+{
+    using AdaptedStream = JsonValueOutput;
+    using Writer = JsonValueWriter;
+};
+
+} // namespace detail
+} // namespace json
+
+// output archive which builds a rapidjson::Value instead of writing text
+// it shares all save functions with JsonOutputArchive
+using JsonValueOutputArchive = JsonOutputArchive<JsonValueOutput>;
+
+} // namespace muesli
+
+MUESLI_REGISTER_OUTPUT_ARCHIVE_INSTANCE(muesli::JsonValueOutputArchive)
+
+#endif // MUESLI_ARCHIVES_JSON_JSONVALUEOUTPUTARCHIVE_H_
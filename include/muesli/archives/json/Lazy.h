@@ -0,0 +1,279 @@
+/*
+ * #%L
+ * %%
+ * Copyright (C) 2011 - 2016 BMW Car IT GmbH
+ * %%
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ * 
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ * 
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ * #L%
+ */
+
+#ifndef MUESLI_ARCHIVES_JSON_LAZY_H_
+#define MUESLI_ARCHIVES_JSON_LAZY_H_
+
+#include <cstddef>
+#include <memory>
+#include <string>
+#include <type_traits>
+#include <utility>
+
+#include <boost/optional.hpp>
+
+#include "muesli/FieldMask.h"
+#include "muesli/LoadError.h"
+#include "muesli/MemoryResource.h"
+#include "muesli/Traits.h"
+#include "muesli/streams/StringIStream.h"
+
+#include "muesli/archives/json/JsonInputArchive.h"
+#include "muesli/archives/json/JsonOutputArchive.h"
+
+namespace muesli
+{
+
+// field which keeps the JSON of a value on load and only deserializes it on first access
+// the value is deserialized with the field mask, memory resource, error mode and reload mode of
+// the archive which loaded the Lazy; as long as the value has not been accessed through the
+// non-const get() it is saved by writing the kept JSON; not thread-safe
+// the memory resource of the loading archive is used by the first access, which may happen long
+// after the load: it has to outlive that access, e.g. a MonotonicMemoryResource must not be
+// released or destroyed before
+template <typename T>
+class Lazy
+{
+public:
+    Lazy() : _source(), _value(T()), _loaded(true), _error(), _modified(true)
+    {
+    }
+
+    explicit Lazy(T value)
+            : _source(), _value(std::move(value)), _loaded(true), _error(), _modified(true)
+    {
+    }
+
+    Lazy(const Lazy& other)
+            : _source(other._source ? std::make_unique<Source>(*other._source) : nullptr),
+              _value(other._value),
+              _loaded(other._loaded),
+              _error(other._error),
+              _modified(other._modified)
+    {
+    }
+
+    Lazy(Lazy&&) = default;
+
+    Lazy& operator=(const Lazy& other)
+    {
+        Lazy copy(other);
+        return *this = std::move(copy);
+    }
+
+    Lazy& operator=(Lazy&&) = default;
+
+    // deserializes the kept JSON on first access; if the loading archive recorded errors, errors
+    // of the deserialization are recorded in getError() as well, otherwise they are thrown
+    const T& get() const
+    {
+        if (!_loaded) {
+            deserialize();
+        }
+        return *_value;
+    }
+
+    T& get()
+    {
+        static_cast<const Lazy&>(*this).get();
+        _modified = true;
+        return *_value;
+    }
+
+    // true once the kept JSON has been deserialized
+    bool isLoaded() const
+    {
+        return _loaded;
+    }
+
+    // error recorded while loading or deserializing the value, see get()
+    const LoadError& getError() const
+    {
+        return _error;
+    }
+
+    // keeps a copy of 'json' which is deserialized on first access with the given settings
+    // strings which 'json' only references, see rapidjson::StringRef, are not copied
+    void setJson(const rapidjson::Value& json,
+                 FieldMask fieldMask,
+                 MemoryResource* memoryResource,
+                 bool recordsErrors,
+                 bool reloads)
+    {
+        _source = std::make_unique<Source>(
+                json, std::move(fieldMask), memoryResource, recordsErrors, reloads);
+        _loaded = false;
+        _error.clear();
+        _modified = false;
+        if (!reloads) {
+            _value = boost::none;
+        }
+    }
+
+    // records that no JSON could be loaded: get() returns a default constructed value
+    void setLoadError(LoadError::Code code, std::string message)
+    {
+        _source.reset();
+        _value = T();
+        _loaded = true;
+        _error.clear();
+        _error.set(code, std::move(message));
+        _modified = true;
+    }
+
+    // kept JSON if the value has not been modified, nullptr otherwise
+    const rapidjson::Value* getUnmodifiedJson() const
+    {
+        return _modified || !_source ? nullptr : &_source->_json;
+    }
+
+    // deserializes both values
+    bool operator==(const Lazy& other) const
+    {
+        return get() == other.get();
+    }
+
+    bool operator!=(const Lazy& other) const
+    {
+        return !(*this == other);
+    }
+
+private:
+    // the kept JSON, which owns its strings, and the settings of the archive which loaded it
+    struct Source
+    {
+        // typical kept values are small, the allocator's default of 64 KiB would dominate them
+        static constexpr std::size_t chunkSize = 1024;
+
+        Source(const rapidjson::Value& json,
+               FieldMask fieldMask,
+               MemoryResource* memoryResource,
+               bool recordsErrors,
+               bool reloads)
+                : _allocator(chunkSize),
+                  _json(json, _allocator),
+                  _fieldMask(std::move(fieldMask)),
+                  _memoryResource(memoryResource),
+                  _recordsErrors(recordsErrors),
+                  _reloads(reloads)
+        {
+        }
+
+        Source(const Source& other)
+                : Source(other._json,
+                         other._fieldMask,
+                         other._memoryResource,
+                         other._recordsErrors,
+                         other._reloads)
+        {
+        }
+
+        Source& operator=(const Source&) = delete;
+
+        rapidjson::MemoryPoolAllocator<> _allocator;
+        rapidjson::Value _json;
+        FieldMask _fieldMask;
+        MemoryResource* _memoryResource;
+        bool _recordsErrors;
+        bool _reloads;
+    };
+
+    void deserialize() const
+    {
+        using Archive = JsonInputArchive<StringIStream>;
+        if (_source->_recordsErrors) {
+            _error.clear();
+            Archive archive(_source->_json, _error, _source->_fieldMask);
+            deserialize(archive);
+        } else {
+            Archive archive(_source->_json, _source->_fieldMask);
+            deserialize(archive);
+        }
+        _loaded = true;
+    }
+
+    template <typename Archive>
+    void deserialize(Archive& archive) const
+    {
+        MemoryResource* memoryResource = _source->_memoryResource;
+        archive.setMemoryResource(memoryResource);
+        if (_source->_reloads && _value) {
+            archive.reload(*_value);
+        } else if (memoryResource == nullptr) {
+            deserializeNewValue(archive);
+        } else {
+            // the new value allocates from the resource like the values the archive creates
+            ScopedMemoryResource scopedMemoryResource(memoryResource);
+            deserializeNewValue(archive);
+        }
+    }
+
+    template <typename Archive>
+    void deserializeNewValue(Archive& archive) const
+    {
+        T value;
+        archive(value);
+        _value = std::move(value);
+    }
+
+    std::unique_ptr<Source> _source;
+    mutable boost::optional<T> _value;
+    mutable bool _loaded;
+    mutable LoadError _error;
+    bool _modified;
+};
+
+template <typename T>
+struct SkipIntroOutroTraits<Lazy<T>> : std::true_type
+{
+};
+
+template <typename InputStream, typename T>
+void load(JsonInputArchive<InputStream>& archive, Lazy<T>& lazy)
+{
+    if (archive.isValidating()) {
+        T value;
+        archive(value);
+        return;
+    }
+    const rapidjson::Value* json = archive.readJsonValue();
+    if (json == nullptr) {
+        lazy.setLoadError(LoadError::Code::ValueNotFound, "No value to load lazily.");
+        return;
+    }
+    lazy.setJson(*json,
+                 archive.getCurrentFieldMask(),
+                 archive.getMemoryResource(),
+                 archive.recordsErrors(),
+                 archive.isReloading());
+}
+
+template <typename OutputStream, typename T>
+void save(JsonOutputArchive<OutputStream>& archive, const Lazy<T>& lazy)
+{
+    if (const rapidjson::Value* json = lazy.getUnmodifiedJson()) {
+        archive.writeJsonValue(*json);
+    } else {
+        archive(lazy.get());
+    }
+}
+
+} // namespace muesli
+
+#endif // MUESLI_ARCHIVES_JSON_LAZY_H_
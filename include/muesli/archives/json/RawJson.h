@@ -0,0 +1,78 @@
+/*
+ * #%L
+ * %%
+ * Copyright (C) 2011 - 2016 BMW Car IT GmbH
+ * %%
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ * 
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ * 
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ * #L%
+ */
+
+#ifndef MUESLI_ARCHIVES_JSON_RAWJSON_H_
+#define MUESLI_ARCHIVES_JSON_RAWJSON_H_
+
+#include <string>
+#include <type_traits>
+#include <utility>
+
+#include "muesli/Traits.h"
+
+namespace muesli
+{
+
+// holds a serialized JSON value which is passed through without being loaded into C++ objects
+// JsonInputArchive stores a compact serialization of the value,
+// JsonOutputArchive writes it verbatim
+class RawJson
+{
+public:
+    RawJson() : _json()
+    {
+    }
+
+    explicit RawJson(std::string json) : _json(std::move(json))
+    {
+    }
+
+    const std::string& getJson() const
+    {
+        return _json;
+    }
+
+    void setJson(std::string json)
+    {
+        _json = std::move(json);
+    }
+
+    bool operator==(const RawJson& other) const
+    {
+        return _json == other._json;
+    }
+
+    bool operator!=(const RawJson& other) const
+    {
+        return !(*this == other);
+    }
+
+private:
+    std::string _json;
+};
+
+// the archives read and write the raw value as a whole
+template <>
+struct SkipIntroOutroTraits<RawJson> : std::true_type
+{
+};
+
+} // namespace muesli
+
+#endif // MUESLI_ARCHIVES_JSON_RAWJSON_H_
@@ -0,0 +1,78 @@
+/*
+ * #%L
+ * %%
+ * Copyright (C) 2011 - 2016 BMW Car IT GmbH
+ * %%
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ * 
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ * 
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ * #L%
+ */
+
+#ifndef MUESLI_ARCHIVES_JSON_DETAIL_JSONEVENTREADER_H_
+#define MUESLI_ARCHIVES_JSON_DETAIL_JSONEVENTREADER_H_
+
+#include <string>
+
+#ifndef RAPIDJSON_HAS_STDSTRING
+#define RAPIDJSON_HAS_STDSTRING 1
+#include <rapidjson/error/en.h>
+#include <rapidjson/reader.h>
+#undef RAPIDJSON_HAS_STDSTRING
+#else
+#include <rapidjson/error/en.h>
+#include <rapidjson/reader.h>
+#endif // RAPIDJSON_HAS_STDSTRING
+
+#include "muesli/detail/ThrowException.h"
+#include "muesli/exceptions/ParseException.h"
+
+#include "muesli/archives/json/detail/RapidJsonInputStreamAdapter.h"
+
+namespace muesli
+{
+namespace json
+{
+namespace detail
+{
+
+// parses JSON with RapidJSON's SAX Reader and passes the events on without building a document
+template <typename InputStream>
+class JsonEventReader
+{
+public:
+    explicit JsonEventReader(InputStream& stream) : _stream(stream)
+    {
+    }
+
+    template <typename Handler>
+    void parse(Handler& handler)
+    {
+        RapidJsonInputStreamAdapter<InputStream> adaptedStream(_stream);
+        rapidjson::Reader reader;
+        const rapidjson::ParseResult result =
+                reader.Parse<rapidjson::kParseDefaultFlags>(adaptedStream, handler);
+        if (result.IsError()) {
+            muesli::detail::throwException(
+                    exceptions::ParseException(std::string("could not parse JSON: ") +
+                                               rapidjson::GetParseError_En(result.Code())));
+        }
+    }
+
+private:
+    InputStream& _stream;
+};
+
+} // namespace detail
+} // namespace json
+} // namespace muesli
+
+#endif // MUESLI_ARCHIVES_JSON_DETAIL_JSONEVENTREADER_H_
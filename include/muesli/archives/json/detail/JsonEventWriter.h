@@ -0,0 +1,142 @@
+/*
+ * #%L
+ * %%
+ * Copyright (C) 2011 - 2016 BMW Car IT GmbH
+ * %%
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ * 
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ * 
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ * #L%
+ */
+
+#ifndef MUESLI_ARCHIVES_JSON_DETAIL_JSONEVENTWRITER_H_
+#define MUESLI_ARCHIVES_JSON_DETAIL_JSONEVENTWRITER_H_
+
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+
+#ifndef RAPIDJSON_HAS_STDSTRING
+#define RAPIDJSON_HAS_STDSTRING 1
+#include <rapidjson/writer.h>
+#undef RAPIDJSON_HAS_STDSTRING
+#else
+#include <rapidjson/writer.h>
+#endif // RAPIDJSON_HAS_STDSTRING
+
+#include "muesli/archives/json/detail/RapidJsonOutputStreamAdapter.h"
+
+namespace muesli
+{
+namespace json
+{
+namespace detail
+{
+
+// writes SAX events as JSON to a muesli OutputStream
+// like JsonOutputArchive, NaN is written as null
+template <typename OutputStream>
+class JsonEventWriter
+{
+public:
+    explicit JsonEventWriter(OutputStream& stream) : _outputStream(stream), _writer(_outputStream)
+    {
+    }
+
+    bool Null()
+    {
+        return _writer.Null();
+    }
+
+    bool Bool(bool value)
+    {
+        return _writer.Bool(value);
+    }
+
+    bool Int(int value)
+    {
+        return _writer.Int(value);
+    }
+
+    bool Uint(unsigned value)
+    {
+        return _writer.Uint(value);
+    }
+
+    bool Int64(std::int64_t value)
+    {
+        return _writer.Int64(value);
+    }
+
+    bool Uint64(std::uint64_t value)
+    {
+        return _writer.Uint64(value);
+    }
+
+    bool Double(double value)
+    {
+        if (std::isnan(value)) {
+            return _writer.Null();
+        }
+        return _writer.Double(value);
+    }
+
+    bool RawNumber(const char* value, std::size_t length, bool copy = false)
+    {
+        return _writer.RawNumber(value, static_cast<rapidjson::SizeType>(length), copy);
+    }
+
+    bool String(const char* value, std::size_t length, bool copy = false)
+    {
+        return _writer.String(value, static_cast<rapidjson::SizeType>(length), copy);
+    }
+
+    bool Key(const char* key, std::size_t length, bool copy = false)
+    {
+        return _writer.Key(key, static_cast<rapidjson::SizeType>(length), copy);
+    }
+
+    bool StartObject()
+    {
+        return _writer.StartObject();
+    }
+
+    bool EndObject(std::size_t memberCount = 0)
+    {
+        return _writer.EndObject(static_cast<rapidjson::SizeType>(memberCount));
+    }
+
+    bool StartArray()
+    {
+        return _writer.StartArray();
+    }
+
+    bool EndArray(std::size_t elementCount = 0)
+    {
+        return _writer.EndArray(static_cast<rapidjson::SizeType>(elementCount));
+    }
+
+    void Flush()
+    {
+        _writer.Flush();
+    }
+
+private:
+    using AdaptedStream = RapidJsonOutputStreamAdapter<OutputStream>;
+    AdaptedStream _outputStream;
+    rapidjson::Writer<AdaptedStream> _writer;
+};
+
+} // namespace detail
+} // namespace json
+} // namespace muesli
+
+#endif // MUESLI_ARCHIVES_JSON_DETAIL_JSONEVENTWRITER_H_
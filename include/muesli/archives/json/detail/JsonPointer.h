@@ -0,0 +1,369 @@
+/*
+ * #%L
+ * %%
+ * Copyright (C) 2011 - 2016 BMW Car IT GmbH
+ * %%
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ * 
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ * 
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ * #L%
+ */
+
+#ifndef MUESLI_ARCHIVES_JSON_DETAIL_JSONPOINTER_H_
+#define MUESLI_ARCHIVES_JSON_DETAIL_JSONPOINTER_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "muesli/detail/ThrowException.h"
+#include "muesli/exceptions/ParseException.h"
+
+namespace muesli
+{
+namespace json
+{
+namespace detail
+{
+
+// splits an RFC 6901 JSON pointer into its unescaped reference tokens
+inline std::vector<std::string> parseJsonPointer(const std::string& pointer)
+{
+    std::vector<std::string> tokens;
+    if (pointer.empty()) {
+        return tokens;
+    }
+    if (pointer[0] != '/') {
+        muesli::detail::throwException(
+                std::invalid_argument("Invalid JSON pointer \"" + pointer + "\"."));
+    }
+    for (std::size_t i = 1; i <= pointer.size(); ++i) {
+        if (i == 1 || pointer[i - 1] == '/') {
+            tokens.emplace_back();
+        }
+        if (i == pointer.size() || pointer[i] == '/') {
+            continue;
+        }
+        if (pointer[i] != '~') {
+            tokens.back() += pointer[i];
+        } else if (i + 1 < pointer.size() && (pointer[i + 1] == '0' || pointer[i + 1] == '1')) {
+            tokens.back() += pointer[++i] == '0' ? '~' : '/';
+        } else {
+            muesli::detail::throwException(
+                    std::invalid_argument("Invalid JSON pointer \"" + pointer + "\"."));
+        }
+    }
+    return tokens;
+}
+
+// converts a reference token into an array index, fails for leading zeros and for "-"
+inline bool parseArrayIndex(const std::string& token, std::size_t& index)
+{
+    if (token.empty() || token.size() > 18 || (token.size() > 1 && token[0] == '0')) {
+        return false;
+    }
+    index = 0;
+    for (char c : token) {
+        if (c < '0' || c > '9') {
+            return false;
+        }
+        index = index * 10 + static_cast<std::size_t>(c - '0');
+    }
+    return true;
+}
+
+// locates the value referenced by a JSON pointer in serialized JSON without building a document
+// values in front of the referenced one are skipped by only matching brackets and quotes,
+// the referenced value itself is not validated
+class JsonPointerScanner
+{
+public:
+    JsonPointerScanner(const char* begin, const char* end) : _current(begin), _end(end), _key()
+    {
+    }
+
+    JsonPointerScanner(const JsonPointerScanner&) = delete;
+    JsonPointerScanner& operator=(const JsonPointerScanner&) = delete;
+
+    // on success [valueBegin, valueEnd) holds the serialized value
+    bool find(const std::vector<std::string>& tokens,
+              const char*& valueBegin,
+              const char*& valueEnd)
+    {
+        for (const std::string& token : tokens) {
+            skipWhitespace();
+            if (_current == _end) {
+                return false;
+            }
+            if (*_current == '{') {
+                if (!findMember(token)) {
+                    return false;
+                }
+            } else if (*_current == '[') {
+                std::size_t index = 0;
+                if (!parseArrayIndex(token, index) || !findElement(index)) {
+                    return false;
+                }
+            } else {
+                return false;
+            }
+        }
+        skipWhitespace();
+        valueBegin = _current;
+        skipValue();
+        valueEnd = _current;
+        return valueBegin != valueEnd;
+    }
+
+private:
+    bool findMember(const std::string& name)
+    {
+        ++_current;
+        skipWhitespace();
+        if (peek() == '}') {
+            return false;
+        }
+        while (true) {
+            skipWhitespace();
+            expect('"');
+            const char* keyBegin = _current;
+            skipString();
+            const bool matches = keyEquals(keyBegin, _current - 1, name);
+            skipWhitespace();
+            expect(':');
+            skipWhitespace();
+            if (matches) {
+                return true;
+            }
+            skipValue();
+            skipWhitespace();
+            if (peek() == '}') {
+                return false;
+            }
+            expect(',');
+        }
+    }
+
+    bool findElement(std::size_t index)
+    {
+        ++_current;
+        skipWhitespace();
+        if (peek() == ']') {
+            return false;
+        }
+        for (; index > 0; --index) {
+            skipValue();
+            skipWhitespace();
+            if (peek() == ']') {
+                return false;
+            }
+            expect(',');
+            skipWhitespace();
+        }
+        return true;
+    }
+
+    void skipValue()
+    {
+        const char c = peek();
+        if (c == '"') {
+            ++_current;
+            skipString();
+        } else if (c == '{' || c == '[') {
+            std::size_t depth = 0;
+            do {
+                const char next = peek();
+                ++_current;
+                if (next == '"') {
+                    skipString();
+                } else if (next == '{' || next == '[') {
+                    ++depth;
+                } else if (next == '}' || next == ']') {
+                    --depth;
+                }
+            } while (depth > 0);
+        } else {
+            while (_current != _end && std::strchr(",}] \t\r\n", *_current) == nullptr) {
+                ++_current;
+            }
+        }
+    }
+
+    // expects _current behind the opening quote, leaves it behind the closing quote
+    void skipString()
+    {
+        while (true) {
+            const char c = peek();
+            ++_current;
+            if (c == '"') {
+                return;
+            }
+            if (c == '\\') {
+                peek();
+                ++_current;
+            }
+        }
+    }
+
+    bool keyEquals(const char* begin, const char* end, const std::string& name)
+    {
+        const std::size_t length = static_cast<std::size_t>(end - begin);
+        if (std::memchr(begin, '\\', length) == nullptr) {
+            return name.compare(0, std::string::npos, begin, length) == 0;
+        }
+        decodeString(begin, end, _key);
+        return _key == name;
+    }
+
+    static void decodeString(const char* begin, const char* end, std::string& decoded)
+    {
+        decoded.clear();
+        while (begin != end) {
+            if (*begin != '\\') {
+                decoded += *begin++;
+                continue;
+            }
+            if (++begin == end) {
+                muesli::detail::throwException(
+                        exceptions::ParseException("could not parse JSON: invalid escape"));
+            }
+            const char escaped = *begin++;
+            switch (escaped) {
+            case 'b':
+                decoded += '\b';
+                break;
+            case 'f':
+                decoded += '\f';
+                break;
+            case 'n':
+                decoded += '\n';
+                break;
+            case 'r':
+                decoded += '\r';
+                break;
+            case 't':
+                decoded += '\t';
+                break;
+            case 'u':
+                appendUtf8(decodeCodePoint(begin, end), decoded);
+                break;
+            default:
+                decoded += escaped;
+            }
+        }
+    }
+
+    // a high surrogate must be followed by an escaped low surrogate, a low one must not stand alone
+    static std::uint32_t decodeCodePoint(const char*& begin, const char* end)
+    {
+        const std::uint32_t codePoint = decodeHex4(begin, end);
+        if (codePoint < 0xD800 || codePoint > 0xDFFF) {
+            return codePoint;
+        }
+        if (codePoint > 0xDBFF || end - begin < 6 || begin[0] != '\\' || begin[1] != 'u') {
+            throwInvalidSurrogate();
+        }
+        begin += 2;
+        const std::uint32_t low = decodeHex4(begin, end);
+        if (low < 0xDC00 || low > 0xDFFF) {
+            throwInvalidSurrogate();
+        }
+        return 0x10000 + ((codePoint - 0xD800) << 10) + (low - 0xDC00);
+    }
+
+    [[noreturn]] static void throwInvalidSurrogate()
+    {
+        muesli::detail::throwException(
+                exceptions::ParseException("could not parse JSON: invalid surrogate pair"));
+    }
+
+    static std::uint32_t decodeHex4(const char*& begin, const char* end)
+    {
+        if (end - begin < 4) {
+            muesli::detail::throwException(
+                    exceptions::ParseException("could not parse JSON: invalid unicode escape"));
+        }
+        std::uint32_t value = 0;
+        for (int i = 0; i < 4; ++i) {
+            const char c = *begin++;
+            value <<= 4;
+            if (c >= '0' && c <= '9') {
+                value |= static_cast<std::uint32_t>(c - '0');
+            } else if (c >= 'a' && c <= 'f') {
+                value |= static_cast<std::uint32_t>(c - 'a' + 10);
+            } else if (c >= 'A' && c <= 'F') {
+                value |= static_cast<std::uint32_t>(c - 'A' + 10);
+            } else {
+                muesli::detail::throwException(
+                        exceptions::ParseException("could not parse JSON: invalid unicode escape"));
+            }
+        }
+        return value;
+    }
+
+    static void appendUtf8(std::uint32_t codePoint, std::string& output)
+    {
+        if (codePoint < 0x80) {
+            output += static_cast<char>(codePoint);
+        } else if (codePoint < 0x800) {
+            output += static_cast<char>(0xC0 | (codePoint >> 6));
+            output += static_cast<char>(0x80 | (codePoint & 0x3F));
+        } else if (codePoint < 0x10000) {
+            output += static_cast<char>(0xE0 | (codePoint >> 12));
+            output += static_cast<char>(0x80 | ((codePoint >> 6) & 0x3F));
+            output += static_cast<char>(0x80 | (codePoint & 0x3F));
+        } else {
+            output += static_cast<char>(0xF0 | (codePoint >> 18));
+            output += static_cast<char>(0x80 | ((codePoint >> 12) & 0x3F));
+            output += static_cast<char>(0x80 | ((codePoint >> 6) & 0x3F));
+            output += static_cast<char>(0x80 | (codePoint & 0x3F));
+        }
+    }
+
+    void skipWhitespace()
+    {
+        while (_current != _end &&
+               (*_current == ' ' || *_current == '\t' || *_current == '\r' || *_current == '\n')) {
+            ++_current;
+        }
+    }
+
+    char peek() const
+    {
+        if (_current == _end) {
+            muesli::detail::throwException(
+                    exceptions::ParseException("could not parse JSON: unexpected end of input"));
+        }
+        return *_current;
+    }
+
+    void expect(char expected)
+    {
+        if (peek() != expected) {
+            muesli::detail::throwException(exceptions::ParseException(
+                    std::string("could not parse JSON: expected '") + expected + "'"));
+        }
+        ++_current;
+    }
+
+    const char* _current;
+    const char* _end;
+    std::string _key;
+};
+
+} // namespace detail
+} // namespace json
+} // namespace muesli
+
+#endif // MUESLI_ARCHIVES_JSON_DETAIL_JSONPOINTER_H_
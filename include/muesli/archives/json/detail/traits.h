@@ -48,8 +48,8 @@ struct IsArray : std::false_type
 {
 };
 
-template <typename T>
-struct IsArray<std::vector<T>> : std::true_type
+template <typename T, typename Allocator>
+struct IsArray<std::vector<T, Allocator>> : std::true_type
 {
 };
 
@@ -68,12 +68,22 @@ struct IsArray<boost::multi_index_container<Ts...>> : std::true_type
 {
 };
 
+template <typename T>
+struct IsString : std::false_type
+{
+};
+
+template <typename Traits, typename Allocator>
+struct IsString<std::basic_string<char, Traits, Allocator>> : std::true_type
+{
+};
+
 template <typename T>
 struct IsPrimitive
 {
     static constexpr bool value = std::is_same<std::vector<bool>::const_reference, T>::value ||
                                   std::is_same<std::vector<bool>::reference, T>::value ||
-                                  std::is_same<std::string, T>::value || !std::is_class<T>::value ||
+                                  IsString<T>::value || !std::is_class<T>::value ||
                                   std::is_same<std::nullptr_t, T>::value;
 };
 
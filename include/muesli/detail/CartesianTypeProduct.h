@@ -20,40 +20,37 @@
 #ifndef MUESLI_DETAIL_CARTESIANTYPEPRODUCT_H_
 #define MUESLI_DETAIL_CARTESIANTYPEPRODUCT_H_
 
-#include <boost/mpl/transform.hpp>
-
-#include "muesli/detail/FlattenMplSequence.h"
+#include "muesli/detail/TypeList.h"
 
 namespace muesli
 {
 namespace detail
 {
 
-template <typename X, typename Y, typename CombineOperation>
-struct ApplyCombineOperation
-{
-    using type = typename CombineOperation::template apply<X, Y>::type;
-};
-
-// iterate over Ys and apply Transformation
+// combine X with each of Ys
 template <typename X, typename Ys, typename CombineOperation>
-struct InnerCartesianTypeProduct
+struct InnerCartesianTypeProduct;
+
+template <typename X, typename... Ys, typename CombineOperation>
+struct InnerCartesianTypeProduct<X, TypeList<Ys...>, CombineOperation>
 {
-    using type = typename boost::mpl::transform<
-            Ys,
-            ApplyCombineOperation<X, boost::mpl::_1, CombineOperation>>::type;
+    using type = TypeList<typename CombineOperation::template apply<X, Ys>::type...>;
 };
 
-// iterate over Xs
 template <typename Xs, typename Ys, typename CombineOperation>
-using CartesianTypeProduct = typename boost::mpl::transform<
-        Xs,
-        InnerCartesianTypeProduct<boost::mpl::_1, Ys, CombineOperation>>::type;
+struct CartesianTypeProduct;
+
+// iterate over Xs and concatenate the results
+template <typename... Xs, typename Ys, typename CombineOperation>
+struct CartesianTypeProduct<TypeList<Xs...>, Ys, CombineOperation>
+{
+    using type = typename Concat<
+            typename InnerCartesianTypeProduct<Xs, Ys, CombineOperation>::type...>::type;
+};
 
-// flatten nested type lists
+// TypeList of CombineOperation::apply<X, Y>::type for all X in Xs and Y in Ys, ordered by X
 template <typename Xs, typename Ys, typename CombineOperation>
-using FlatCartesianTypeProduct = typename FlattenMplSequence<
-        typename CartesianTypeProduct<Xs, Ys, CombineOperation>::type>::type;
+using FlatCartesianTypeProduct = typename CartesianTypeProduct<Xs, Ys, CombineOperation>::type;
 
 } // namespace detail
 } // namespace muesli
@@ -0,0 +1,203 @@
+/*
+ * #%L
+ * %%
+ * Copyright (C) 2011 - 2016 BMW Car IT GmbH
+ * %%
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ * 
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ * 
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ * #L%
+ */
+
+#ifndef MUESLI_DETAIL_COLUMNCOLLECTOR_H_
+#define MUESLI_DETAIL_COLUMNCOLLECTOR_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <stdexcept>
+#include <string>
+#include <tuple>
+#include <type_traits>
+#include <vector>
+
+#include "muesli/BaseArchive.h"
+#include "muesli/NameValuePair.h"
+#include "muesli/NameValuePairWithDefault.h"
+#include "muesli/SkipIntroOutroWrapper.h"
+#include "muesli/Tags.h"
+#include "muesli/Traits.h"
+#include "muesli/detail/DelayStaticAssert.h"
+#include "muesli/detail/ThrowException.h"
+
+namespace muesli
+{
+namespace detail
+{
+
+// holds all values of one field of a sequence of flat structs
+// numbers are stored contiguously, strings are stored as a single blob plus end offsets
+struct Column
+{
+    enum class Type { Bool, Integer, UnsignedInteger, Double, String };
+
+    Column(const char* name, Type type)
+            : _name(name),
+              _type(type),
+              _doubles(),
+              _integers(),
+              _unsignedIntegers(),
+              _stringBlob(),
+              _stringEndOffsets()
+    {
+    }
+
+    std::size_t size() const
+    {
+        switch (_type) {
+        case Type::Double:
+            return _doubles.size();
+        case Type::Integer:
+            return _integers.size();
+        case Type::Bool:
+        case Type::UnsignedInteger:
+            return _unsignedIntegers.size();
+        case Type::String:
+            return _stringEndOffsets.size();
+        }
+        return 0;
+    }
+
+    std::string _name;
+    Type _type;
+    std::vector<double> _doubles;
+    std::vector<std::int64_t> _integers;
+    std::vector<std::uint64_t> _unsignedIntegers;
+    std::string _stringBlob;
+    std::vector<std::size_t> _stringEndOffsets;
+};
+
+// output archive which transposes a sequence of flat structs into one Column per NameValuePair
+class ColumnCollector : public BaseArchive<tags::OutputArchive, ColumnCollector>
+{
+    using Parent = BaseArchive<tags::OutputArchive, ColumnCollector>;
+
+public:
+    ColumnCollector() : Parent(this), _columns(), _nextColumn(0), _rowCount(0)
+    {
+    }
+
+    template <typename T>
+    void collectRow(const T& row)
+    {
+        _nextColumn = 0;
+        (*this)(SkipIntroOutroWrapper<T>(&row));
+        if (_nextColumn != _columns.size()) {
+            throwException(
+                    std::invalid_argument("Cannot store rows with differing fields as columns."));
+        }
+        ++_rowCount;
+    }
+
+    void append(const char* name, bool value)
+    {
+        nextColumn(name, Column::Type::Bool)._unsignedIntegers.push_back(value ? 1 : 0);
+    }
+
+    void append(const char* name, const std::string& value)
+    {
+        Column& column = nextColumn(name, Column::Type::String);
+        column._stringBlob.append(value);
+        column._stringEndOffsets.push_back(column._stringBlob.size());
+    }
+
+    template <typename T>
+    std::enable_if_t<std::is_floating_point<T>::value> append(const char* name, T value)
+    {
+        nextColumn(name, Column::Type::Double)._doubles.push_back(value);
+    }
+
+    template <typename T>
+    std::enable_if_t<std::is_integral<T>::value && std::is_signed<T>::value> append(
+            const char* name,
+            T value)
+    {
+        nextColumn(name, Column::Type::Integer)._integers.push_back(value);
+    }
+
+    template <typename T>
+    std::enable_if_t<std::is_integral<T>::value && std::is_unsigned<T>::value> append(
+            const char* name,
+            T value)
+    {
+        nextColumn(name, Column::Type::UnsignedInteger)._unsignedIntegers.push_back(value);
+    }
+
+    template <typename Enum, typename Wrapper = typename EnumTraits<Enum>::Wrapper>
+    std::enable_if_t<std::is_enum<Enum>::value> append(const char* name, Enum value)
+    {
+        append(name, Wrapper::getLiteral(value));
+    }
+
+    template <typename T>
+    std::enable_if_t<std::is_class<T>::value && !std::is_same<T, std::string>::value> append(
+            const char* name,
+            const T& value)
+    {
+        std::ignore = name;
+        std::ignore = value;
+        static_assert(DelayStaticAssert<T>::value,
+                      "columns can only be built from flat structs with primitive fields");
+    }
+
+    const std::vector<Column>& getColumns() const
+    {
+        return _columns;
+    }
+
+    std::size_t getRowCount() const
+    {
+        return _rowCount;
+    }
+
+private:
+    Column& nextColumn(const char* name, Column::Type type)
+    {
+        if (_rowCount == 0) {
+            _columns.emplace_back(name, type);
+        } else if (_nextColumn >= _columns.size() || _columns[_nextColumn]._name != name ||
+                   _columns[_nextColumn]._type != type) {
+            throwException(
+                    std::invalid_argument("Cannot store rows with differing fields as columns."));
+        }
+        return _columns[_nextColumn++];
+    }
+
+    std::vector<Column> _columns;
+    std::size_t _nextColumn;
+    std::size_t _rowCount;
+};
+
+template <typename T>
+void save(ColumnCollector& collector, const NameValuePair<T>& nameValuePair)
+{
+    collector.append(nameValuePair._name, nameValuePair._value);
+}
+
+template <typename T, typename Default>
+void save(ColumnCollector& collector, const NameValuePairWithDefault<T, Default>& nameValuePair)
+{
+    collector.append(nameValuePair._name, nameValuePair._value);
+}
+
+} // namespace detail
+} // namespace muesli
+
+#endif // MUESLI_DETAIL_COLUMNCOLLECTOR_H_
@@ -20,18 +20,18 @@
 #ifndef MUESLI_DETAIL_INCREMENTALTYPELIST_H_
 #define MUESLI_DETAIL_INCREMENTALTYPELIST_H_
 
+#include <cstddef>
+#include <type_traits>
 #include <utility>
 
-#include <boost/mpl/push_back.hpp>
-#include <boost/mpl/size.hpp>
-#include <boost/mpl/vector.hpp>
+#include "muesli/detail/TypeList.h"
 
 namespace muesli
 {
 namespace detail
 {
 
-using MaxIncrementalTypeListSize = std::integral_constant<std::size_t, BOOST_MPL_LIMIT_VECTOR_SIZE>;
+using MaxIncrementalTypeListSize = std::integral_constant<std::size_t, 256>;
 
 template <std::size_t i>
 struct IncrementalTypeListIndex : IncrementalTypeListIndex<i - 1>
@@ -45,12 +45,12 @@ struct IncrementalTypeListIndex<0>
 
 // initially empty type list
 template <class TypeListTag>
-boost::mpl::vector<> IncrementalTypeList(const TypeListTag&, IncrementalTypeListIndex<0>);
+TypeList<> IncrementalTypeList(const TypeListTag&, IncrementalTypeListIndex<0>);
 
 } // namespace detail
 } // namespace muesli
 
-// retrieve a boost::mpl::vector which contains all types that were added to this specific list
+// retrieve a TypeList which contains all types that were added to this specific list
 // this has to be a macro instead of an alias template due to GCC's delayed template instantiation
 #define MUESLI_GET_INCREMENTAL_TYPELIST(TypeListTag)                                               \
     decltype(muesli::detail::IncrementalTypeList(                                                  \
@@ -63,14 +63,13 @@ boost::mpl::vector<> IncrementalTypeList(const TypeListTag&, IncrementalTypeList
     {                                                                                              \
     namespace detail                                                                               \
     {                                                                                              \
-    static_assert(boost::mpl::size<MUESLI_GET_INCREMENTAL_TYPELIST(TypeListTag)>::value <          \
+    static_assert(ListSize<MUESLI_GET_INCREMENTAL_TYPELIST(TypeListTag)>::value <                 \
                           MaxIncrementalTypeListSize::value,                                       \
                   "max types exceeded for tag " #TypeListTag);                                     \
-    boost::mpl::push_back<MUESLI_GET_INCREMENTAL_TYPELIST(TypeListTag), Type>::type                \
-    IncrementalTypeList(                                                                           \
+    Append<Type, MUESLI_GET_INCREMENTAL_TYPELIST(TypeListTag)>::type IncrementalTypeList(          \
             const TypeListTag&,                                                                    \
-            IncrementalTypeListIndex<                                                              \
-                    boost::mpl::size<MUESLI_GET_INCREMENTAL_TYPELIST(TypeListTag)>::value + 1>);   \
+            IncrementalTypeListIndex<ListSize<MUESLI_GET_INCREMENTAL_TYPELIST(TypeListTag)>::value \
+                                     + 1>);                                                        \
     } /* namespace detail */                                                                       \
     } /* namespace muesli */
 
@@ -0,0 +1,68 @@
+/*
+ * #%L
+ * %%
+ * Copyright (C) 2011 - 2016 BMW Car IT GmbH
+ * %%
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ * 
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ * 
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ * #L%
+ */
+
+#ifndef MUESLI_DETAIL_MAKEPOINTER_H_
+#define MUESLI_DETAIL_MAKEPOINTER_H_
+
+#include <memory>
+#include <string>
+#include <tuple>
+
+#include "muesli/MemoryResource.h"
+
+namespace muesli
+{
+namespace detail
+{
+
+// creates a new T owned by the same kind of smart pointer as 'ptr'
+// shared_ptrs allocate the object and its reference count at once from the current memory resource
+template <typename T, typename Base>
+std::unique_ptr<T> makePointer(const std::unique_ptr<Base>& ptr)
+{
+    std::ignore = ptr;
+    return std::make_unique<T>();
+}
+
+template <typename T, typename Base>
+std::shared_ptr<T> makePointer(const std::shared_ptr<Base>& ptr)
+{
+    std::ignore = ptr;
+    return makeShared<T>();
+}
+
+// selects the load function of a TypeLoadRegistry which creates the kind of smart pointer of 'ptr'
+template <typename TypeRegistry, typename Base>
+auto getRegisteredLoadFunction(const std::string& typeName, const std::unique_ptr<Base>& ptr)
+{
+    std::ignore = ptr;
+    return TypeRegistry::getLoadFunction(typeName);
+}
+
+template <typename TypeRegistry, typename Base>
+auto getRegisteredLoadFunction(const std::string& typeName, const std::shared_ptr<Base>& ptr)
+{
+    std::ignore = ptr;
+    return TypeRegistry::getSharedLoadFunction(typeName);
+}
+
+} // namespace detail
+} // namespace muesli
+
+#endif // MUESLI_DETAIL_MAKEPOINTER_H_
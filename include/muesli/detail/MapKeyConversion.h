@@ -0,0 +1,152 @@
+/*
+ * #%L
+ * %%
+ * Copyright (C) 2011 - 2016 BMW Car IT GmbH
+ * %%
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ * 
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ * 
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ * #L%
+ */
+
+#ifndef MUESLI_DETAIL_MAPKEYCONVERSION_H_
+#define MUESLI_DETAIL_MAPKEYCONVERSION_H_
+
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+#include <utility>
+
+#include <boost/lexical_cast.hpp>
+
+#include "muesli/Traits.h"
+#include "muesli/detail/ThrowException.h"
+#include "muesli/detail/VoidT.h"
+
+namespace muesli
+{
+
+// conversion of map keys to and from the strings which are used as object keys by the archives
+
+template <typename T>
+std::enable_if_t<std::is_same<std::string, T>::value, std::string> toString(const T& key)
+{
+    return key;
+}
+
+template <typename Enum, typename Wrapper = typename EnumTraits<Enum>::Wrapper>
+std::enable_if_t<std::is_enum<Enum>::value, std::string> toString(const Enum& key)
+{
+    return Wrapper::getLiteral(key);
+}
+
+template <typename T>
+std::enable_if_t<!std::is_same<std::string, T>::value && !std::is_enum<T>::value &&
+                         !std::is_class<T>::value,
+                 std::string>
+toString(const T& key)
+{
+    return boost::lexical_cast<std::string>(key);
+}
+
+namespace detail
+{
+
+template <typename T>
+std::enable_if_t<!std::is_enum<T>::value && !std::is_same<T, std::string>::value> stringToType(
+        const std::string& string,
+        T& type)
+{
+    type = boost::lexical_cast<T>(string);
+}
+
+template <typename T>
+std::enable_if_t<std::is_same<T, std::string>::value> stringToType(const std::string& string,
+                                                                   T& type)
+{
+    type = string;
+}
+
+template <typename Enum, typename Wrapper = typename EnumTraits<Enum>::Wrapper>
+std::enable_if_t<std::is_enum<Enum>::value> stringToType(const std::string& literal,
+                                                         Enum& enumValue)
+{
+    enumValue = Wrapper::getEnum(literal);
+}
+
+// returns false instead of throwing if 'string' cannot be converted
+template <typename T>
+std::enable_if_t<!std::is_enum<T>::value && !std::is_same<T, std::string>::value, bool>
+tryStringToType(const std::string& string, T& type)
+{
+    return boost::conversion::try_lexical_convert(string, type);
+}
+
+template <typename T>
+std::enable_if_t<std::is_same<T, std::string>::value, bool> tryStringToType(
+        const std::string& string,
+        T& type)
+{
+    type = string;
+    return true;
+}
+
+// wrappers may provide 'static bool tryGetEnum(const std::string&, Enum&)', which reports an
+// unknown literal without throwing
+template <typename Wrapper, typename Enum, typename Enable = void>
+struct HasTryGetEnum : std::false_type
+{
+};
+
+template <typename Wrapper, typename Enum>
+struct HasTryGetEnum<Wrapper,
+                     Enum,
+                     VoidT<decltype(Wrapper::tryGetEnum(std::declval<const std::string&>(),
+                                                        std::declval<Enum&>()))>>
+        : std::true_type
+{
+};
+
+template <typename Wrapper, typename Enum>
+std::enable_if_t<HasTryGetEnum<Wrapper, Enum>::value, bool> tryGetEnum(const std::string& literal,
+                                                                       Enum& enumValue)
+{
+    return Wrapper::tryGetEnum(literal, enumValue);
+}
+
+// getEnum throws std::invalid_argument for an unknown literal
+template <typename Wrapper, typename Enum>
+std::enable_if_t<!HasTryGetEnum<Wrapper, Enum>::value, bool> tryGetEnum(const std::string& literal,
+                                                                        Enum& enumValue)
+{
+#if MUESLI_HAS_EXCEPTIONS
+    try {
+        enumValue = Wrapper::getEnum(literal);
+    } catch (const std::invalid_argument&) {
+        return false;
+    }
+#else
+    enumValue = Wrapper::getEnum(literal);
+#endif
+    return true;
+}
+
+template <typename Enum, typename Wrapper = typename EnumTraits<Enum>::Wrapper>
+std::enable_if_t<std::is_enum<Enum>::value, bool> tryStringToType(const std::string& literal,
+                                                                  Enum& enumValue)
+{
+    return tryGetEnum<Wrapper>(literal, enumValue);
+}
+
+} // namespace detail
+} // namespace muesli
+
+#endif // MUESLI_DETAIL_MAPKEYCONVERSION_H_
@@ -0,0 +1,220 @@
+/*
+ * #%L
+ * %%
+ * Copyright (C) 2011 - 2016 BMW Car IT GmbH
+ * %%
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ * 
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ * 
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ * #L%
+ */
+#ifndef MUESLI_DETAIL_PERFECTHASHTABLE_H_
+#define MUESLI_DETAIL_PERFECTHASHTABLE_H_
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <vector>
+
+namespace muesli
+{
+namespace detail
+{
+
+// immutable map from strings to values without collisions, built by hash and displace: the keys
+// are hashed into buckets of about four keys and for each bucket, largest first, a displacement
+// is searched which moves all of its keys to free slots
+// the table takes one displacement per bucket and 1.25 slots per key; a lookup hashes the key
+// once, reads the displacement of its bucket and compares the key with a single slot
+// each slot holds its key, short keys such as aliases are stored within the slot by
+// std::string, longer ones are allocated separately
+template <typename Value>
+class PerfectHashTable
+{
+public:
+    PerfectHashTable() : _seed(0), _displacements(), _slots()
+    {
+    }
+
+    // 'begin' and 'end' iterate over pairs of unique string keys and values
+    template <typename Iterator>
+    void build(Iterator begin, Iterator end)
+    {
+        std::vector<Iterator> entries;
+        for (Iterator it = begin; it != end; ++it) {
+            entries.push_back(it);
+        }
+        _displacements.clear();
+        _slots.clear();
+        if (entries.empty()) {
+            return;
+        }
+        const std::size_t slotCount = entries.size() + entries.size() / 4 + 1;
+        const std::size_t bucketCount = (entries.size() + 3) / 4;
+        std::vector<std::size_t> slotOfEntry;
+        std::uint64_t seed = 0;
+        while (!tryBuild(entries, seed, bucketCount, slotCount, slotOfEntry)) {
+            ++seed;
+        }
+        _seed = seed;
+        _slots.resize(slotCount);
+        for (std::size_t index = 0; index < entries.size(); ++index) {
+            Slot& slot = _slots[slotOfEntry[index]];
+            slot._used = true;
+            slot._key = entries[index]->first;
+            slot._value = entries[index]->second;
+        }
+    }
+
+    // returns nullptr if 'key' is unknown
+    const Value* find(const char* key, std::size_t length) const
+    {
+        if (_slots.empty()) {
+            return nullptr;
+        }
+        const std::uint64_t hash = hashKey(key, length, _seed);
+        const std::uint32_t displacement =
+                _displacements[reduce(hash, _displacements.size())];
+        const Slot& slot = _slots[reduce(displace(hash, displacement), _slots.size())];
+        if (slot._used && slot._key.size() == length &&
+            std::memcmp(slot._key.data(), key, length) == 0) {
+            return &slot._value;
+        }
+        return nullptr;
+    }
+
+    std::size_t getSlotCount() const
+    {
+        return _slots.size();
+    }
+
+private:
+    struct Slot
+    {
+        Slot() : _used(false), _key(), _value()
+        {
+        }
+
+        bool _used;
+        std::string _key;
+        Value _value;
+    };
+
+    // a new seed is tried if a bucket finds no displacement within this limit
+    static constexpr std::uint32_t maxDisplacement = 1 << 16;
+
+    // FNV-1a followed by a finalizer which spreads the bits over the whole word
+    static std::uint64_t hashKey(const char* key, std::size_t length, std::uint64_t seed)
+    {
+        std::uint64_t hash = 14695981039346656037ULL ^ (seed * 0x9e3779b97f4a7c15ULL);
+        for (std::size_t i = 0; i < length; ++i) {
+            hash ^= static_cast<unsigned char>(key[i]);
+            hash *= 1099511628211ULL;
+        }
+        hash ^= hash >> 33;
+        hash *= 0xff51afd7ed558ccdULL;
+        hash ^= hash >> 33;
+        return hash;
+    }
+
+    static std::uint64_t displace(std::uint64_t hash, std::uint32_t displacement)
+    {
+        hash ^= static_cast<std::uint64_t>(displacement) * 0x9e3779b97f4a7c15ULL;
+        hash ^= hash >> 32;
+        hash *= 0xd6e8feb86659fd93ULL;
+        hash ^= hash >> 32;
+        return hash;
+    }
+
+    // maps the upper 32 bits of 'hash' to [0, size) without a division
+    static std::size_t reduce(std::uint64_t hash, std::size_t size)
+    {
+        return static_cast<std::size_t>(((hash >> 32) * static_cast<std::uint64_t>(size)) >> 32);
+    }
+
+    template <typename Iterator>
+    bool tryBuild(const std::vector<Iterator>& entries,
+                  std::uint64_t seed,
+                  std::size_t bucketCount,
+                  std::size_t slotCount,
+                  std::vector<std::size_t>& slotOfEntry)
+    {
+        std::vector<std::uint64_t> hashes;
+        std::vector<std::vector<std::size_t>> buckets(bucketCount);
+        for (std::size_t index = 0; index < entries.size(); ++index) {
+            const std::string& key = entries[index]->first;
+            hashes.push_back(hashKey(key.data(), key.size(), seed));
+            buckets[reduce(hashes.back(), bucketCount)].push_back(index);
+        }
+        std::vector<std::size_t> bucketOrder(bucketCount);
+        for (std::size_t bucket = 0; bucket < bucketCount; ++bucket) {
+            bucketOrder[bucket] = bucket;
+        }
+        std::stable_sort(bucketOrder.begin(),
+                         bucketOrder.end(),
+                         [&buckets](std::size_t lhs, std::size_t rhs) {
+                             return buckets[lhs].size() > buckets[rhs].size();
+                         });
+
+        std::vector<bool> occupied(slotCount, false);
+        std::vector<std::size_t> bucketSlots;
+        _displacements.assign(bucketCount, 0);
+        slotOfEntry.assign(entries.size(), 0);
+        for (std::size_t bucket : bucketOrder) {
+            const std::vector<std::size_t>& bucketEntries = buckets[bucket];
+            if (bucketEntries.empty()) {
+                break;
+            }
+            std::uint32_t displacement = 0;
+            while (!tryDisplace(bucketEntries, hashes, displacement, occupied, bucketSlots)) {
+                if (++displacement == maxDisplacement) {
+                    return false;
+                }
+            }
+            _displacements[bucket] = displacement;
+            for (std::size_t i = 0; i < bucketEntries.size(); ++i) {
+                occupied[bucketSlots[i]] = true;
+                slotOfEntry[bucketEntries[i]] = bucketSlots[i];
+            }
+        }
+        return true;
+    }
+
+    // true if 'displacement' moves all entries of a bucket to distinct free slots
+    static bool tryDisplace(const std::vector<std::size_t>& bucketEntries,
+                            const std::vector<std::uint64_t>& hashes,
+                            std::uint32_t displacement,
+                            const std::vector<bool>& occupied,
+                            std::vector<std::size_t>& bucketSlots)
+    {
+        bucketSlots.clear();
+        for (std::size_t entry : bucketEntries) {
+            const std::size_t slot = reduce(displace(hashes[entry], displacement), occupied.size());
+            if (occupied[slot] ||
+                std::find(bucketSlots.cbegin(), bucketSlots.cend(), slot) != bucketSlots.cend()) {
+                return false;
+            }
+            bucketSlots.push_back(slot);
+        }
+        return true;
+    }
+
+    std::uint64_t _seed;
+    std::vector<std::uint32_t> _displacements;
+    std::vector<Slot> _slots;
+};
+
+} // namespace detail
+} // namespace muesli
+
+#endif // MUESLI_DETAIL_PERFECTHASHTABLE_H_
@@ -0,0 +1,288 @@
+/*
+ * #%L
+ * %%
+ * Copyright (C) 2011 - 2016 BMW Car IT GmbH
+ * %%
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ * 
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ * 
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ * #L%
+ */
+#ifndef MUESLI_DETAIL_PUBLISHEDSNAPSHOT_H_
+#define MUESLI_DETAIL_PUBLISHEDSNAPSHOT_H_
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <mutex>
+#include <thread>
+#include <utility>
+#include <vector>
+
+namespace muesli
+{
+namespace detail
+{
+
+class DeferredPublication
+{
+public:
+    virtual void publish() = 0;
+
+protected:
+    DeferredPublication() = default;
+    ~DeferredPublication() = default;
+};
+
+// while a PublicationBatch exists, PublishedSnapshots defer the publication of modifications
+// until the last batch ends, e.g. so that a plugin publishes each registry once after registering
+// all of its types; batches are global, they defer modifications made by all threads
+class PublicationBatch
+{
+public:
+    PublicationBatch()
+    {
+        State& state = getState();
+        std::lock_guard<std::mutex> lock(state._mutex);
+        ++state._depth;
+    }
+
+    ~PublicationBatch()
+    {
+        State& state = getState();
+        std::vector<DeferredPublication*> deferred;
+        {
+            std::lock_guard<std::mutex> lock(state._mutex);
+            if (--state._depth == 0) {
+                deferred.swap(state._deferred);
+            }
+        }
+        for (DeferredPublication* publication : deferred) {
+            publication->publish();
+        }
+    }
+
+    PublicationBatch(const PublicationBatch&) = delete;
+    PublicationBatch& operator=(const PublicationBatch&) = delete;
+
+    // returns false if no batch is open, otherwise 'publication' is published when it ends
+    static bool defer(DeferredPublication& publication)
+    {
+        State& state = getState();
+        std::lock_guard<std::mutex> lock(state._mutex);
+        if (state._depth == 0) {
+            return false;
+        }
+        if (std::find(state._deferred.cbegin(), state._deferred.cend(), &publication) ==
+            state._deferred.cend()) {
+            state._deferred.push_back(&publication);
+        }
+        return true;
+    }
+
+    static void cancel(DeferredPublication& publication)
+    {
+        State& state = getState();
+        std::lock_guard<std::mutex> lock(state._mutex);
+        state._deferred.erase(
+                std::remove(state._deferred.begin(), state._deferred.end(), &publication),
+                state._deferred.end());
+    }
+
+private:
+    struct State
+    {
+        State() : _mutex(), _depth(0), _deferred()
+        {
+        }
+
+        std::mutex _mutex;
+        std::size_t _depth;
+        std::vector<DeferredPublication*> _deferred;
+    };
+
+    static State& getState()
+    {
+        static State state;
+        return state;
+    }
+};
+
+// RCU-style publication of immutable snapshots of a mutable 'Pending' state
+// a writer modifies the pending state under a mutex; the first read after the modification
+// builds a new 'Snapshot' from it and publishes it through an atomic pointer, so modifications
+// in a row, e.g. the registrations during static initialization, are published at once; while
+// a PublicationBatch is open, publication waits for the batch instead; readers which find the
+// current snapshot up to date neither lock nor build snapshots
+// readers announce themselves in counters of the current epoch, which are spread over several
+// cache lines to avoid contention; after publishing, a writer starts a new epoch and waits until
+// the readers of the previous one have left before it deletes the superseded snapshot, hence
+// only the current snapshot is kept
+template <typename Pending, typename Snapshot>
+class PublishedSnapshot : DeferredPublication
+{
+public:
+    PublishedSnapshot()
+            : DeferredPublication(),
+              _pending(),
+              _current(new Snapshot(_pending)),
+              _epoch(0),
+              _readers(),
+              _stale(false),
+              _deferred(false),
+              _mutex()
+    {
+    }
+
+    ~PublishedSnapshot()
+    {
+        if (_deferred) {
+            PublicationBatch::cancel(*this);
+        }
+        delete _current.load();
+    }
+
+    PublishedSnapshot(const PublishedSnapshot&) = delete;
+    PublishedSnapshot& operator=(const PublishedSnapshot&) = delete;
+
+    // 'modify' is called with the pending state, safe to call concurrently with reads
+    template <typename Modify>
+    void modify(Modify&& modify)
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        modify(_pending);
+        if (PublicationBatch::defer(*this)) {
+            _deferred = true;
+        }
+        _stale.store(true, std::memory_order_release);
+    }
+
+    // calls 'read' with the current snapshot and returns its result
+    // the snapshot must not be referenced after 'read' has returned
+    template <typename Read>
+    auto read(Read&& read) -> decltype(read(std::declval<const Snapshot&>()))
+    {
+        if (_stale.load(std::memory_order_acquire)) {
+            publishUnlessDeferred();
+        }
+        const ReadSection section(*this);
+        return read(*_current.load());
+    }
+
+    // publishes pending modifications right away, also the ones deferred by an open
+    // PublicationBatch
+    void publish() override
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        if (_stale.load(std::memory_order_relaxed)) {
+            publishLocked();
+        }
+    }
+
+    // true unless modifications wait for the next read or for an open PublicationBatch
+    bool isPublished()
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        return !_stale.load(std::memory_order_relaxed);
+    }
+
+private:
+    static constexpr std::size_t readerStripes = 8;
+
+    struct alignas(64) ReaderCounts
+    {
+        ReaderCounts() : _counts()
+        {
+            _counts[0] = 0;
+            _counts[1] = 0;
+        }
+
+        std::atomic<std::size_t> _counts[2];
+    };
+
+    // announces a reader in the counters of the current epoch
+    class ReadSection
+    {
+    public:
+        explicit ReadSection(PublishedSnapshot& snapshot)
+                : _counts(snapshot._readers[getReaderStripe()]._counts), _index(0)
+        {
+            // a writer which starts a new epoch in the meantime does not wait for this reader,
+            // hence the epoch is checked again after the reader has been counted
+            while (true) {
+                const std::size_t epoch = snapshot._epoch.load();
+                _index = epoch & 1;
+                _counts[_index].fetch_add(1);
+                if (snapshot._epoch.load() == epoch) {
+                    return;
+                }
+                _counts[_index].fetch_sub(1);
+            }
+        }
+
+        ~ReadSection()
+        {
+            _counts[_index].fetch_sub(1);
+        }
+
+        ReadSection(const ReadSection&) = delete;
+        ReadSection& operator=(const ReadSection&) = delete;
+
+    private:
+        std::atomic<std::size_t>* _counts;
+        std::size_t _index;
+    };
+
+    static std::size_t getReaderStripe()
+    {
+        static std::atomic<std::size_t> nextStripe(0);
+        thread_local const std::size_t stripe = nextStripe++ % readerStripes;
+        return stripe;
+    }
+
+    void publishUnlessDeferred()
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        if (_stale.load(std::memory_order_relaxed) && !_deferred) {
+            publishLocked();
+        }
+    }
+
+    void publishLocked()
+    {
+        const Snapshot* superseded = _current.exchange(new Snapshot(_pending));
+        _stale.store(false, std::memory_order_release);
+        _deferred = false;
+        const std::size_t previousEpoch = _epoch.fetch_add(1) & 1;
+        for (ReaderCounts& readers : _readers) {
+            while (readers._counts[previousEpoch].load() != 0) {
+                std::this_thread::yield();
+            }
+        }
+        delete superseded;
+    }
+
+    Pending _pending;
+    std::atomic<const Snapshot*> _current;
+    std::atomic<std::size_t> _epoch;
+    std::array<ReaderCounts, readerStripes> _readers;
+    // the pending state has modifications which have not been published yet
+    std::atomic<bool> _stale;
+    // the modifications wait for an open PublicationBatch
+    bool _deferred;
+    std::mutex _mutex;
+};
+
+} // namespace detail
+} // namespace muesli
+
+#endif // MUESLI_DETAIL_PUBLISHEDSNAPSHOT_H_
@@ -0,0 +1,76 @@
+/*
+ * #%L
+ * %%
+ * Copyright (C) 2011 - 2016 BMW Car IT GmbH
+ * %%
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ * 
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ * 
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ * #L%
+ */
+
+#ifndef MUESLI_DETAIL_READFROMSTREAM_H_
+#define MUESLI_DETAIL_READFROMSTREAM_H_
+
+#include <cstddef>
+#include <type_traits>
+#include <utility>
+
+#include "muesli/detail/VoidT.h"
+
+namespace muesli
+{
+namespace detail
+{
+
+// true if 'InputStream' provides std::size_t read(Char*, std::size_t), which is optional for
+// InputStreams and reports how many characters were extracted
+template <typename InputStream, typename = void>
+struct HasRead : std::false_type
+{
+};
+
+template <typename InputStream>
+struct HasRead<InputStream,
+               VoidT<decltype(std::declval<std::size_t&>() = std::declval<InputStream&>().read(
+                                      std::declval<typename InputStream::Char*>(),
+                                      std::declval<std::size_t>()))>> : std::true_type
+{
+};
+
+// extracts up to 'size' characters from 'stream' and returns how many were extracted
+template <typename InputStream>
+std::enable_if_t<HasRead<InputStream>::value, std::size_t> readFromStream(
+        InputStream& stream,
+        typename InputStream::Char* destination,
+        std::size_t size)
+{
+    return stream.read(destination, size);
+}
+
+// InputStreams without read() cannot report the end of the input, they are read character by
+// character and all 'size' characters are reported as extracted
+template <typename InputStream>
+std::enable_if_t<!HasRead<InputStream>::value, std::size_t> readFromStream(
+        InputStream& stream,
+        typename InputStream::Char* destination,
+        std::size_t size)
+{
+    for (std::size_t i = 0; i < size; ++i) {
+        destination[i] = stream.get();
+    }
+    return size;
+}
+
+} // namespace detail
+} // namespace muesli
+
+#endif // MUESLI_DETAIL_READFROMSTREAM_H_
@@ -0,0 +1,56 @@
+/*
+ * #%L
+ * %%
+ * Copyright (C) 2011 - 2016 BMW Car IT GmbH
+ * %%
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ * 
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ * 
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ * #L%
+ */
+#ifndef MUESLI_DETAIL_SCOPEDASSIGNMENT_H_
+#define MUESLI_DETAIL_SCOPEDASSIGNMENT_H_
+
+#include <utility>
+
+namespace muesli
+{
+namespace detail
+{
+
+// assigns 'value' to 'variable' and restores the previous value at the end of the scope, also
+// when it is left by an exception
+template <typename T>
+class ScopedAssignment
+{
+public:
+    ScopedAssignment(T& variable, T value) : _variable(variable), _previous(std::move(variable))
+    {
+        _variable = std::move(value);
+    }
+
+    ~ScopedAssignment()
+    {
+        _variable = std::move(_previous);
+    }
+
+    ScopedAssignment(const ScopedAssignment&) = delete;
+    ScopedAssignment& operator=(const ScopedAssignment&) = delete;
+
+private:
+    T& _variable;
+    T _previous;
+};
+
+} // namespace detail
+} // namespace muesli
+
+#endif // MUESLI_DETAIL_SCOPEDASSIGNMENT_H_
@@ -20,7 +20,8 @@
 #ifndef MUESLI_DETAIL_TYPELIST_H_
 #define MUESLI_DETAIL_TYPELIST_H_
 
-#include <boost/mpl/fold.hpp>
+#include <cstddef>
+#include <type_traits>
 
 namespace muesli
 {
@@ -41,21 +42,31 @@ struct Append<T, TypeList<Ts...>>
     using type = TypeList<Ts..., T>;
 };
 
-template <typename MplSequence>
-struct MplSequenceToTypeList
+template <typename TList>
+struct ListSize;
+
+template <typename... Ts>
+struct ListSize<TypeList<Ts...>> : std::integral_constant<std::size_t, sizeof...(Ts)>
 {
-    using type = typename boost::mpl::fold<MplSequence,
-                                           TypeList<>,
-                                           Append<boost::mpl::_2, boost::mpl::_1>>::type;
 };
 
-template <typename TList>
-struct TypeListToMplVector;
+// concatenates any number of TypeLists into a single TypeList
+template <typename... TLists>
+struct Concat
+{
+    using type = TypeList<>;
+};
 
 template <typename... Ts>
-struct TypeListToMplVector<TypeList<Ts...>>
+struct Concat<TypeList<Ts...>>
+{
+    using type = TypeList<Ts...>;
+};
+
+template <typename... Ts, typename... Us, typename... TLists>
+struct Concat<TypeList<Ts...>, TypeList<Us...>, TLists...>
 {
-    using type = typename boost::mpl::vector<Ts...>;
+    using type = typename Concat<TypeList<Ts..., Us...>, TLists...>::type;
 };
 
 } // namespace detail
@@ -0,0 +1,188 @@
+/*
+ * #%L
+ * %%
+ * Copyright (C) 2011 - 2016 BMW Car IT GmbH
+ * %%
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ * 
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ * 
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ * #L%
+ */
+
+#ifndef MUESLI_STREAMS_ANYISTREAM_H_
+#define MUESLI_STREAMS_ANYISTREAM_H_
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <istream>
+#include <type_traits>
+
+#include "muesli/StreamRegistry.h"
+#include "muesli/detail/ReadFromStream.h"
+
+namespace muesli
+{
+
+/**
+ * Type-erased InputStream. The underlying stream is read block-wise into a buffer, so there is
+ * one virtual call per block instead of one per character.
+ * Archives instantiated for AnyIStream can read from any stream wrapped in an AnyIStreamWrapper.
+ */
+class AnyIStream
+{
+public:
+    using Char = char;
+
+    virtual ~AnyIStream() = default;
+
+    Char peek()
+    {
+        if (_position == _end && !refill()) {
+            return '\0';
+        }
+        return _buffer[_position];
+    }
+
+    Char get()
+    {
+        if (_position == _end && !refill()) {
+            return '\0';
+        }
+        return _buffer[_position++];
+    }
+
+    void get(Char* destination, std::size_t destinationSize)
+    {
+        const std::size_t count = read(destination, destinationSize);
+        if (count < destinationSize) {
+            destination[count] = '\0';
+        }
+    }
+
+    // extracts up to 'destinationSize' characters and returns how many were extracted
+    // less than 'destinationSize' characters are extracted only at the end of the stream
+    std::size_t read(Char* destination, std::size_t destinationSize)
+    {
+        std::size_t count = 0;
+        while (count < destinationSize) {
+            if (_position == _end && !refill()) {
+                break;
+            }
+            const std::size_t chunk = std::min(destinationSize - count, _end - _position);
+            std::copy(_buffer.data() + _position,
+                      _buffer.data() + _position + chunk,
+                      destination + count);
+            _position += chunk;
+            count += chunk;
+        }
+        return count;
+    }
+
+    std::size_t tell() const
+    {
+        return _bufferOffset + _position;
+    }
+
+    // non-copyable
+    AnyIStream(const AnyIStream&) = delete;
+    AnyIStream& operator=(const AnyIStream&) = delete;
+
+protected:
+    AnyIStream() : _buffer(), _bufferOffset(0), _position(0), _end(0)
+    {
+    }
+
+    // reads at most `size` characters from the underlying stream and returns how many were read,
+    // 0 signals the end of the stream
+    virtual std::size_t readBlock(Char* destination, std::size_t size) = 0;
+
+private:
+    bool refill()
+    {
+        _bufferOffset += _end;
+        _position = 0;
+        _end = readBlock(_buffer.data(), _buffer.size());
+        return _end > 0;
+    }
+
+    std::array<Char, 4096> _buffer;
+    // stream position of the first character in '_buffer'
+    std::size_t _bufferOffset;
+    std::size_t _position;
+    std::size_t _end;
+};
+
+namespace detail
+{
+
+// InputStreams providing read() report how many characters were extracted
+template <typename InputStream>
+std::enable_if_t<!std::is_base_of<std::istream, InputStream>::value && HasRead<InputStream>::value,
+                 std::size_t>
+readBlock(InputStream& stream, char* destination, std::size_t size)
+{
+    return stream.read(destination, size);
+}
+
+// other InputStreams are read character by character up to the '\0' which peek() returns at the
+// end of the input
+template <typename InputStream>
+std::enable_if_t<!std::is_base_of<std::istream, InputStream>::value && !HasRead<InputStream>::value,
+                 std::size_t>
+readBlock(InputStream& stream, char* destination, std::size_t size)
+{
+    std::size_t count = 0;
+    while (count < size && stream.peek() != '\0') {
+        destination[count++] = stream.get();
+    }
+    return count;
+}
+
+template <typename InputStream>
+std::enable_if_t<std::is_base_of<std::istream, InputStream>::value, std::size_t> readBlock(
+        InputStream& stream,
+        char* destination,
+        std::size_t size)
+{
+    return static_cast<std::size_t>(
+            stream.rdbuf()->sgetn(destination, static_cast<std::streamsize>(size)));
+}
+
+} // namespace detail
+
+/**
+ * Wraps an InputStream or a std::istream into an AnyIStream.
+ * The wrapped stream is read ahead by up to one buffer.
+ */
+template <typename InputStream>
+class AnyIStreamWrapper : public AnyIStream
+{
+public:
+    explicit AnyIStreamWrapper(InputStream& stream) : AnyIStream(), _stream(stream)
+    {
+    }
+
+protected:
+    std::size_t readBlock(Char* destination, std::size_t size) override
+    {
+        return detail::readBlock(_stream, destination, size);
+    }
+
+private:
+    InputStream& _stream;
+};
+
+} // namespace muesli
+
+MUESLI_REGISTER_INPUT_STREAM(muesli::AnyIStream)
+
+#endif // MUESLI_STREAMS_ANYISTREAM_H_
@@ -0,0 +1,158 @@
+/*
+ * #%L
+ * %%
+ * Copyright (C) 2011 - 2016 BMW Car IT GmbH
+ * %%
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ * 
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ * 
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ * #L%
+ */
+
+#ifndef MUESLI_STREAMS_ANYOSTREAM_H_
+#define MUESLI_STREAMS_ANYOSTREAM_H_
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <ostream>
+#include <type_traits>
+
+#include "muesli/StreamRegistry.h"
+
+namespace muesli
+{
+
+/**
+ * Type-erased OutputStream. Characters are collected in a buffer and handed to the underlying
+ * stream block-wise, so there is one virtual call per block instead of one per character.
+ * Archives instantiated for AnyOStream can write to any stream wrapped in an AnyOStreamWrapper.
+ */
+class AnyOStream
+{
+public:
+    using Char = char;
+
+    virtual ~AnyOStream() = default;
+
+    void put(Char c)
+    {
+        if (_size == _buffer.size()) {
+            flushBuffer();
+        }
+        _buffer[_size++] = c;
+    }
+
+    void write(const Char* s, std::size_t size)
+    {
+        if (size > _buffer.size() - _size) {
+            flushBuffer();
+            if (size >= _buffer.size()) {
+                writeBlock(s, size);
+                return;
+            }
+        }
+        std::copy(s, s + size, _buffer.data() + _size);
+        _size += size;
+    }
+
+    void flush()
+    {
+        flushBuffer();
+        flushStream();
+    }
+
+    // non-copyable
+    AnyOStream(const AnyOStream&) = delete;
+    AnyOStream& operator=(const AnyOStream&) = delete;
+
+protected:
+    AnyOStream() : _buffer(), _size(0)
+    {
+    }
+
+    // hands a block of characters to the underlying stream
+    virtual void writeBlock(const Char* s, std::size_t size) = 0;
+    virtual void flushStream() = 0;
+
+    void flushBuffer()
+    {
+        if (_size > 0) {
+            writeBlock(_buffer.data(), _size);
+            _size = 0;
+        }
+    }
+
+private:
+    std::array<Char, 4096> _buffer;
+    std::size_t _size;
+};
+
+namespace detail
+{
+
+template <typename OutputStream>
+std::enable_if_t<!std::is_base_of<std::ostream, OutputStream>::value> writeBlock(
+        OutputStream& stream,
+        const char* s,
+        std::size_t size)
+{
+    stream.write(s, size);
+}
+
+template <typename OutputStream>
+std::enable_if_t<std::is_base_of<std::ostream, OutputStream>::value> writeBlock(
+        OutputStream& stream,
+        const char* s,
+        std::size_t size)
+{
+    stream.write(s, static_cast<std::streamsize>(size));
+}
+
+} // namespace detail
+
+/**
+ * Wraps an OutputStream or a std::ostream into an AnyOStream.
+ * Buffered characters are written to the wrapped stream on flush() and on destruction.
+ */
+template <typename OutputStream>
+class AnyOStreamWrapper : public AnyOStream
+{
+public:
+    explicit AnyOStreamWrapper(OutputStream& stream) : AnyOStream(), _stream(stream)
+    {
+    }
+
+    ~AnyOStreamWrapper() override
+    {
+        flushBuffer();
+    }
+
+protected:
+    void writeBlock(const Char* s, std::size_t size) override
+    {
+        detail::writeBlock(_stream, s, size);
+    }
+
+    void flushStream() override
+    {
+        _stream.flush();
+    }
+
+private:
+    OutputStream& _stream;
+};
+
+} // namespace muesli
+
+MUESLI_REGISTER_OUTPUT_STREAM(muesli::AnyOStream)
+
+#endif // MUESLI_STREAMS_ANYOSTREAM_H_
@@ -52,6 +52,14 @@ public:
         _stream.get(s, static_cast<std::int64_t>(size));
     }
 
+    // extracts up to 'size' characters and returns how many were extracted
+    // unlike get(Char*, std::size_t) this does not stop at '\n'
+    std::size_t read(Char* s, std::size_t size)
+    {
+        _stream.read(s, static_cast<std::streamsize>(size));
+        return static_cast<std::size_t>(_stream.gcount());
+    }
+
     std::size_t tell() const
     {
         return static_cast<std::size_t>(_stream.tellg());
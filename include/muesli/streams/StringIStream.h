@@ -20,6 +20,7 @@
 #ifndef MUESLI_STREAMS_STRINGISTREAM_H_
 #define MUESLI_STREAMS_STRINGISTREAM_H_
 
+#include <algorithm>
 #include <string>
 #include "muesli/StreamRegistry.h"
 
@@ -79,6 +80,24 @@ public:
         }
     }
 
+    // extracts up to 'destinationSize' characters and returns how many were extracted
+    // less than 'destinationSize' characters are extracted only at the end of the input
+    std::size_t read(Char* destination, std::size_t destinationSize)
+    {
+        if (_currentCharIndex >= _inputLength) {
+            return 0;
+        }
+
+        std::size_t copyableCharacterCount =
+                std::min(destinationSize, _inputLength - _currentCharIndex);
+
+        _input.copy(destination, copyableCharacterCount, _currentCharIndex);
+
+        _currentCharIndex += copyableCharacterCount;
+
+        return copyableCharacterCount;
+    }
+
     std::size_t tell() const
     {
         return _currentCharIndex;
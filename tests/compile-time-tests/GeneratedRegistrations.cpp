@@ -0,0 +1,144 @@
+/*
+ * #%L
+ * %%
+ * Copyright (C) 2011 - 2016 BMW Car IT GmbH
+ * %%
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ * 
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ * 
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ * #L%
+ */
+
+// synthesizes MUESLI_COMPILE_TIME_TYPE_COUNT structs which are serialized through the dispatch
+// traits, as many polymorphic types registered in the type registry and
+// MUESLI_COMPILE_TIME_STREAM_COUNT additional input and output streams, which multiply the
+// archive/stream combinations every polymorphic type is registered for
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <boost/preprocessor/cat.hpp>
+#include <boost/preprocessor/repetition/repeat.hpp>
+#include <boost/preprocessor/stringize.hpp>
+
+#include "muesli/archives/binary/BinaryInputArchive.h"
+#include "muesli/archives/binary/BinaryOutputArchive.h"
+#include "muesli/archives/json/JsonInputArchive.h"
+#include "muesli/archives/json/JsonOutputArchive.h"
+
+#include "muesli/streams/StringIStream.h"
+#include "muesli/streams/StringOStream.h"
+
+#ifndef MUESLI_COMPILE_TIME_TYPE_COUNT
+#define MUESLI_COMPILE_TIME_TYPE_COUNT 16
+#endif // MUESLI_COMPILE_TIME_TYPE_COUNT
+
+#ifndef MUESLI_COMPILE_TIME_STREAM_COUNT
+#define MUESLI_COMPILE_TIME_STREAM_COUNT 1
+#endif // MUESLI_COMPILE_TIME_STREAM_COUNT
+
+namespace generated
+{
+
+template <int N>
+class OStream : public muesli::StringOStream
+{
+};
+
+template <int N>
+class IStream : public muesli::StringIStream
+{
+public:
+    using muesli::StringIStream::StringIStream;
+};
+
+} // namespace generated
+
+#define MUESLI_COMPILE_TIME_REGISTER_STREAM(z, n, unused)                                          \
+    MUESLI_REGISTER_OUTPUT_STREAM(generated::OStream<n>)                                           \
+    MUESLI_REGISTER_INPUT_STREAM(generated::IStream<n>)
+
+BOOST_PP_REPEAT(MUESLI_COMPILE_TIME_STREAM_COUNT, MUESLI_COMPILE_TIME_REGISTER_STREAM, ~)
+
+#include "muesli/NameValuePair.h"
+#include "muesli/TypeRegistry.h"
+
+namespace generated
+{
+
+#define MUESLI_COMPILE_TIME_DEFINE_STRUCT(z, n, unused)                                            \
+    struct BOOST_PP_CAT(Struct, n)                                                                 \
+    {                                                                                              \
+        template <typename Archive>                                                                \
+        void serialize(Archive& archive)                                                           \
+        {                                                                                          \
+            archive(muesli::make_nvp("number", _number),                                           \
+                    muesli::make_nvp("text", _text),                                               \
+                    muesli::make_nvp("values", _values));                                          \
+        }                                                                                          \
+        std::int32_t _number = n;                                                                  \
+        std::string _text;                                                                         \
+        std::vector<double> _values;                                                               \
+    };
+
+BOOST_PP_REPEAT(MUESLI_COMPILE_TIME_TYPE_COUNT, MUESLI_COMPILE_TIME_DEFINE_STRUCT, ~)
+
+struct Base
+{
+    virtual ~Base() = default;
+    template <typename Archive>
+    void serialize(Archive&)
+    {
+    }
+};
+
+#define MUESLI_COMPILE_TIME_DEFINE_DERIVED(z, n, unused)                                           \
+    struct BOOST_PP_CAT(Derived, n) : Base                                                         \
+    {                                                                                              \
+        template <typename Archive>                                                                \
+        void serialize(Archive& archive)                                                           \
+        {                                                                                          \
+            archive(muesli::make_nvp("value", _value));                                            \
+        }                                                                                          \
+        std::int32_t _value = n;                                                                   \
+    };
+
+BOOST_PP_REPEAT(MUESLI_COMPILE_TIME_TYPE_COUNT, MUESLI_COMPILE_TIME_DEFINE_DERIVED, ~)
+
+} // namespace generated
+
+MUESLI_REGISTER_TYPE(generated::Base, "generated.Base")
+
+#define MUESLI_COMPILE_TIME_REGISTER_DERIVED(z, n, unused)                                         \
+    MUESLI_REGISTER_POLYMORPHIC_TYPE(generated::BOOST_PP_CAT(Derived, n),                          \
+                                     generated::Base,                                              \
+                                     "generated.Derived" BOOST_PP_STRINGIZE(n))
+
+BOOST_PP_REPEAT(MUESLI_COMPILE_TIME_TYPE_COUNT, MUESLI_COMPILE_TIME_REGISTER_DERIVED, ~)
+
+#define MUESLI_COMPILE_TIME_ROUND_TRIP_STRUCT(z, n, unused)                                        \
+    {                                                                                              \
+        generated::BOOST_PP_CAT(Struct, n) value;                                                  \
+        muesli::StringOStream outputStream;                                                        \
+        muesli::JsonOutputArchive<muesli::StringOStream> outputArchive(outputStream);              \
+        outputArchive(value);                                                                      \
+        muesli::StringIStream inputStream(outputStream.getString());                               \
+        muesli::JsonInputArchive<muesli::StringIStream> inputArchive(inputStream);                 \
+        inputArchive(value);                                                                       \
+    }
+
+int main()
+{
+    BOOST_PP_REPEAT(MUESLI_COMPILE_TIME_TYPE_COUNT, MUESLI_COMPILE_TIME_ROUND_TRIP_STRUCT, ~)
+    return 0;
+}
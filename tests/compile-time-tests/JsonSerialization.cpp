@@ -0,0 +1,132 @@
+/*
+ * #%L
+ * %%
+ * Copyright (C) 2011 - 2016 BMW Car IT GmbH
+ * %%
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ * 
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ * 
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ * #L%
+ */
+
+// typical JSON (de)serialization code, compiled once against the header-only library and once
+// against muesli_json to compare compile times
+
+#include <cstdint>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "muesli/NameValuePair.h"
+#include "muesli/archives/json/ExternTemplates.h"
+
+namespace
+{
+struct Position
+{
+    double _latitude;
+    double _longitude;
+    float _altitude;
+
+    template <typename Archive>
+    void serialize(Archive& archive)
+    {
+        archive(muesli::make_nvp("latitude", _latitude),
+                muesli::make_nvp("longitude", _longitude),
+                muesli::make_nvp("altitude", _altitude));
+    }
+};
+
+struct Vehicle
+{
+    std::string _vin;
+    std::uint32_t _mileage;
+    std::int16_t _temperature;
+    bool _moving;
+    std::vector<std::uint8_t> _doorStates;
+    std::vector<std::string> _drivers;
+    std::vector<double> _tirePressures;
+
+    template <typename Archive>
+    void serialize(Archive& archive)
+    {
+        archive(muesli::make_nvp("vin", _vin),
+                muesli::make_nvp("mileage", _mileage),
+                muesli::make_nvp("temperature", _temperature),
+                muesli::make_nvp("moving", _moving),
+                muesli::make_nvp("doorStates", _doorStates),
+                muesli::make_nvp("drivers", _drivers),
+                muesli::make_nvp("tirePressures", _tirePressures));
+    }
+};
+
+struct Trip
+{
+    std::uint64_t _id;
+    std::int64_t _startTime;
+    std::int32_t _durationSeconds;
+    std::int8_t _rating;
+    std::uint16_t _passengers;
+    Vehicle _vehicle;
+    Position _start;
+    Position _destination;
+    std::vector<std::int32_t> _speeds;
+    std::vector<bool> _stops;
+
+    template <typename Archive>
+    void serialize(Archive& archive)
+    {
+        archive(muesli::make_nvp("id", _id),
+                muesli::make_nvp("startTime", _startTime),
+                muesli::make_nvp("durationSeconds", _durationSeconds),
+                muesli::make_nvp("rating", _rating),
+                muesli::make_nvp("passengers", _passengers),
+                muesli::make_nvp("vehicle", _vehicle),
+                muesli::make_nvp("start", _start),
+                muesli::make_nvp("destination", _destination),
+                muesli::make_nvp("speeds", _speeds),
+                muesli::make_nvp("stops", _stops));
+    }
+};
+
+template <typename OutputStream, typename T>
+void write(OutputStream& stream, const T& value)
+{
+    muesli::JsonOutputArchive<OutputStream> jsonOutputArchive(stream);
+    jsonOutputArchive(value);
+}
+
+template <typename InputStream, typename T>
+void read(InputStream& stream, T& value)
+{
+    muesli::JsonInputArchive<InputStream> jsonInputArchive(stream);
+    jsonInputArchive(value);
+}
+} // namespace
+
+int main()
+{
+    Trip trip{};
+    trip._vehicle._drivers.push_back("driver");
+
+    muesli::StringOStream stringOStream;
+    write(stringOStream, trip);
+    muesli::StringIStream stringIStream(stringOStream.getString());
+    read(stringIStream, trip);
+
+    std::stringstream stringStream;
+    muesli::StdOStreamWrapper<std::ostream> stdOStream(stringStream);
+    write(stdOStream, trip);
+    muesli::StdIStreamWrapper<std::istream> stdIStream(stringStream);
+    read(stdIStream, trip);
+
+    return trip._vehicle._drivers.size() == 1 ? 0 : 1;
+}
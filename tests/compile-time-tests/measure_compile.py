@@ -0,0 +1,65 @@
+#!/usr/bin/env python3
+#
+# #%L
+# %%
+# Copyright (C) 2011 - 2016 BMW Car IT GmbH
+# %%
+# Licensed under the Apache License, Version 2.0 (the "License");
+# you may not use this file except in compliance with the License.
+# You may obtain a copy of the License at
+#
+#      http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing, software
+# distributed under the License is distributed on an "AS IS" BASIS,
+# WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+# See the License for the specific language governing permissions and
+# limitations under the License.
+# #L%
+#
+
+"""Compiler launcher which measures wall time and peak memory of one compilation.
+
+Usage: measure_compile.py <report.csv> <compiler> <arguments...>
+
+One line "object,seconds,peak kilobytes" is appended to the report per compilation.
+"""
+
+import os
+import resource
+import subprocess
+import sys
+import time
+
+
+def object_name(arguments):
+    if "-o" in arguments[:-1]:
+        return arguments[arguments.index("-o") + 1]
+    return arguments[-1]
+
+
+def main():
+    if len(sys.argv) < 3:
+        sys.stderr.write(__doc__)
+        return 2
+    report = sys.argv[1]
+    command = sys.argv[2:]
+
+    start = time.time()
+    result = subprocess.call(command)
+    seconds = time.time() - start
+    # ru_maxrss is reported in kilobytes on Linux
+    peak_kilobytes = resource.getrusage(resource.RUSAGE_CHILDREN).ru_maxrss
+
+    if result == 0:
+        name = object_name(command)
+        line = "{},{:.2f},{}".format(name, seconds, peak_kilobytes)
+        print("compiled {} in {:.2f} s using {} MB".format(
+            os.path.basename(name), seconds, peak_kilobytes // 1024))
+        with open(report, "a") as report_file:
+            report_file.write(line + "\n")
+    return result
+
+
+if __name__ == "__main__":
+    sys.exit(main())
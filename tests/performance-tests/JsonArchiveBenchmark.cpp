@@ -17,21 +17,95 @@
  * #L%
  */
 
+#include <memory>
 #include <sstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
 
 #include <benchmark/benchmark.h>
 
+#include "muesli/LoadError.h"
+#include "muesli/NameValuePair.h"
 #include "muesli/archives/json/JsonInputArchive.h"
 #include "muesli/archives/json/JsonOutputArchive.h"
 
+#include "muesli/streams/AnyOStream.h"
 #include "muesli/streams/StdIStreamWrapper.h"
 #include "muesli/streams/StdOStreamWrapper.h"
 
 #include "muesli/streams/StringIStream.h"
 #include "muesli/streams/StringOStream.h"
 
+#include "muesli/TypeRegistry.h"
+
 #include "../unit-tests/testtypes/TStructExtended.h"
 
+namespace shapes
+{
+
+struct Shape
+{
+    virtual ~Shape() = default;
+    virtual double area() const = 0;
+};
+
+struct Circle : Shape
+{
+    double area() const override
+    {
+        return 3.14159 * _radius * _radius;
+    }
+
+    template <typename Archive>
+    void serialize(Archive& archive)
+    {
+        archive(muesli::make_nvp("radius", _radius));
+    }
+
+    double _radius = 1.0;
+};
+
+struct Rectangle : Shape
+{
+    double area() const override
+    {
+        return _width * _height;
+    }
+
+    template <typename Archive>
+    void serialize(Archive& archive)
+    {
+        archive(muesli::make_nvp("width", _width), muesli::make_nvp("height", _height));
+    }
+
+    double _width = 2.0;
+    double _height = 3.0;
+};
+
+struct Square : Shape
+{
+    double area() const override
+    {
+        return _length * _length;
+    }
+
+    template <typename Archive>
+    void serialize(Archive& archive)
+    {
+        archive(muesli::make_nvp("length", _length));
+    }
+
+    double _length = 4.0;
+};
+
+} // namespace shapes
+
+MUESLI_REGISTER_TYPE(shapes::Shape, "shapes.Shape")
+MUESLI_REGISTER_POLYMORPHIC_TYPE(shapes::Circle, shapes::Shape, "shapes.Circle")
+MUESLI_REGISTER_POLYMORPHIC_TYPE(shapes::Rectangle, shapes::Shape, "shapes.Rectangle")
+MUESLI_REGISTER_POLYMORPHIC_TYPE(shapes::Square, shapes::Shape, "shapes.Square")
+
 void benchmarkJsonOutputArchiveStdOStreamWrapper(benchmark::State& state)
 {
     using OutputStreamImpl = muesli::StdOStreamWrapper<std::ostream>;
@@ -63,7 +137,142 @@ void benchmarkJsonOutputArchiveStringOStream(benchmark::State& state)
     }
 }
 
+void benchmarkJsonOutputArchiveAnyOStream(benchmark::State& state)
+{
+    using JsonOutputArchiveImpl = muesli::JsonOutputArchive<muesli::AnyOStream>;
+
+    muesli::tests::testtypes::TStructExtended data;
+
+    while (state.KeepRunning()) {
+        muesli::StringOStream outputStream;
+        muesli::AnyOStreamWrapper<muesli::StringOStream> outputStreamWrapper(outputStream);
+        JsonOutputArchiveImpl jsonOutputArchive(outputStreamWrapper);
+        jsonOutputArchive(data);
+        benchmark::DoNotOptimize(outputStream.getString());
+    }
+}
+
+using Shapes = std::vector<std::shared_ptr<shapes::Shape>>;
+
+// runs of equal types are common in practice
+Shapes makeShapes()
+{
+    Shapes data;
+    for (int i = 0; i < 1000; ++i) {
+        switch (i / 4 % 3) {
+        case 0:
+            data.push_back(std::make_shared<shapes::Circle>());
+            break;
+        case 1:
+            data.push_back(std::make_shared<shapes::Rectangle>());
+            break;
+        default:
+            data.push_back(std::make_shared<shapes::Square>());
+        }
+    }
+    return data;
+}
+
+// every element is saved through the type registry
+void benchmarkJsonOutputArchivePolymorphicVector(benchmark::State& state)
+{
+    using OutputStreamImpl = muesli::StringOStream;
+    using JsonOutputArchiveImpl = muesli::JsonOutputArchive<OutputStreamImpl>;
+
+    const Shapes data = makeShapes();
+
+    while (state.KeepRunning()) {
+        OutputStreamImpl outputStreamWrapper;
+        JsonOutputArchiveImpl jsonOutputArchive(outputStreamWrapper);
+        jsonOutputArchive(data);
+        benchmark::DoNotOptimize(outputStreamWrapper.getString());
+    }
+}
+
+// valid JSON in which "tInt32" has the wrong type, so loading fails after most of the fields
+const std::string malformedTStructExtended =
+        R"({"_typeName":"muesli.tests.testtypes.TStructExtended","tDouble":0.5,"tInt64":1,)"
+        R"("tString":"a","tEnum":"TLITERALA","tInt32":"1"})";
+
+void benchmarkJsonInputArchiveMalformedInputExceptions(benchmark::State& state)
+{
+    using JsonInputArchiveImpl = muesli::JsonInputArchive<muesli::StringIStream>;
+
+    while (state.KeepRunning()) {
+        muesli::tests::testtypes::TStructExtended data;
+        muesli::StringIStream stream(malformedTStructExtended);
+        JsonInputArchiveImpl jsonInputArchive(stream);
+        try {
+            jsonInputArchive(data);
+        } catch (const std::invalid_argument& error) {
+            benchmark::DoNotOptimize(error.what());
+        }
+    }
+}
+
+void benchmarkJsonInputArchiveMalformedInputLoadError(benchmark::State& state)
+{
+    using JsonInputArchiveImpl = muesli::JsonInputArchive<muesli::StringIStream>;
+
+    while (state.KeepRunning()) {
+        muesli::tests::testtypes::TStructExtended data;
+        muesli::LoadError error;
+        muesli::StringIStream stream(malformedTStructExtended);
+        JsonInputArchiveImpl jsonInputArchive(stream, error);
+        jsonInputArchive(data);
+        benchmark::DoNotOptimize(error.getMessage());
+    }
+}
+
+std::string serializeShapes()
+{
+    muesli::StringOStream stream;
+    muesli::JsonOutputArchive<muesli::StringOStream> jsonOutputArchive(stream);
+    const Shapes data = makeShapes();
+    jsonOutputArchive(data);
+    return stream.getString();
+}
+
+// baseline for benchmarkJsonInputArchivePolymorphicVectorValidate
+void benchmarkJsonInputArchivePolymorphicVectorLoad(benchmark::State& state)
+{
+    using JsonInputArchiveImpl = muesli::JsonInputArchive<muesli::StringIStream>;
+
+    const std::string json = serializeShapes();
+
+    while (state.KeepRunning()) {
+        Shapes data;
+        muesli::LoadError error;
+        muesli::StringIStream stream(json);
+        JsonInputArchiveImpl jsonInputArchive(stream, error);
+        jsonInputArchive(data);
+        benchmark::DoNotOptimize(data.data());
+    }
+}
+
+// parses the same input, but checks it without keeping the loaded elements
+void benchmarkJsonInputArchivePolymorphicVectorValidate(benchmark::State& state)
+{
+    using JsonInputArchiveImpl = muesli::JsonInputArchive<muesli::StringIStream>;
+
+    const std::string json = serializeShapes();
+
+    while (state.KeepRunning()) {
+        muesli::LoadError error;
+        muesli::StringIStream stream(json);
+        JsonInputArchiveImpl jsonInputArchive(stream, error);
+        jsonInputArchive.validate<Shapes>();
+        benchmark::DoNotOptimize(error.getCode());
+    }
+}
+
 BENCHMARK(benchmarkJsonOutputArchiveStdOStreamWrapper);
 BENCHMARK(benchmarkJsonOutputArchiveStringOStream);
+BENCHMARK(benchmarkJsonOutputArchiveAnyOStream);
+BENCHMARK(benchmarkJsonOutputArchivePolymorphicVector);
+BENCHMARK(benchmarkJsonInputArchiveMalformedInputExceptions);
+BENCHMARK(benchmarkJsonInputArchiveMalformedInputLoadError);
+BENCHMARK(benchmarkJsonInputArchivePolymorphicVectorLoad);
+BENCHMARK(benchmarkJsonInputArchivePolymorphicVectorValidate);
 
-BENCHMARK_MAIN()
+BENCHMARK_MAIN();
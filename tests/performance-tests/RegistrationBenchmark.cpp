@@ -0,0 +1,148 @@
+/*
+ * #%L
+ * %%
+ * Copyright (C) 2011 - 2016 BMW Car IT GmbH
+ * %%
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ * 
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ * 
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ * #L%
+ */
+
+// compare startup time and binary size of registering many polymorphic types for every
+// combination of archives and streams against registering them for the used archives only
+// the same source is built twice, with and without MUESLI_BENCHMARK_SELECTED_ARCHIVES
+
+#include <chrono>
+#include <cstdint>
+#include <fstream>
+#include <iostream>
+#include <memory>
+#include <vector>
+
+#include <boost/preprocessor/cat.hpp>
+#include <boost/preprocessor/repetition/repeat.hpp>
+#include <boost/preprocessor/stringize.hpp>
+
+#include <benchmark/benchmark.h>
+
+#include "muesli/archives/binary/BinaryInputArchive.h"
+#include "muesli/archives/binary/BinaryOutputArchive.h"
+#include "muesli/archives/json/JsonInputArchive.h"
+#include "muesli/archives/json/JsonOutputArchive.h"
+
+#include "muesli/streams/StdIStreamWrapper.h"
+#include "muesli/streams/StdOStreamWrapper.h"
+#include "muesli/streams/StringIStream.h"
+#include "muesli/streams/StringOStream.h"
+
+#include "muesli/ArchiveRegistry.h"
+#include "muesli/NameValuePair.h"
+#include "muesli/TypeRegistry.h"
+
+namespace
+{
+
+struct Timestamp
+{
+    Timestamp() : _time(std::chrono::steady_clock::now())
+    {
+    }
+    std::chrono::steady_clock::time_point _time;
+};
+
+// initialized before all other static objects, including the type registrations
+const Timestamp staticInitializationStart __attribute__((init_priority(101)));
+
+} // namespace
+
+#ifdef MUESLI_BENCHMARK_SELECTED_ARCHIVES
+using SelectedInputArchives = muesli::ArchiveList<muesli::JsonInputArchive<muesli::StringIStream>>;
+using SelectedOutputArchives =
+        muesli::ArchiveList<muesli::JsonOutputArchive<muesli::StringOStream>>;
+MUESLI_SELECT_POLYMORPHIC_ARCHIVES(SelectedInputArchives, SelectedOutputArchives)
+#endif // MUESLI_BENCHMARK_SELECTED_ARCHIVES
+
+#define MUESLI_BENCHMARK_TYPE_COUNT 64
+
+namespace generated
+{
+
+struct Base
+{
+    virtual ~Base() = default;
+    template <typename Archive>
+    void serialize(Archive&)
+    {
+    }
+};
+
+#define MUESLI_BENCHMARK_DEFINE_TYPE(z, n, unused)                                                 \
+    struct BOOST_PP_CAT(Derived, n) : Base                                                         \
+    {                                                                                              \
+        template <typename Archive>                                                                \
+        void serialize(Archive& archive)                                                           \
+        {                                                                                          \
+            archive(muesli::make_nvp("value", _value));                                            \
+        }                                                                                          \
+        std::int32_t _value = n;                                                                   \
+    };
+
+BOOST_PP_REPEAT(MUESLI_BENCHMARK_TYPE_COUNT, MUESLI_BENCHMARK_DEFINE_TYPE, ~)
+
+} // namespace generated
+
+MUESLI_REGISTER_TYPE(generated::Base, "generated.Base")
+
+#define MUESLI_BENCHMARK_REGISTER_TYPE(z, n, unused)                                               \
+    MUESLI_REGISTER_POLYMORPHIC_TYPE(generated::BOOST_PP_CAT(Derived, n),                          \
+                                     generated::Base,                                              \
+                                     "generated.Derived" BOOST_PP_STRINGIZE(n))
+
+BOOST_PP_REPEAT(MUESLI_BENCHMARK_TYPE_COUNT, MUESLI_BENCHMARK_REGISTER_TYPE, ~)
+
+#define MUESLI_BENCHMARK_PUSH_TYPE(z, n, data)                                                     \
+    data.push_back(std::make_unique<generated::BOOST_PP_CAT(Derived, n)>());
+
+void benchmarkJsonPolymorphicRoundTrip(benchmark::State& state)
+{
+    std::vector<std::unique_ptr<generated::Base>> data;
+    BOOST_PP_REPEAT(MUESLI_BENCHMARK_TYPE_COUNT, MUESLI_BENCHMARK_PUSH_TYPE, data)
+
+    while (state.KeepRunning()) {
+        muesli::StringOStream outputStream;
+        muesli::JsonOutputArchive<muesli::StringOStream> outputArchive(outputStream);
+        outputArchive(data);
+
+        std::vector<std::unique_ptr<generated::Base>> loaded;
+        muesli::StringIStream inputStream(outputStream.getString());
+        muesli::JsonInputArchive<muesli::StringIStream> inputArchive(inputStream);
+        inputArchive(loaded);
+        benchmark::DoNotOptimize(loaded);
+    }
+}
+
+BENCHMARK(benchmarkJsonPolymorphicRoundTrip);
+
+int main(int argc, char** argv)
+{
+    const auto staticInitializationTime = std::chrono::duration_cast<std::chrono::microseconds>(
+            std::chrono::steady_clock::now() - staticInitializationStart._time);
+    std::ifstream binary(argv[0], std::ios::binary | std::ios::ate);
+
+    std::cout << "static initialization: " << staticInitializationTime.count() << " us"
+              << std::endl;
+    std::cout << "binary size: " << binary.tellg() << " bytes" << std::endl;
+
+    benchmark::Initialize(&argc, argv);
+    benchmark::RunSpecifiedBenchmarks();
+    return 0;
+}
@@ -0,0 +1,224 @@
+/*
+ * #%L
+ * %%
+ * Copyright (C) 2011 - 2016 BMW Car IT GmbH
+ * %%
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ * 
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ * 
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ * #L%
+ */
+
+#include <cstdint>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include <boost/optional.hpp>
+
+#include <gtest/gtest.h>
+
+#include "muesli/FieldMask.h"
+#include "muesli/NameValuePair.h"
+
+#include "muesli/archives/binary/BinaryInputArchive.h"
+#include "muesli/archives/binary/BinaryOutputArchive.h"
+#include "muesli/archives/json/JsonInputArchive.h"
+#include "muesli/archives/json/JsonOutputArchive.h"
+
+#include "muesli/streams/StringIStream.h"
+#include "muesli/streams/StringOStream.h"
+
+namespace
+{
+struct Item
+{
+    std::int32_t _id;
+    std::string _name;
+
+    template <typename Archive>
+    void serialize(Archive& archive)
+    {
+        archive(muesli::make_nvp("id", _id), muesli::make_nvp("name", _name));
+    }
+};
+
+struct Record
+{
+    std::string _title;
+    std::vector<Item> _items;
+    boost::optional<Item> _extra;
+    double _score;
+
+    template <typename Archive>
+    void serialize(Archive& archive)
+    {
+        archive(muesli::make_nvp("title", _title),
+                muesli::make_nvp("items", _items),
+                muesli::make_nvp("extra", _extra),
+                muesli::make_nvp("score", _score));
+    }
+};
+
+struct Summary
+{
+    std::string _title;
+    double _score;
+
+    template <typename Archive>
+    void serialize(Archive& archive)
+    {
+        archive(muesli::make_nvp("title", _title), muesli::make_nvp("score", _score));
+    }
+};
+} // namespace
+
+class FieldMaskTest : public ::testing::Test
+{
+public:
+    FieldMaskTest() : _record{"t", {{1, "a"}, {2, "b"}}, Item{3, "c"}, 0.5}
+    {
+    }
+
+protected:
+    template <template <typename> class OutputArchive,
+              template <typename> class InputArchive>
+    static Record roundtrip(const Record& record, muesli::FieldMask fieldMask)
+    {
+        muesli::StringOStream outputStream;
+        OutputArchive<muesli::StringOStream> outputArchive(outputStream);
+        outputArchive(record);
+
+        muesli::StringIStream inputStream(outputStream.getString());
+        InputArchive<muesli::StringIStream> inputArchive(inputStream, std::move(fieldMask));
+        Record loaded{"", {}, boost::none, -1.0};
+        inputArchive(loaded);
+        return loaded;
+    }
+
+    template <template <typename> class OutputArchive,
+              template <typename> class InputArchive>
+    void testProjection()
+    {
+        Record loaded = roundtrip<OutputArchive, InputArchive>(_record, {"items.id", "score"});
+        EXPECT_EQ("", loaded._title);
+        ASSERT_EQ(2, loaded._items.size());
+        EXPECT_EQ(1, loaded._items[0]._id);
+        EXPECT_EQ("", loaded._items[0]._name);
+        EXPECT_EQ(2, loaded._items[1]._id);
+        EXPECT_FALSE(loaded._extra);
+        EXPECT_EQ(0.5, loaded._score);
+
+        loaded = roundtrip<OutputArchive, InputArchive>(_record, {"extra", "title"});
+        EXPECT_EQ("t", loaded._title);
+        EXPECT_TRUE(loaded._items.empty());
+        ASSERT_TRUE(loaded._extra);
+        EXPECT_EQ("c", loaded._extra->_name);
+        EXPECT_EQ(-1.0, loaded._score);
+
+        loaded = roundtrip<OutputArchive, InputArchive>(_record, {});
+        EXPECT_EQ("t", loaded._title);
+        EXPECT_EQ(2, loaded._items.size());
+        EXPECT_EQ(0.5, loaded._score);
+    }
+
+    Record _record;
+};
+
+TEST_F(FieldMaskTest, selectField)
+{
+    const muesli::FieldMask fieldMask{"a.b", "a.c.d", "e", "e.f"};
+    std::size_t field = fieldMask.getRoot();
+    EXPECT_FALSE(fieldMask.selectField(field, "b"));
+    ASSERT_TRUE(fieldMask.selectField(field, "a"));
+    const std::size_t a = field;
+    EXPECT_TRUE(fieldMask.selectField(field, "b"));
+    EXPECT_TRUE(fieldMask.selectField(field, "anything"));
+
+    field = a;
+    EXPECT_FALSE(fieldMask.selectField(field, "d"));
+    ASSERT_TRUE(fieldMask.selectField(field, "c"));
+    EXPECT_FALSE(fieldMask.selectField(field, "e"));
+
+    field = fieldMask.getRoot();
+    ASSERT_TRUE(fieldMask.selectField(field, "e"));
+    EXPECT_TRUE(fieldMask.selectField(field, "g"));
+}
+
+TEST_F(FieldMaskTest, emptyMaskSelectsEverything)
+{
+    const muesli::FieldMask fieldMask;
+    std::size_t field = fieldMask.getRoot();
+    EXPECT_TRUE(fieldMask.selectField(field, "a"));
+    EXPECT_TRUE(fieldMask.selectField(field, "b"));
+}
+
+TEST_F(FieldMaskTest, submaskSelectsTheSubtree)
+{
+    const muesli::FieldMask fieldMask{"a.b", "a.c.d", "e"};
+    std::size_t field = fieldMask.getRoot();
+    ASSERT_TRUE(fieldMask.selectField(field, "a"));
+    const muesli::FieldMask submask = fieldMask.getSubmask(field);
+
+    field = submask.getRoot();
+    EXPECT_FALSE(submask.selectField(field, "a"));
+    EXPECT_FALSE(submask.selectField(field, "e"));
+    ASSERT_TRUE(submask.selectField(field, "c"));
+    EXPECT_FALSE(submask.selectField(field, "b"));
+    EXPECT_TRUE(submask.selectField(field, "d"));
+
+    field = fieldMask.getRoot();
+    ASSERT_TRUE(fieldMask.selectField(field, "e"));
+    const muesli::FieldMask selectingAll = fieldMask.getSubmask(field);
+    field = selectingAll.getRoot();
+    EXPECT_TRUE(selectingAll.selectField(field, "anything"));
+}
+
+TEST_F(FieldMaskTest, invalidPathThrows)
+{
+    EXPECT_THROW(muesli::FieldMask({"a..b"}), std::invalid_argument);
+    EXPECT_THROW(muesli::FieldMask({"a."}), std::invalid_argument);
+    EXPECT_THROW(muesli::FieldMask({""}), std::invalid_argument);
+}
+
+TEST_F(FieldMaskTest, jsonProjection)
+{
+    testProjection<muesli::JsonOutputArchive, muesli::JsonInputArchive>();
+}
+
+TEST_F(FieldMaskTest, binaryProjection)
+{
+    testProjection<muesli::BinaryOutputArchive, muesli::BinaryInputArchive>();
+}
+
+TEST_F(FieldMaskTest, excludedFieldsMayBeMissing)
+{
+    muesli::StringIStream stream(R"({"score":1.5})");
+    muesli::JsonInputArchive<muesli::StringIStream> jsonInputArchive(stream, {"score"});
+    Record loaded{"", {}, boost::none, -1.0};
+    jsonInputArchive(loaded);
+    EXPECT_EQ(1.5, loaded._score);
+}
+
+TEST_F(FieldMaskTest, currentFieldIsRestoredWhenLoadingThrows)
+{
+    muesli::StringIStream stream(
+            R"({"title":"t","items":[],"extra":{"id":"1","name":"c"},"score":1.5})");
+    muesli::JsonInputArchive<muesli::StringIStream> jsonInputArchive(
+            stream, {"extra.id", "score"});
+    Record loaded{"", {}, boost::none, -1.0};
+    EXPECT_THROW(jsonInputArchive(loaded), std::invalid_argument);
+
+    Summary summary{"", -1.0};
+    jsonInputArchive.loadAt("", summary);
+    EXPECT_EQ("", summary._title);
+    EXPECT_EQ(1.5, summary._score);
+}
@@ -17,14 +17,17 @@
  * #L%
  */
 
-#include <boost/mpl/equal.hpp>
-#include <boost/mpl/vector.hpp>
+#include <type_traits>
+
+#include <boost/preprocessor/repetition/enum.hpp>
+#include <boost/preprocessor/repetition/repeat.hpp>
 
 #include "muesli/detail/IncrementalTypeList.h"
 
 // tags
 struct Tag1;
 struct Tag2;
+struct Tag3;
 
 // types
 struct Foo1
@@ -42,27 +45,39 @@ struct Bar2
 };
 
 using namespace muesli::detail;
-static_assert(boost::mpl::equal<MUESLI_GET_INCREMENTAL_TYPELIST(Tag1), boost::mpl::vector<>>::value,
+static_assert(std::is_same<MUESLI_GET_INCREMENTAL_TYPELIST(Tag1), TypeList<>>::value,
               "list must be empty");
-static_assert(boost::mpl::equal<MUESLI_GET_INCREMENTAL_TYPELIST(Tag2), boost::mpl::vector<>>::value,
+static_assert(std::is_same<MUESLI_GET_INCREMENTAL_TYPELIST(Tag2), TypeList<>>::value,
               "list must be empty");
 
 MUESLI_ADD_TO_INCREMENTAL_TYPELIST(Tag1, Foo1)
 MUESLI_ADD_TO_INCREMENTAL_TYPELIST(Tag2, Bar1)
 
-static_assert(
-        boost::mpl::equal<MUESLI_GET_INCREMENTAL_TYPELIST(Tag1), boost::mpl::vector<Foo1>>::value,
-        "lists must match");
-static_assert(
-        boost::mpl::equal<MUESLI_GET_INCREMENTAL_TYPELIST(Tag2), boost::mpl::vector<Bar1>>::value,
-        "lists must match");
+static_assert(std::is_same<MUESLI_GET_INCREMENTAL_TYPELIST(Tag1), TypeList<Foo1>>::value,
+              "lists must match");
+static_assert(std::is_same<MUESLI_GET_INCREMENTAL_TYPELIST(Tag2), TypeList<Bar1>>::value,
+              "lists must match");
 
 MUESLI_ADD_TO_INCREMENTAL_TYPELIST(Tag1, Foo2)
 MUESLI_ADD_TO_INCREMENTAL_TYPELIST(Tag2, Bar2)
 
-static_assert(boost::mpl::equal<MUESLI_GET_INCREMENTAL_TYPELIST(Tag1),
-                                boost::mpl::vector<Foo1, Foo2>>::value,
+static_assert(std::is_same<MUESLI_GET_INCREMENTAL_TYPELIST(Tag1), TypeList<Foo1, Foo2>>::value,
               "lists must match");
-static_assert(boost::mpl::equal<MUESLI_GET_INCREMENTAL_TYPELIST(Tag2),
-                                boost::mpl::vector<Bar1, Bar2>>::value,
+static_assert(std::is_same<MUESLI_GET_INCREMENTAL_TYPELIST(Tag2), TypeList<Bar1, Bar2>>::value,
+              "lists must match");
+
+// lists are not limited by BOOST_MPL_LIMIT_VECTOR_SIZE
+template <int n>
+struct Baz
+{
+};
+
+#define MUESLI_TEST_ADD_BAZ(z, n, unused) MUESLI_ADD_TO_INCREMENTAL_TYPELIST(Tag3, Baz<n>)
+BOOST_PP_REPEAT(100, MUESLI_TEST_ADD_BAZ, ~)
+#undef MUESLI_TEST_ADD_BAZ
+
+#define MUESLI_TEST_BAZ(z, n, unused) Baz<n>
+static_assert(std::is_same<MUESLI_GET_INCREMENTAL_TYPELIST(Tag3),
+                           TypeList<BOOST_PP_ENUM(100, MUESLI_TEST_BAZ, ~)>>::value,
               "lists must match");
+#undef MUESLI_TEST_BAZ
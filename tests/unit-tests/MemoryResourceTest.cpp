@@ -0,0 +1,199 @@
+/*
+ * #%L
+ * %%
+ * Copyright (C) 2011 - 2016 BMW Car IT GmbH
+ * %%
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ * 
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ * 
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ * #L%
+ */
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "muesli/MemoryResource.h"
+#include "muesli/NameValuePair.h"
+
+#include "muesli/archives/binary/BinaryInputArchive.h"
+#include "muesli/archives/binary/BinaryOutputArchive.h"
+#include "muesli/archives/json/JsonInputArchive.h"
+#include "muesli/archives/json/JsonOutputArchive.h"
+
+#include "muesli/streams/StringIStream.h"
+#include "muesli/streams/StringOStream.h"
+
+namespace
+{
+// forwards to operator new/delete and counts the outstanding allocations
+class CountingMemoryResource : public muesli::MemoryResource
+{
+public:
+    CountingMemoryResource() : _allocations(0), _outstanding(0)
+    {
+    }
+
+    std::size_t _allocations;
+    std::size_t _outstanding;
+
+private:
+    void* doAllocate(std::size_t bytes, std::size_t alignment) override
+    {
+        ++_allocations;
+        ++_outstanding;
+        return muesli::getNewDeleteMemoryResource()->allocate(bytes, alignment);
+    }
+
+    void doDeallocate(void* ptr, std::size_t bytes, std::size_t alignment) override
+    {
+        --_outstanding;
+        muesli::getNewDeleteMemoryResource()->deallocate(ptr, bytes, alignment);
+    }
+};
+
+struct Point
+{
+    double _x;
+    muesli::ResourceString _label;
+
+    template <typename Archive>
+    void serialize(Archive& archive)
+    {
+        archive(muesli::make_nvp("x", _x), muesli::make_nvp("label", _label));
+    }
+};
+
+struct Message
+{
+    muesli::ResourceString _title;
+    muesli::ResourceVector<std::shared_ptr<Point>> _points;
+    muesli::ResourceVector<std::int32_t> _values;
+
+    template <typename Archive>
+    void serialize(Archive& archive)
+    {
+        archive(muesli::make_nvp("title", _title),
+                muesli::make_nvp("points", _points),
+                muesli::make_nvp("values", _values));
+    }
+};
+
+const char* const json = R"({"title":"a title which does not fit into the small string buffer",)"
+                         R"("points":[{"x":1,"label":"first"},{"x":2,"label":"second"}],)"
+                         R"("values":[1,2,3]})";
+} // namespace
+
+TEST(MemoryResourceTest, loadedObjectsUseTheResourceOfTheArchive)
+{
+    CountingMemoryResource resource;
+    {
+        muesli::StringIStream stream(json);
+        muesli::JsonInputArchive<muesli::StringIStream> jsonInputArchive(stream);
+        jsonInputArchive.setMemoryResource(&resource);
+        Message message;
+        jsonInputArchive(message);
+        EXPECT_EQ(muesli::getNewDeleteMemoryResource(), muesli::getCurrentMemoryResource());
+
+        ASSERT_EQ(2, message._points.size());
+        EXPECT_EQ("second", message._points[1]->_label);
+        EXPECT_EQ(&resource, message._points[1]->_label.get_allocator().getResource());
+        EXPECT_EQ(3, message._values.size());
+        // the pointees and their control blocks are allocated at once
+        EXPECT_LE(2, resource._allocations);
+        EXPECT_LT(0, resource._outstanding);
+    }
+    EXPECT_EQ(0, resource._outstanding);
+}
+
+TEST(MemoryResourceTest, wholeMessageInArena)
+{
+    muesli::MonotonicMemoryResource arena(256);
+    {
+        muesli::ScopedMemoryResource scopedMemoryResource(&arena);
+        Message message;
+        muesli::StringIStream stream(json);
+        muesli::JsonInputArchive<muesli::StringIStream> jsonInputArchive(stream);
+        jsonInputArchive(message);
+        EXPECT_EQ(&arena, message._title.get_allocator().getResource());
+        EXPECT_EQ(&arena, message._points.get_allocator().getResource());
+        EXPECT_EQ(1, message._points[0]->_x);
+        EXPECT_LT(0, arena.getAllocatedBytes());
+    }
+    arena.release();
+    EXPECT_EQ(0, arena.getAllocatedBytes());
+}
+
+TEST(MemoryResourceTest, elementsUseTheResourceOfTheirContainer)
+{
+    const std::string label("a label which does not fit into the small string buffer");
+    muesli::MonotonicMemoryResource arena;
+    muesli::ResourceVector<muesli::ResourceString> strings{
+            muesli::ResourceAllocator<muesli::ResourceString>(&arena)};
+    strings.emplace_back(label.c_str());
+    strings.resize(2);
+    EXPECT_EQ(&arena, strings[0].get_allocator().getResource());
+    EXPECT_EQ(&arena, strings[1].get_allocator().getResource());
+}
+
+TEST(MemoryResourceTest, containerCreatedBeforeTheLoadKeepsItsResource)
+{
+    const std::string label("a label which does not fit into the small string buffer");
+    muesli::ResourceVector<muesli::ResourceString> labels;
+    muesli::MonotonicMemoryResource arena;
+    {
+        muesli::StringIStream stream("[\"" + label + "\"]");
+        muesli::JsonInputArchive<muesli::StringIStream> jsonInputArchive(stream);
+        jsonInputArchive.setMemoryResource(&arena);
+        jsonInputArchive(labels);
+    }
+    ASSERT_EQ(1, labels.size());
+    EXPECT_EQ(muesli::getNewDeleteMemoryResource(), labels[0].get_allocator().getResource());
+    arena.release();
+    EXPECT_EQ(label, labels[0].c_str());
+}
+
+TEST(MemoryResourceTest, monotonicAllocationsAreAligned)
+{
+    muesli::MonotonicMemoryResource arena(64);
+    arena.allocate(1, 1);
+    void* ptr = arena.allocate(200, 64);
+    EXPECT_EQ(0, reinterpret_cast<std::uintptr_t>(ptr) % 64);
+    ptr = arena.allocate(3, 8);
+    EXPECT_EQ(0, reinterpret_cast<std::uintptr_t>(ptr) % 8);
+    EXPECT_EQ(204, arena.getAllocatedBytes());
+}
+
+TEST(MemoryResourceTest, binaryRoundtripOfResourceTypes)
+{
+    CountingMemoryResource resource;
+    muesli::ScopedMemoryResource scopedMemoryResource(&resource);
+    Message message;
+    muesli::StringIStream stream(json);
+    muesli::JsonInputArchive<muesli::StringIStream> jsonInputArchive(stream);
+    jsonInputArchive(message);
+
+    muesli::StringOStream outputStream;
+    muesli::BinaryOutputArchive<muesli::StringOStream> binaryOutputArchive(outputStream);
+    binaryOutputArchive(message);
+    muesli::StringIStream inputStream(outputStream.getString());
+    muesli::BinaryInputArchive<muesli::StringIStream> binaryInputArchive(inputStream);
+    Message loaded;
+    binaryInputArchive(loaded);
+    EXPECT_EQ(message._title, loaded._title);
+    ASSERT_EQ(2, loaded._points.size());
+    EXPECT_EQ("first", loaded._points[0]->_label);
+    EXPECT_EQ(message._values, loaded._values);
+}
@@ -0,0 +1,186 @@
+/*
+ * #%L
+ * %%
+ * Copyright (C) 2011 - 2016 BMW Car IT GmbH
+ * %%
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ * 
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ * 
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ * #L%
+ */
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "muesli/NameValuePair.h"
+#include "muesli/NameValuePairWithDefault.h"
+
+#include "muesli/archives/binary/BinaryInputArchive.h"
+#include "muesli/archives/binary/BinaryOutputArchive.h"
+#include "muesli/archives/json/JsonInputArchive.h"
+#include "muesli/archives/json/JsonOutputArchive.h"
+
+#include "muesli/exceptions/ValueNotFoundException.h"
+#include "muesli/streams/StringIStream.h"
+#include "muesli/streams/StringOStream.h"
+
+namespace
+{
+// version of Settings written by older producers
+struct SettingsV1
+{
+    std::string _name;
+    double _scale;
+
+    template <typename Archive>
+    void serialize(Archive& archive)
+    {
+        archive(muesli::make_nvp("name", _name), muesli::make_nvp("scale", _scale));
+    }
+};
+
+// version of Settings written by newer producers with an additional field in front of "retries"
+struct SettingsV3
+{
+    std::string _owner;
+    std::int32_t _retries;
+    std::string _name;
+    double _scale;
+
+    template <typename Archive>
+    void serialize(Archive& archive)
+    {
+        archive(muesli::make_nvp("owner", _owner),
+                muesli::make_nvp("retries", _retries),
+                muesli::make_nvp("name", _name),
+                muesli::make_nvp("scale", _scale));
+    }
+};
+
+struct Settings
+{
+    std::int32_t _retries;
+    std::string _name;
+    std::vector<std::string> _tags;
+    double _scale;
+    std::string _mode;
+
+    template <typename Archive>
+    void serialize(Archive& archive)
+    {
+        archive(muesli::make_nvp_default("retries", _retries, 3),
+                muesli::make_nvp("name", _name),
+                muesli::make_nvp_default("tags", _tags, std::vector<std::string>{"default"}),
+                muesli::make_nvp("scale", _scale),
+                muesli::make_nvp_default("mode", _mode, "auto"));
+    }
+};
+} // namespace
+
+class NameValuePairWithDefaultTest : public ::testing::Test
+{
+protected:
+    template <template <typename> class OutputArchive,
+              template <typename> class InputArchive,
+              typename From,
+              typename To>
+    static void roundtrip(From& from, To& to)
+    {
+        muesli::StringOStream outputStream;
+        OutputArchive<muesli::StringOStream> outputArchive(outputStream);
+        outputArchive(from);
+
+        muesli::StringIStream inputStream(outputStream.getString());
+        InputArchive<muesli::StringIStream> inputArchive(inputStream);
+        inputArchive(to);
+    }
+
+    template <template <typename> class OutputArchive, template <typename> class InputArchive>
+    static void testMissingFieldsGetDefaults()
+    {
+        SettingsV1 old{"n", 0.5};
+        Settings loaded{-1, "", {}, -1.0, ""};
+        roundtrip<OutputArchive, InputArchive>(old, loaded);
+        EXPECT_EQ(3, loaded._retries);
+        EXPECT_EQ("n", loaded._name);
+        EXPECT_EQ(std::vector<std::string>{"default"}, loaded._tags);
+        EXPECT_EQ(0.5, loaded._scale);
+        EXPECT_EQ("auto", loaded._mode);
+    }
+
+    template <template <typename> class OutputArchive, template <typename> class InputArchive>
+    static void testPresentFieldsAreLoaded()
+    {
+        Settings settings{5, "n", {"a", "b"}, 0.5, "manual"};
+        Settings loaded{-1, "", {}, -1.0, ""};
+        roundtrip<OutputArchive, InputArchive>(settings, loaded);
+        EXPECT_EQ(5, loaded._retries);
+        EXPECT_EQ("n", loaded._name);
+        EXPECT_EQ((std::vector<std::string>{"a", "b"}), loaded._tags);
+        EXPECT_EQ(0.5, loaded._scale);
+        EXPECT_EQ("manual", loaded._mode);
+    }
+
+    template <template <typename> class OutputArchive, template <typename> class InputArchive>
+    static void testFieldsAfterUnknownFieldAreLoaded()
+    {
+        SettingsV3 newer{"owner", 5, "n", 0.5};
+        Settings loaded{-1, "", {}, -1.0, ""};
+        roundtrip<OutputArchive, InputArchive>(newer, loaded);
+        EXPECT_EQ(5, loaded._retries);
+        EXPECT_EQ("n", loaded._name);
+        EXPECT_EQ(std::vector<std::string>{"default"}, loaded._tags);
+        EXPECT_EQ(0.5, loaded._scale);
+        EXPECT_EQ("auto", loaded._mode);
+    }
+};
+
+TEST_F(NameValuePairWithDefaultTest, jsonMissingFieldsGetDefaults)
+{
+    testMissingFieldsGetDefaults<muesli::JsonOutputArchive, muesli::JsonInputArchive>();
+}
+
+TEST_F(NameValuePairWithDefaultTest, jsonPresentFieldsAreLoaded)
+{
+    testPresentFieldsAreLoaded<muesli::JsonOutputArchive, muesli::JsonInputArchive>();
+}
+
+TEST_F(NameValuePairWithDefaultTest, binaryMissingFieldsGetDefaults)
+{
+    testMissingFieldsGetDefaults<muesli::BinaryOutputArchive, muesli::BinaryInputArchive>();
+}
+
+TEST_F(NameValuePairWithDefaultTest, binaryPresentFieldsAreLoaded)
+{
+    testPresentFieldsAreLoaded<muesli::BinaryOutputArchive, muesli::BinaryInputArchive>();
+}
+
+TEST_F(NameValuePairWithDefaultTest, jsonFieldsAfterUnknownFieldAreLoaded)
+{
+    testFieldsAfterUnknownFieldAreLoaded<muesli::JsonOutputArchive, muesli::JsonInputArchive>();
+}
+
+TEST_F(NameValuePairWithDefaultTest, binaryFieldsAfterUnknownFieldAreLoaded)
+{
+    testFieldsAfterUnknownFieldAreLoaded<muesli::BinaryOutputArchive,
+                                         muesli::BinaryInputArchive>();
+}
+
+TEST_F(NameValuePairWithDefaultTest, fieldsWithoutDefaultAreStillRequired)
+{
+    muesli::StringIStream stream(R"({"retries":1,"scale":0.5})");
+    muesli::JsonInputArchive<muesli::StringIStream> jsonInputArchive(stream);
+    Settings loaded{-1, "", {}, -1.0, ""};
+    EXPECT_THROW(jsonInputArchive(loaded), muesli::exceptions::ValueNotFoundException);
+}
@@ -0,0 +1,79 @@
+/*
+ * #%L
+ * %%
+ * Copyright (C) 2011 - 2016 BMW Car IT GmbH
+ * %%
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ * 
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ * 
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ * #L%
+ */
+
+#include <cstddef>
+#include <map>
+#include <string>
+
+#include <gtest/gtest.h>
+
+#include "muesli/detail/PerfectHashTable.h"
+
+TEST(PerfectHashTableTest, findsAllKeys)
+{
+    std::map<std::string, std::size_t> entries;
+    for (std::size_t i = 0; i < 500; ++i) {
+        entries.insert({"muesli.tests.testtypes.Type" + std::to_string(i), i});
+    }
+    muesli::detail::PerfectHashTable<std::size_t> table;
+    table.build(entries.cbegin(), entries.cend());
+    for (const auto& entry : entries) {
+        const std::size_t* value = table.find(entry.first.data(), entry.first.size());
+        ASSERT_NE(nullptr, value);
+        EXPECT_EQ(entry.second, *value);
+    }
+}
+
+TEST(PerfectHashTableTest, slotCountGrowsLinearly)
+{
+    std::map<std::string, std::size_t> entries;
+    for (std::size_t i = 0; i < 20000; ++i) {
+        entries.insert({"Type" + std::to_string(i), i});
+        if (entries.size() % 5000 == 0) {
+            muesli::detail::PerfectHashTable<std::size_t> table;
+            table.build(entries.cbegin(), entries.cend());
+            EXPECT_LE(entries.size(), table.getSlotCount());
+            EXPECT_GE(entries.size() + entries.size() / 4 + 1, table.getSlotCount());
+            const std::string& lastKey = entries.rbegin()->first;
+            ASSERT_NE(nullptr, table.find(lastKey.data(), lastKey.size()));
+        }
+    }
+}
+
+TEST(PerfectHashTableTest, unknownKeys)
+{
+    const std::map<std::string, int> entries{{"a", 1}, {"ab", 2}, {"abc", 3}};
+    muesli::detail::PerfectHashTable<int> table;
+    EXPECT_EQ(nullptr, table.find("a", 1));
+    table.build(entries.cbegin(), entries.cend());
+    EXPECT_EQ(nullptr, table.find("b", 1));
+    EXPECT_EQ(nullptr, table.find("abcd", 4));
+    EXPECT_EQ(nullptr, table.find("", 0));
+    // the length is part of the key
+    ASSERT_NE(nullptr, table.find("abc", 2));
+    EXPECT_EQ(2, *table.find("abc", 2));
+}
+
+TEST(PerfectHashTableTest, emptyTable)
+{
+    const std::map<std::string, int> entries;
+    muesli::detail::PerfectHashTable<int> table;
+    table.build(entries.cbegin(), entries.cend());
+    EXPECT_EQ(nullptr, table.find("a", 1));
+}
@@ -0,0 +1,100 @@
+/*
+ * #%L
+ * %%
+ * Copyright (C) 2011 - 2016 BMW Car IT GmbH
+ * %%
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ * 
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ * 
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ * #L%
+ */
+
+#include <memory>
+#include <typeindex>
+#include <typeinfo>
+
+#include <gtest/gtest.h>
+
+#include "MockArchive.h"
+#include "MockStream.h"
+
+#include "muesli/archives/json/JsonOutputArchive.h"
+#include "muesli/streams/StringOStream.h"
+
+#include "muesli/ArchiveRegistry.h"
+#include "muesli/TypeRegistry.h"
+
+// only this output archive is selected, input archives are left at the full product
+using SelectedOutputArchives =
+        muesli::ArchiveList<muesli::JsonOutputArchive<muesli::StringOStream>>;
+MUESLI_SELECT_POLYMORPHIC_ARCHIVES(void, SelectedOutputArchives)
+
+namespace selected
+{
+
+struct Base
+{
+    virtual ~Base() = default;
+    template <typename Archive>
+    void serialize(Archive&)
+    {
+    }
+};
+
+struct Derived : Base
+{
+    template <typename Archive>
+    void serialize(Archive&)
+    {
+    }
+};
+
+} // namespace selected
+
+MUESLI_REGISTER_TYPE(selected::Base, "selected.Base")
+MUESLI_REGISTER_POLYMORPHIC_TYPE(selected::Derived, selected::Base, "selected.Derived")
+
+TEST(PolymorphicArchiveSelectionTest, onlySelectedOutputArchivesAreRegistered)
+{
+    using JsonOutputArchiveImpl = muesli::JsonOutputArchive<muesli::StringOStream>;
+    using UnselectedJsonOutputArchive = muesli::JsonOutputArchive<MockOutputStream>;
+    using UnselectedMockOutputArchive = MockOutputArchive<MockOutputStream>;
+
+    const std::type_index typeId(typeid(selected::Derived));
+    EXPECT_TRUE((muesli::TypeSaveRegistry<selected::Base, JsonOutputArchiveImpl>::getSaveFunction(
+                         typeId)
+                         .is_initialized()));
+    EXPECT_FALSE(
+            (muesli::TypeSaveRegistry<selected::Base, UnselectedJsonOutputArchive>::getSaveFunction(
+                     typeId)
+                     .is_initialized()));
+    EXPECT_FALSE(
+            (muesli::TypeSaveRegistry<selected::Base, UnselectedMockOutputArchive>::getSaveFunction(
+                     typeId)
+                     .is_initialized()));
+}
+
+TEST(PolymorphicArchiveSelectionTest, unselectedDirectionUsesAllArchives)
+{
+    using MockInputArchiveImpl = MockInputArchive<MockInputStream>;
+    EXPECT_TRUE((muesli::TypeLoadRegistry<selected::Base, MockInputArchiveImpl>::getLoadFunction(
+                         "selected.Derived")
+                         .is_initialized()));
+}
+
+TEST(PolymorphicArchiveSelectionTest, saveThroughSelectedArchive)
+{
+    std::unique_ptr<selected::Base> value = std::make_unique<selected::Derived>();
+    muesli::StringOStream stream;
+    muesli::JsonOutputArchive<muesli::StringOStream> archive(stream);
+    archive(value);
+    EXPECT_EQ(R"({"_typeName":"selected.Derived"})", stream.getString());
+}
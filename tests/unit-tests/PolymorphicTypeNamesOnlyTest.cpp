@@ -0,0 +1,184 @@
+/*
+ * #%L
+ * %%
+ * Copyright (C) 2011 - 2016 BMW Car IT GmbH
+ * %%
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ * 
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ * 
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ * #L%
+ */
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <typeinfo>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "muesli/archives/binary/BinaryInputArchive.h"
+#include "muesli/archives/binary/BinaryOutputArchive.h"
+#include "muesli/archives/json/JsonInputArchive.h"
+#include "muesli/archives/json/JsonOutputArchive.h"
+#include "muesli/exceptions/ValueNotFoundException.h"
+#include "muesli/streams/StringIStream.h"
+#include "muesli/streams/StringOStream.h"
+
+#include "muesli/NameValuePair.h"
+#include "muesli/TypeRegistry.h"
+
+namespace typenames
+{
+
+struct Point
+{
+    template <typename Archive>
+    void serialize(Archive& archive)
+    {
+        archive(muesli::make_nvp("x", _x));
+    }
+    std::int32_t _x = 1;
+};
+
+struct Base
+{
+    virtual ~Base() = default;
+    template <typename Archive>
+    void serialize(Archive& archive)
+    {
+        archive(muesli::make_nvp("point", _point));
+    }
+    Point _point;
+};
+
+struct Derived : Base
+{
+    template <typename Archive>
+    void serialize(Archive& archive)
+    {
+        archive(muesli::make_nvp("value", _value));
+    }
+    std::int32_t _value = 2;
+};
+
+struct Abstract
+{
+    virtual ~Abstract() = default;
+    virtual void f() = 0;
+};
+
+struct Concrete : Abstract
+{
+    void f() override
+    {
+    }
+    template <typename Archive>
+    void serialize(Archive&)
+    {
+    }
+};
+
+} // namespace typenames
+
+MUESLI_REGISTER_TYPE(typenames::Point, "typenames.Point")
+MUESLI_REGISTER_TYPE(typenames::Base, "typenames.Base")
+MUESLI_REGISTER_POLYMORPHIC_TYPE(typenames::Derived, typenames::Base, "typenames.Derived")
+MUESLI_REGISTER_TYPE(typenames::Abstract, "typenames.Abstract")
+MUESLI_REGISTER_POLYMORPHIC_TYPE(typenames::Concrete, typenames::Abstract, "typenames.Concrete")
+
+class PolymorphicTypeNamesOnlyTest : public ::testing::Test
+{
+public:
+    PolymorphicTypeNamesOnlyTest() : _values()
+    {
+        _values.push_back(std::make_unique<typenames::Base>());
+        _values.push_back(std::make_unique<typenames::Derived>());
+    }
+
+protected:
+    using Values = std::vector<std::unique_ptr<typenames::Base>>;
+
+    template <typename T>
+    static std::string serializeToJson(const T& value, bool writePolymorphicTypeNamesOnly)
+    {
+        muesli::StringOStream stream;
+        muesli::JsonOutputArchive<muesli::StringOStream> jsonOutputArchive(stream);
+        jsonOutputArchive.setWritePolymorphicTypeNamesOnly(writePolymorphicTypeNamesOnly);
+        jsonOutputArchive(value);
+        return stream.getString();
+    }
+
+    template <typename T>
+    static void deserializeFromJson(const std::string& json, T& value)
+    {
+        muesli::StringIStream stream(json);
+        muesli::JsonInputArchive<muesli::StringIStream> jsonInputArchive(stream);
+        jsonInputArchive(value);
+    }
+
+    static void expectLoadedTypes(const Values& values)
+    {
+        ASSERT_EQ(2, values.size());
+        EXPECT_EQ(typeid(typenames::Base), typeid(*values[0]));
+        EXPECT_EQ(typeid(typenames::Derived), typeid(*values[1]));
+    }
+
+    Values _values;
+};
+
+TEST_F(PolymorphicTypeNamesOnlyTest, allTypeNamesAreWrittenByDefault)
+{
+    EXPECT_EQ(R"([{"_typeName":"typenames.Base","point":{"_typeName":"typenames.Point","x":1}},)"
+              R"({"_typeName":"typenames.Derived","value":2}])",
+              serializeToJson(_values, false));
+}
+
+TEST_F(PolymorphicTypeNamesOnlyTest, onlyDynamicTypesDifferingFromStaticTypeAreNamed)
+{
+    EXPECT_EQ(R"([{"point":{"x":1}},{"_typeName":"typenames.Derived","value":2}])",
+              serializeToJson(_values, true));
+    EXPECT_EQ(R"({"x":1})", serializeToJson(typenames::Point(), true));
+
+    std::vector<std::unique_ptr<typenames::Abstract>> abstracts;
+    abstracts.push_back(std::make_unique<typenames::Concrete>());
+    EXPECT_EQ(R"([{"_typeName":"typenames.Concrete"}])", serializeToJson(abstracts, true));
+}
+
+TEST_F(PolymorphicTypeNamesOnlyTest, missingTypeNameLoadsStaticType)
+{
+    Values values;
+    deserializeFromJson(serializeToJson(_values, true), values);
+    expectLoadedTypes(values);
+}
+
+TEST_F(PolymorphicTypeNamesOnlyTest, missingTypeNameOfAbstractTypeIsAnError)
+{
+    std::vector<std::unique_ptr<typenames::Abstract>> abstracts;
+    EXPECT_THROW(deserializeFromJson(R"([{}])", abstracts),
+                 muesli::exceptions::ValueNotFoundException);
+}
+
+TEST_F(PolymorphicTypeNamesOnlyTest, binaryArchive)
+{
+    muesli::StringOStream outputStream;
+    muesli::BinaryOutputArchive<muesli::StringOStream> binaryOutputArchive(outputStream);
+    binaryOutputArchive.setWritePolymorphicTypeNamesOnly(true);
+    binaryOutputArchive(_values);
+    EXPECT_EQ(std::string::npos, outputStream.getString().find("typenames.Base"));
+    EXPECT_EQ(std::string::npos, outputStream.getString().find("typenames.Point"));
+
+    Values values;
+    muesli::StringIStream inputStream(outputStream.getString());
+    muesli::BinaryInputArchive<muesli::StringIStream> binaryInputArchive(inputStream);
+    binaryInputArchive(values);
+    expectLoadedTypes(values);
+}
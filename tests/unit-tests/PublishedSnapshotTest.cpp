@@ -0,0 +1,180 @@
+/*
+ * #%L
+ * %%
+ * Copyright (C) 2011 - 2016 BMW Car IT GmbH
+ * %%
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ * 
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ * 
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ * #L%
+ */
+
+#include <atomic>
+#include <cstddef>
+#include <thread>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "muesli/detail/PublishedSnapshot.h"
+
+namespace
+{
+using Numbers = std::vector<std::size_t>;
+
+// copy of Numbers which counts its live and its built instances
+struct CountedNumbers : Numbers
+{
+    explicit CountedNumbers(const Numbers& numbers) : Numbers(numbers)
+    {
+        ++instances;
+        ++built;
+    }
+
+    ~CountedNumbers()
+    {
+        --instances;
+    }
+
+    CountedNumbers(const CountedNumbers&) = delete;
+    CountedNumbers& operator=(const CountedNumbers&) = delete;
+
+    static std::atomic<int> instances;
+    static std::atomic<int> built;
+};
+
+std::atomic<int> CountedNumbers::instances(0);
+std::atomic<int> CountedNumbers::built(0);
+
+using NumbersSnapshot = muesli::detail::PublishedSnapshot<Numbers, CountedNumbers>;
+
+void append(NumbersSnapshot& snapshot, std::size_t number)
+{
+    snapshot.modify([number](Numbers& numbers) { numbers.push_back(number); });
+}
+
+Numbers read(NumbersSnapshot& snapshot)
+{
+    return snapshot.read([](const CountedNumbers& numbers) { return Numbers(numbers); });
+}
+} // namespace
+
+TEST(PublishedSnapshotTest, modificationsArePublishedByTheNextRead)
+{
+    NumbersSnapshot snapshot;
+    EXPECT_TRUE(snapshot.isPublished());
+    EXPECT_TRUE(read(snapshot).empty());
+
+    append(snapshot, 1);
+    EXPECT_FALSE(snapshot.isPublished());
+    EXPECT_EQ(Numbers({1}), read(snapshot));
+    EXPECT_TRUE(snapshot.isPublished());
+    append(snapshot, 2);
+    snapshot.publish();
+    EXPECT_TRUE(snapshot.isPublished());
+    EXPECT_EQ(Numbers({1, 2}), read(snapshot));
+}
+
+TEST(PublishedSnapshotTest, modificationsInARowBuildOneSnapshot)
+{
+    NumbersSnapshot snapshot;
+    const int built = CountedNumbers::built;
+    for (std::size_t number = 0; number < 100; ++number) {
+        append(snapshot, number);
+    }
+    EXPECT_EQ(100, read(snapshot).size());
+    EXPECT_EQ(100, read(snapshot).size());
+    EXPECT_EQ(built + 1, CountedNumbers::built);
+}
+
+TEST(PublishedSnapshotTest, supersededSnapshotsAreDeleted)
+{
+    {
+        NumbersSnapshot snapshot;
+        for (std::size_t number = 0; number < 100; ++number) {
+            append(snapshot, number);
+            read(snapshot);
+            EXPECT_EQ(1, CountedNumbers::instances);
+        }
+    }
+    EXPECT_EQ(0, CountedNumbers::instances);
+}
+
+TEST(PublishedSnapshotTest, batchDefersPublication)
+{
+    NumbersSnapshot first;
+    NumbersSnapshot second;
+    {
+        muesli::detail::PublicationBatch batch;
+        append(first, 1);
+        append(second, 2);
+        {
+            muesli::detail::PublicationBatch nestedBatch;
+            append(first, 3);
+        }
+        EXPECT_FALSE(first.isPublished());
+        EXPECT_TRUE(read(first).empty());
+        EXPECT_TRUE(read(second).empty());
+
+        // publishing explicitly does not wait for the batch
+        second.publish();
+        EXPECT_TRUE(second.isPublished());
+        EXPECT_EQ(Numbers({2}), read(second));
+    }
+    EXPECT_TRUE(first.isPublished());
+    EXPECT_EQ(Numbers({1, 3}), read(first));
+    EXPECT_EQ(Numbers({2}), read(second));
+}
+
+TEST(PublishedSnapshotTest, snapshotDestroyedWithinBatch)
+{
+    muesli::detail::PublicationBatch batch;
+    NumbersSnapshot snapshot;
+    append(snapshot, 1);
+}
+
+TEST(PublishedSnapshotTest, readersSeeConsistentSnapshotsWhileWriterModifies)
+{
+    constexpr std::size_t count = 1000;
+    NumbersSnapshot snapshot;
+    std::atomic<bool> failed(false);
+
+    std::vector<std::thread> readers;
+    for (int i = 0; i < 4; ++i) {
+        readers.emplace_back([&snapshot, &failed]() {
+            std::size_t lastSize = 0;
+            while (lastSize < count) {
+                const std::size_t size = snapshot.read([&failed](const CountedNumbers& numbers) {
+                    // snapshots only grow and are never modified after publication
+                    for (std::size_t index = 0; index < numbers.size(); ++index) {
+                        if (numbers[index] != index) {
+                            failed = true;
+                        }
+                    }
+                    return numbers.size();
+                });
+                if (size < lastSize) {
+                    failed = true;
+                }
+                lastSize = size;
+            }
+        });
+    }
+    for (std::size_t number = 0; number < count; ++number) {
+        append(snapshot, number);
+    }
+    for (std::thread& reader : readers) {
+        reader.join();
+    }
+    EXPECT_FALSE(failed);
+    EXPECT_EQ(count, read(snapshot).size());
+    EXPECT_EQ(1, CountedNumbers::instances);
+}
@@ -17,8 +17,7 @@
  * #L%
  */
 
-#include <boost/mpl/equal.hpp>
-#include <boost/mpl/vector.hpp>
+#include <type_traits>
 
 #include "MockArchive.h"
 #include "MockStream.h"
@@ -29,34 +28,33 @@
 // - MockInputArchive
 // - MockOutputArchive
 
-// since Archives are templates, they cannot be stored in a boost::mpl Sequence and have
+// since Archives are templates, they cannot be stored in a TypeList and have
 // therefore to be wrapped into a TemplateHolder (see ArchiveRegistry.h)
 
-static_assert(boost::mpl::equal<
-                      muesli::RegisteredOutputArchives,
-                      boost::mpl::vector<muesli::detail::TemplateHolder<MockOutputArchive>>>::value,
+using muesli::detail::TemplateHolder;
+using muesli::detail::TypeList;
+
+static_assert(std::is_same<muesli::RegisteredOutputArchives,
+                           TypeList<TemplateHolder<MockOutputArchive>>>::value,
               "type vectors must match");
-static_assert(boost::mpl::equal<
-                      muesli::RegisteredInputArchives,
-                      boost::mpl::vector<muesli::detail::TemplateHolder<MockInputArchive>>>::value,
+static_assert(std::is_same<muesli::RegisteredInputArchives,
+                           TypeList<TemplateHolder<MockInputArchive>>>::value,
               "type vectors must match");
 
 // in this test, the following Streams are included and therefore are expected to be registered:
 // - MockInputStream
 // - MockOutputStream
-static_assert(boost::mpl::equal<muesli::RegisteredInputStreams,
-                                boost::mpl::vector<MockInputStream>>::value,
+static_assert(std::is_same<muesli::RegisteredInputStreams, TypeList<MockInputStream>>::value,
               "type vectors must match");
-static_assert(boost::mpl::equal<muesli::RegisteredOutputStreams,
-                                boost::mpl::vector<MockOutputStream>>::value,
+static_assert(std::is_same<muesli::RegisteredOutputStreams, TypeList<MockOutputStream>>::value,
               "type vectors must match");
 
 // check that OutputArchiveTypeVector is as expected
-static_assert(boost::mpl::equal<muesli::OutputArchiveTypeVector,
-                                boost::mpl::vector<MockOutputArchive<MockOutputStream>>>::value,
+static_assert(std::is_same<muesli::OutputArchiveTypeVector,
+                           TypeList<MockOutputArchive<MockOutputStream>>>::value,
               "type vectors must match");
 
 // check that InputArchiveTypeVector is as expected
-static_assert(boost::mpl::equal<muesli::InputArchiveTypeVector,
-                                boost::mpl::vector<MockInputArchive<MockInputStream>>>::value,
+static_assert(std::is_same<muesli::InputArchiveTypeVector,
+                           TypeList<MockInputArchive<MockInputStream>>>::value,
               "type vectors must match");
@@ -0,0 +1,165 @@
+/*
+ * #%L
+ * %%
+ * Copyright (C) 2011 - 2016 BMW Car IT GmbH
+ * %%
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ * 
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ * 
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ * #L%
+ */
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "muesli/Transcoder.h"
+
+#include "muesli/archives/binary/BinaryInputArchive.h"
+#include "muesli/archives/binary/BinaryOutputArchive.h"
+#include "muesli/archives/json/JsonInputArchive.h"
+#include "muesli/archives/json/JsonOutputArchive.h"
+
+#include "muesli/exceptions/ParseException.h"
+
+#include "muesli/streams/StringIStream.h"
+#include "muesli/streams/StringOStream.h"
+
+#include "testtypes/NestedStructs.h"
+#include "testtypes/TEnum.h"
+#include "testtypes/TStruct.h"
+#include "testtypes/TStructExtended.h"
+
+using muesli::tests::testtypes::NestedStructPolymorphic;
+using muesli::tests::testtypes::TEnum;
+using muesli::tests::testtypes::TStructExtended;
+
+class TranscoderTest : public ::testing::Test
+{
+public:
+    TranscoderTest()
+            : _nestedStruct({std::make_shared<TStructExtended>(
+                      0.123456789, 64, "test string data", TEnum::TLITERALB, -32)})
+    {
+    }
+
+protected:
+    template <typename OutputArchiveTag, typename T>
+    static std::string serialize(const T& value)
+    {
+        using OutputArchive = typename muesli::OutputArchiveTraits<
+                OutputArchiveTag>::template type<muesli::StringOStream>;
+        muesli::StringOStream stream;
+        OutputArchive outputArchive(stream);
+        outputArchive(value);
+        return stream.getString();
+    }
+
+    template <typename InputArchiveTag, typename OutputArchiveTag>
+    static std::string transcode(const std::string& input)
+    {
+        muesli::StringIStream inputStream(input);
+        muesli::StringOStream outputStream;
+        muesli::transcode<InputArchiveTag, OutputArchiveTag>(inputStream, outputStream);
+        return outputStream.getString();
+    }
+
+    NestedStructPolymorphic _nestedStruct;
+};
+
+TEST_F(TranscoderTest, jsonToBinary)
+{
+    const std::string binary = transcode<muesli::tags::json, muesli::tags::binary>(
+            serialize<muesli::tags::json>(_nestedStruct));
+
+    muesli::StringIStream stream(binary);
+    muesli::BinaryInputArchive<muesli::StringIStream> binaryInputArchive(stream);
+    NestedStructPolymorphic deserialized;
+    binaryInputArchive(deserialized);
+    EXPECT_EQ(_nestedStruct, deserialized);
+}
+
+TEST_F(TranscoderTest, binaryToJsonMatchesJsonOutputArchive)
+{
+    EXPECT_EQ(serialize<muesli::tags::json>(_nestedStruct),
+              (transcode<muesli::tags::binary, muesli::tags::json>(
+                      serialize<muesli::tags::binary>(_nestedStruct))));
+}
+
+TEST_F(TranscoderTest, packedArraysAreWrittenAsJsonArrays)
+{
+    const std::vector<std::int32_t> integers = {1, -2, 300};
+    EXPECT_EQ("[1,-2,300]",
+              (transcode<muesli::tags::binary, muesli::tags::json>(
+                      serialize<muesli::tags::binary>(integers))));
+
+    const std::vector<double> doubles = {0.5, -1.25};
+    EXPECT_EQ("[0.5,-1.25]",
+              (transcode<muesli::tags::binary, muesli::tags::json>(
+                      serialize<muesli::tags::binary>(doubles))));
+}
+
+TEST_F(TranscoderTest, jsonToJson)
+{
+    const std::string json = R"({"a":[1,-2,{"b":null}],"c":"d","e":true})";
+    EXPECT_EQ(json, (transcode<muesli::tags::json, muesli::tags::json>(json)));
+}
+
+TEST_F(TranscoderTest, invalidJsonCausesParseException)
+{
+    EXPECT_THROW((transcode<muesli::tags::json, muesli::tags::binary>("{\"a\":")),
+                 muesli::exceptions::ParseException);
+}
+
+TEST_F(TranscoderTest, nonStringKeyInBinaryCausesParseException)
+{
+    // object with the integer 1 in key position
+    const std::string binary("\x0B\x04\x01\x04\x02\x0C", 6);
+    EXPECT_THROW((transcode<muesli::tags::binary, muesli::tags::json>(binary)),
+                 muesli::exceptions::ParseException);
+}
+
+TEST_F(TranscoderTest, truncatedBinaryCausesParseException)
+{
+    const std::string binary = serialize<muesli::tags::binary>(_nestedStruct);
+    for (std::size_t length = 0; length < binary.size(); ++length) {
+        const std::string truncated = binary.substr(0, length);
+        EXPECT_THROW((transcode<muesli::tags::binary, muesli::tags::json>(truncated)),
+                     muesli::exceptions::ParseException)
+                << "input truncated to " << length << " bytes";
+    }
+}
+
+TEST_F(TranscoderTest, oversizedLengthInBinaryCausesParseException)
+{
+    // String marker, varint length 2^64 - 1, three characters
+    const std::string oversizedString =
+            std::string("\x08\xFF\xFF\xFF\xFF\xFF\xFF\xFF\xFF\xFF\x01") + "abc";
+    EXPECT_THROW((transcode<muesli::tags::binary, muesli::tags::json>(oversizedString)),
+                 muesli::exceptions::ParseException);
+
+    // PackedArray marker, UnsignedInteger elements, count 3, payload size 2^62, three bytes
+    const std::string oversizedPackedArray(
+            "\x0D\x04\x03\x80\x80\x80\x80\x80\x80\x80\x80\x40\x01\x02\x03", 15);
+    EXPECT_THROW((transcode<muesli::tags::binary, muesli::tags::json>(oversizedPackedArray)),
+                 muesli::exceptions::ParseException);
+}
+
+TEST_F(TranscoderTest, packedArrayNotMatchingItsCountCausesParseException)
+{
+    // PackedArray marker, UnsignedInteger elements, count 2, payload size 3, three varints
+    const std::string binary("\x0D\x04\x02\x03\x01\x02\x03", 7);
+    EXPECT_THROW((transcode<muesli::tags::binary, muesli::tags::json>(binary)),
+                 muesli::exceptions::ParseException);
+}
@@ -0,0 +1,154 @@
+/*
+ * #%L
+ * %%
+ * Copyright (C) 2011 - 2016 BMW Car IT GmbH
+ * %%
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ * 
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ * 
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ * #L%
+ */
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <typeinfo>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "muesli/archives/binary/BinaryInputArchive.h"
+#include "muesli/archives/binary/BinaryOutputArchive.h"
+#include "muesli/archives/json/JsonInputArchive.h"
+#include "muesli/archives/json/JsonOutputArchive.h"
+#include "muesli/streams/StringIStream.h"
+#include "muesli/streams/StringOStream.h"
+
+#include "muesli/NameValuePair.h"
+#include "muesli/TypeRegistry.h"
+
+namespace aliased
+{
+
+struct Base
+{
+    virtual ~Base() = default;
+    template <typename Archive>
+    void serialize(Archive& archive)
+    {
+        archive(muesli::make_nvp("id", _id));
+    }
+    std::int32_t _id = 1;
+};
+
+struct Derived : Base
+{
+    template <typename Archive>
+    void serialize(Archive& archive)
+    {
+        archive(muesli::make_nvp("value", _value));
+    }
+    std::int32_t _value = 2;
+};
+
+struct Unaliased : Base
+{
+    template <typename Archive>
+    void serialize(Archive& archive)
+    {
+        archive(muesli::make_nvp("value", _value));
+    }
+    std::int32_t _value = 3;
+};
+
+} // namespace aliased
+
+MUESLI_REGISTER_TYPE_WITH_ALIAS(aliased::Base, "aliased.Base", "B")
+MUESLI_REGISTER_POLYMORPHIC_TYPE_WITH_ALIAS(aliased::Derived,
+                                            aliased::Base,
+                                            "aliased.Derived",
+                                            "D")
+MUESLI_REGISTER_POLYMORPHIC_TYPE(aliased::Unaliased, aliased::Base, "aliased.Unaliased")
+
+class TypeAliasTest : public ::testing::Test
+{
+public:
+    TypeAliasTest() : _values()
+    {
+        _values.push_back(std::make_unique<aliased::Base>());
+        _values.push_back(std::make_unique<aliased::Derived>());
+        _values.push_back(std::make_unique<aliased::Unaliased>());
+    }
+
+protected:
+    using Values = std::vector<std::unique_ptr<aliased::Base>>;
+
+    std::string serializeToJson(bool writeTypeAliases) const
+    {
+        muesli::StringOStream stream;
+        muesli::JsonOutputArchive<muesli::StringOStream> jsonOutputArchive(stream);
+        jsonOutputArchive.setWriteTypeAliases(writeTypeAliases);
+        jsonOutputArchive(_values);
+        return stream.getString();
+    }
+
+    static void expectLoadedTypes(const Values& values)
+    {
+        ASSERT_EQ(3, values.size());
+        EXPECT_EQ(typeid(aliased::Base), typeid(*values[0]));
+        EXPECT_EQ(typeid(aliased::Derived), typeid(*values[1]));
+        EXPECT_EQ(typeid(aliased::Unaliased), typeid(*values[2]));
+    }
+
+    Values _values;
+};
+
+TEST_F(TypeAliasTest, namesAreWrittenByDefault)
+{
+    EXPECT_EQ(R"([{"_typeName":"aliased.Base","id":1},)"
+              R"({"_typeName":"aliased.Derived","value":2},)"
+              R"({"_typeName":"aliased.Unaliased","value":3}])",
+              serializeToJson(false));
+}
+
+TEST_F(TypeAliasTest, aliasesAreWrittenIfEnabled)
+{
+    EXPECT_EQ(R"([{"_typeName":"B","id":1},)"
+              R"({"_typeName":"D","value":2},)"
+              R"({"_typeName":"aliased.Unaliased","value":3}])",
+              serializeToJson(true));
+}
+
+TEST_F(TypeAliasTest, namesAndAliasesAreLoaded)
+{
+    for (bool writeTypeAliases : {false, true}) {
+        Values values;
+        muesli::StringIStream stream(serializeToJson(writeTypeAliases));
+        muesli::JsonInputArchive<muesli::StringIStream> jsonInputArchive(stream);
+        jsonInputArchive(values);
+        expectLoadedTypes(values);
+    }
+}
+
+TEST_F(TypeAliasTest, binaryArchiveWritesAndLoadsAliases)
+{
+    muesli::StringOStream outputStream;
+    muesli::BinaryOutputArchive<muesli::StringOStream> binaryOutputArchive(outputStream);
+    binaryOutputArchive.setWriteTypeAliases(true);
+    binaryOutputArchive(_values);
+    EXPECT_EQ(std::string::npos, outputStream.getString().find("aliased.Derived"));
+
+    Values values;
+    muesli::StringIStream inputStream(outputStream.getString());
+    muesli::BinaryInputArchive<muesli::StringIStream> binaryInputArchive(inputStream);
+    binaryInputArchive(values);
+    expectLoadedTypes(values);
+}
@@ -17,7 +17,12 @@
  * #L%
  */
 
+#include <atomic>
 #include <memory>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <typeindex>
 #include <typeinfo>
 
 #include <gtest/gtest.h>
@@ -94,9 +99,10 @@ MUESLI_REGISTER_TYPE(polymorphic::Base, "polymorphic.Base")
 MUESLI_REGISTER_POLYMORPHIC_TYPE(polymorphic::DerivedOne,
                                  polymorphic::Base,
                                  "polymorphic.DerivedOne")
-MUESLI_REGISTER_POLYMORPHIC_TYPE(polymorphic::DerivedTwo,
-                                 polymorphic::Base,
-                                 "polymorphic.DerivedTwo")
+MUESLI_REGISTER_POLYMORPHIC_TYPE_WITH_ALIAS(polymorphic::DerivedTwo,
+                                            polymorphic::Base,
+                                            "polymorphic.DerivedTwo",
+                                            "2")
 
 MUESLI_REGISTER_POLYMORPHIC_TYPE(polymorphic::DerivedFromDerivedOne,
                                  polymorphic::DerivedOne,
@@ -137,6 +143,36 @@ TYPED_TEST(TypedTypeRegistryTest, polymorphicTypeInputRegistry)
     EXPECT_EQ(typeid(TypeParam), typeid(*p));
 }
 
+TEST(TypeRegistryTest, lookupFreezesInputRegistry)
+{
+    using TypeRegistry = muesli::TypeLoadRegistry<polymorphic::Base, MockInputArchiveImpl>;
+
+    const std::string typeName = "polymorphic.DerivedTwo, followed by other data";
+    EXPECT_TRUE(TypeRegistry::getLoadFunction(typeName.data(), 22).is_initialized());
+    EXPECT_TRUE(TypeRegistry::isFrozen());
+    EXPECT_TRUE(TypeRegistry::getSharedLoadFunction(typeName.data(), 22).is_initialized());
+    EXPECT_FALSE(TypeRegistry::getLoadFunction(typeName.data(), 21).is_initialized());
+    EXPECT_FALSE(TypeRegistry::getLoadFunction("polymorphic.Unknown").is_initialized());
+}
+
+TEST(TypeRegistryTest, inputRegistryResolvesAliases)
+{
+    using TypeRegistry = muesli::TypeLoadRegistry<polymorphic::Base, MockInputArchiveImpl>;
+
+    boost::optional<TypeRegistry::LoadFunction> byName =
+            TypeRegistry::getLoadFunction("polymorphic.DerivedTwo");
+    boost::optional<TypeRegistry::LoadFunction> byAlias = TypeRegistry::getLoadFunction("2");
+    ASSERT_TRUE(byName.is_initialized());
+    ASSERT_TRUE(byAlias.is_initialized());
+    EXPECT_EQ(*byName, *byAlias);
+    EXPECT_TRUE(TypeRegistry::getSharedLoadFunction("2").is_initialized());
+    EXPECT_TRUE(TypeRegistry::getInPlaceLoadFunction(typeid(polymorphic::DerivedTwo), "2")
+                        .is_initialized());
+    EXPECT_FALSE(TypeRegistry::getInPlaceLoadFunction(typeid(polymorphic::DerivedOne), "")
+                         .is_initialized());
+    EXPECT_EQ(nullptr, muesli::detail::RegisteredTypeAlias<polymorphic::DerivedOne>::alias());
+}
+
 TEST(TypeRegistryTest, polymorphicTypeOutputRegistry)
 {
     using TypeRegistry = muesli::TypeSaveRegistry<polymorphic::Base, MockOutputArchiveImpl>;
@@ -150,6 +186,129 @@ TEST(TypeRegistryTest, polymorphicTypeOutputRegistry)
     (*saveFunction)(outputArchive, derivedOne.get());
 }
 
+TEST(TypeRegistryTest, cachedOutputRegistryLookupsMatchRegistry)
+{
+    using TypeRegistry = muesli::TypeSaveRegistry<polymorphic::Base, MockOutputArchiveImpl>;
+
+    using SaveFunction = typename TypeRegistry::SaveFunction;
+
+    const SaveFunction saveDerivedOne =
+            *TypeRegistry::getSaveFunction(std::type_index(typeid(polymorphic::DerivedOne)));
+    const SaveFunction saveDerivedTwo =
+            *TypeRegistry::getSaveFunction(std::type_index(typeid(polymorphic::DerivedTwo)));
+    EXPECT_NE(saveDerivedOne, saveDerivedTwo);
+    for (int i = 0; i < 3; ++i) {
+        EXPECT_EQ(saveDerivedOne, *TypeRegistry::getSaveFunction(typeid(polymorphic::DerivedOne)));
+        EXPECT_EQ(saveDerivedTwo, *TypeRegistry::getSaveFunction(typeid(polymorphic::DerivedTwo)));
+        EXPECT_FALSE(TypeRegistry::getSaveFunction(typeid(NonPolymorphicType)).is_initialized());
+    }
+}
+
+namespace plugin
+{
+struct Derived : polymorphic::Base
+{
+};
+
+struct Batched : polymorphic::Base
+{
+};
+
+struct Colliding : polymorphic::Base
+{
+};
+} // namespace plugin
+
+TEST(TypeRegistryTest, runtimeRegistrationIsVisibleToConcurrentLookups)
+{
+    using LoadRegistry = muesli::TypeLoadRegistry<polymorphic::Base, MockInputArchiveImpl>;
+    using SaveRegistry = muesli::TypeSaveRegistry<polymorphic::Base, MockOutputArchiveImpl>;
+
+    std::atomic<bool> loaded(false);
+    std::thread lookups([&loaded]() {
+        while (!loaded) {
+            EXPECT_TRUE(LoadRegistry::getLoadFunction("polymorphic.DerivedOne").is_initialized());
+            loaded = LoadRegistry::getLoadFunction("plugin.Derived").is_initialized();
+        }
+    });
+
+    LoadRegistry::insert(
+            "plugin.Derived",
+            "pd",
+            typeid(plugin::Derived),
+            [](MockInputArchiveImpl&) -> std::unique_ptr<polymorphic::Base> {
+                return std::make_unique<plugin::Derived>();
+            },
+            [](MockInputArchiveImpl&) -> std::shared_ptr<polymorphic::Base> {
+                return std::make_shared<plugin::Derived>();
+            },
+            [](MockInputArchiveImpl&, polymorphic::Base*) {});
+    SaveRegistry::insert(typeid(plugin::Derived),
+                         [](MockOutputArchiveImpl&, const polymorphic::Base*) {});
+    lookups.join();
+
+    MockInputArchiveImpl inputArchive;
+    std::unique_ptr<polymorphic::Base> loadedByAlias =
+            (*LoadRegistry::getLoadFunction("pd"))(inputArchive);
+    EXPECT_EQ(typeid(plugin::Derived), typeid(*loadedByAlias));
+    EXPECT_TRUE(LoadRegistry::getInPlaceLoadFunction(typeid(plugin::Derived), "plugin.Derived")
+                        .is_initialized());
+    EXPECT_TRUE(SaveRegistry::getSaveFunction(typeid(plugin::Derived)).is_initialized());
+}
+
+TEST(TypeRegistryTest, registrationBatchPublishesWhenItEnds)
+{
+    using LoadRegistry = muesli::TypeLoadRegistry<polymorphic::Base, MockInputArchiveImpl>;
+
+    {
+        muesli::RegistrationBatch batch;
+        LoadRegistry::insert(
+                "plugin.Batched",
+                nullptr,
+                typeid(plugin::Batched),
+                [](MockInputArchiveImpl&) -> std::unique_ptr<polymorphic::Base> {
+                    return std::make_unique<plugin::Batched>();
+                },
+                [](MockInputArchiveImpl&) -> std::shared_ptr<polymorphic::Base> {
+                    return std::make_shared<plugin::Batched>();
+                },
+                [](MockInputArchiveImpl&, polymorphic::Base*) {});
+        EXPECT_FALSE(LoadRegistry::isFrozen());
+        EXPECT_FALSE(LoadRegistry::getLoadFunction("plugin.Batched").is_initialized());
+        EXPECT_TRUE(LoadRegistry::getLoadFunction("polymorphic.DerivedOne").is_initialized());
+    }
+    EXPECT_TRUE(LoadRegistry::isFrozen());
+    EXPECT_TRUE(LoadRegistry::getLoadFunction("plugin.Batched").is_initialized());
+}
+
+TEST(TypeRegistryTest, nameOrAliasOfAnotherTypeIsRejected)
+{
+    using LoadRegistry = muesli::TypeLoadRegistry<polymorphic::Base, MockInputArchiveImpl>;
+
+    auto insert = [](const std::string& typeName, const char* typeAlias) {
+        LoadRegistry::insert(
+                typeName,
+                typeAlias,
+                typeid(plugin::Colliding),
+                [](MockInputArchiveImpl&) -> std::unique_ptr<polymorphic::Base> {
+                    return std::make_unique<plugin::Colliding>();
+                },
+                [](MockInputArchiveImpl&) -> std::shared_ptr<polymorphic::Base> {
+                    return std::make_shared<plugin::Colliding>();
+                },
+                [](MockInputArchiveImpl&, polymorphic::Base*) {});
+    };
+    EXPECT_THROW(insert("polymorphic.DerivedOne", nullptr), std::invalid_argument);
+    EXPECT_THROW(insert("plugin.Colliding", "polymorphic.DerivedOne"), std::invalid_argument);
+    EXPECT_THROW(insert("plugin.Colliding", "2"), std::invalid_argument);
+    EXPECT_FALSE(LoadRegistry::getLoadFunction("plugin.Colliding").is_initialized());
+
+    MockInputArchiveImpl inputArchive;
+    std::unique_ptr<polymorphic::Base> loadedByAlias =
+            (*LoadRegistry::getLoadFunction("2"))(inputArchive);
+    EXPECT_EQ(typeid(polymorphic::DerivedTwo), typeid(*loadedByAlias));
+}
+
 // TODO 2 additional test cases: compile static and shared library which contains the datatypes,
 // then perform the actual (de-)serialization in the executable which links against one of the
 // libraries
@@ -0,0 +1,400 @@
+/*
+ * #%L
+ * %%
+ * Copyright (C) 2011 - 2016 BMW Car IT GmbH
+ * %%
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ * 
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ * 
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ * #L%
+ */
+
+#include <cstdint>
+#include <limits>
+#include <map>
+#include <memory>
+#include <set>
+#include <stdexcept>
+#include <string>
+#include <tuple>
+#include <vector>
+
+#include <boost/optional.hpp>
+
+#include <gtest/gtest.h>
+
+#include "muesli/archives/binary/BinaryInputArchive.h"
+#include "muesli/archives/binary/BinaryOutputArchive.h"
+
+#include "muesli/exceptions/ParseException.h"
+#include "muesli/exceptions/ValueNotFoundException.h"
+
+#include "muesli/streams/StringIStream.h"
+#include "muesli/streams/StringOStream.h"
+
+#include "testtypes/NestedStructs.h"
+#include "testtypes/TEnum.h"
+#include "testtypes/TStruct.h"
+#include "testtypes/TStructExtended.h"
+
+using BinaryOutputArchiveImpl = muesli::BinaryOutputArchive<muesli::StringOStream>;
+using BinaryInputArchiveImpl = muesli::BinaryInputArchive<muesli::StringIStream>;
+
+using muesli::tests::testtypes::NestedBoostOptionalStruct;
+using muesli::tests::testtypes::NestedStruct;
+using muesli::tests::testtypes::NestedStructPolymorphic;
+using muesli::tests::testtypes::NestedUniquePtrStruct;
+using muesli::tests::testtypes::TEnum;
+using muesli::tests::testtypes::TStruct;
+using muesli::tests::testtypes::TStructExtended;
+
+namespace
+{
+struct OptionalField
+{
+    boost::optional<std::int32_t> _value;
+
+    template <typename Archive>
+    void serialize(Archive& archive)
+    {
+        archive(muesli::make_nvp("value", _value));
+    }
+};
+
+// newer version of OptionalField with an additional field in front of the nullable one
+struct OptionalFieldV2
+{
+    std::string _added;
+    boost::optional<std::int32_t> _value;
+
+    template <typename Archive>
+    void serialize(Archive& archive)
+    {
+        archive(muesli::make_nvp("added", _added), muesli::make_nvp("value", _value));
+    }
+};
+
+struct Point
+{
+    std::int32_t _x;
+    std::int32_t _y;
+
+    template <typename Archive>
+    void serialize(Archive& archive)
+    {
+        archive(muesli::make_nvp("x", _x), muesli::make_nvp("y", _y));
+    }
+};
+
+// Point with fields in reverse order, nested in a struct which is written in reverse order, too
+struct ReversedPoint
+{
+    std::int32_t _x;
+    std::int32_t _y;
+
+    template <typename Archive>
+    void serialize(Archive& archive)
+    {
+        archive(muesli::make_nvp("y", _y), muesli::make_nvp("x", _x));
+    }
+};
+
+template <typename PointType>
+struct Segment
+{
+    PointType _from;
+    std::string _label;
+
+    template <typename Archive>
+    void serialize(Archive& archive)
+    {
+        archive(muesli::make_nvp("from", _from), muesli::make_nvp("label", _label));
+    }
+};
+
+struct ReversedSegment
+{
+    ReversedPoint _from;
+    std::string _label;
+
+    template <typename Archive>
+    void serialize(Archive& archive)
+    {
+        archive(muesli::make_nvp("label", _label), muesli::make_nvp("from", _from));
+    }
+};
+} // namespace
+
+class BinaryArchiveTest : public ::testing::Test
+{
+public:
+    BinaryArchiveTest()
+            : _tStruct(0.123456789, 64, "test string data"),
+              _tStructExtended(0.123456789, 64, "test string data", TEnum::TLITERALB, 32)
+    {
+    }
+
+protected:
+    template <typename T>
+    std::string serialize(const T& value)
+    {
+        muesli::StringOStream stream;
+        BinaryOutputArchiveImpl binaryOutputArchive(stream);
+        binaryOutputArchive(value);
+        return stream.getString();
+    }
+
+    template <typename T>
+    void deserialize(const std::string& serialized, T& value)
+    {
+        muesli::StringIStream stream(serialized);
+        BinaryInputArchiveImpl binaryInputArchive(stream);
+        binaryInputArchive(value);
+    }
+
+    template <typename T>
+    void expectRoundtrip(const T& value)
+    {
+        T deserialized;
+        deserialize(serialize(value), deserialized);
+        EXPECT_EQ(value, deserialized);
+    }
+
+    TStruct _tStruct;
+    TStructExtended _tStructExtended;
+};
+
+TEST_F(BinaryArchiveTest, roundtripStruct)
+{
+    expectRoundtrip(_tStruct);
+}
+
+TEST_F(BinaryArchiveTest, roundtripStructExtended)
+{
+    expectRoundtrip(_tStructExtended);
+}
+
+TEST_F(BinaryArchiveTest, roundtripNestedStruct)
+{
+    expectRoundtrip(NestedStruct{_tStruct});
+}
+
+TEST_F(BinaryArchiveTest, roundtripVectorOfStructs)
+{
+    expectRoundtrip(std::vector<TStruct>{_tStruct, TStruct(-1.5, -64, "second")});
+}
+
+TEST_F(BinaryArchiveTest, polymorphismDerived)
+{
+    NestedStructPolymorphic nestedStructPolymorphic = {
+            std::make_shared<TStructExtended>(_tStructExtended)};
+    expectRoundtrip(nestedStructPolymorphic);
+}
+
+TEST_F(BinaryArchiveTest, nullptrSerializationPolymorphism)
+{
+    expectRoundtrip(NestedStructPolymorphic{nullptr});
+}
+
+TEST_F(BinaryArchiveTest, absentNullableFields)
+{
+    NestedBoostOptionalStruct withoutOptional;
+    expectRoundtrip(withoutOptional);
+
+    NestedBoostOptionalStruct withOptional;
+    withOptional.copyToOptional();
+    expectRoundtrip(withOptional);
+
+    NestedUniquePtrStruct uniquePtrStruct;
+    uniquePtrStruct.copyToOptional();
+    NestedUniquePtrStruct deserialized;
+    deserialize(serialize(uniquePtrStruct), deserialized);
+    EXPECT_EQ(uniquePtrStruct, deserialized);
+}
+
+TEST_F(BinaryArchiveTest, smallIntegersAreEncodedCompactly)
+{
+    EXPECT_EQ(2u, serialize(std::uint64_t(1)).size());
+    EXPECT_EQ(2u, serialize(std::int64_t(-1)).size());
+    EXPECT_EQ(3u, serialize(std::int32_t(-1000)).size());
+    EXPECT_EQ(11u, serialize(std::numeric_limits<std::uint64_t>::max()).size());
+}
+
+TEST_F(BinaryArchiveTest, integerLimitsRoundtrip)
+{
+    expectRoundtrip(std::numeric_limits<std::int64_t>::min());
+    expectRoundtrip(std::numeric_limits<std::int64_t>::max());
+    expectRoundtrip(std::numeric_limits<std::uint64_t>::max());
+    expectRoundtrip(std::numeric_limits<std::int8_t>::min());
+    expectRoundtrip(std::numeric_limits<std::uint16_t>::max());
+}
+
+TEST_F(BinaryArchiveTest, integerOutOfRangeThrows)
+{
+    std::int8_t int8Value;
+    EXPECT_THROW(deserialize(serialize(std::int64_t(300)), int8Value), std::invalid_argument);
+    std::uint32_t uint32Value;
+    EXPECT_THROW(deserialize(serialize(std::int32_t(-1)), uint32Value), std::invalid_argument);
+}
+
+TEST_F(BinaryArchiveTest, vectorOfIntegersIsPacked)
+{
+    std::vector<std::int32_t> values;
+    for (std::int32_t i = -50; i < 50; ++i) {
+        values.push_back(i);
+    }
+    // marker, element marker, count, payload size and one byte per value
+    EXPECT_EQ(4u + values.size(), serialize(values).size());
+    expectRoundtrip(values);
+}
+
+TEST_F(BinaryArchiveTest, packedVectorsRoundtrip)
+{
+    expectRoundtrip(std::vector<std::uint64_t>{
+            0, 1, 127, 128, 1ULL << 40, std::numeric_limits<std::uint64_t>::max(), 5, 6, 7, 8});
+    expectRoundtrip(std::vector<std::int64_t>{std::numeric_limits<std::int64_t>::min(), -1, 0, 1});
+    expectRoundtrip(std::vector<double>{0.5, -1.25, 1e300});
+    expectRoundtrip(std::vector<float>{0.5f, -1.25f});
+    expectRoundtrip(std::vector<std::int16_t>());
+}
+
+TEST_F(BinaryArchiveTest, readPackableVectorWrittenElementByElement)
+{
+    const std::set<std::int32_t> values = {-3, 1, 200};
+    std::vector<std::int32_t> deserialized;
+    deserialize(serialize(values), deserialized);
+    EXPECT_EQ(std::vector<std::int32_t>({-3, 1, 200}), deserialized);
+}
+
+TEST_F(BinaryArchiveTest, roundtripContainers)
+{
+    expectRoundtrip(std::vector<std::string>{"a", "", std::string("binary\0data", 11)});
+    expectRoundtrip(std::vector<bool>{true, false, true});
+    expectRoundtrip(std::map<std::string, std::int32_t>{{"one", 1}, {"two", -2}});
+    expectRoundtrip(std::map<TEnum::Enum, TStruct>{{TEnum::TLITERALA, _tStruct}});
+    expectRoundtrip(std::map<std::int32_t, std::vector<std::int32_t>>{{3, {1, 2, 3}}, {4, {}}});
+}
+
+TEST_F(BinaryArchiveTest, roundtripTuple)
+{
+    expectRoundtrip(std::make_tuple(std::int32_t(123), TEnum::TLITERALA, _tStruct, std::string("x")));
+}
+
+TEST_F(BinaryArchiveTest, throwExceptionForInvalidTupleLength)
+{
+    std::tuple<std::int32_t, std::string, std::int32_t> longerTuple;
+    EXPECT_THROW(deserialize(serialize(std::make_tuple(std::int32_t(1), std::string("test"))),
+                             longerTuple),
+                 muesli::exceptions::ParseException);
+
+    std::tuple<std::int32_t> shorterTuple;
+    EXPECT_THROW(deserialize(serialize(std::make_tuple(std::int32_t(1), std::string("test"))),
+                             shorterTuple),
+                 muesli::exceptions::ParseException);
+}
+
+TEST_F(BinaryArchiveTest, unknownFieldsAreSkipped)
+{
+    TStruct deserialized;
+    deserialize(serialize(_tStructExtended), deserialized);
+    EXPECT_EQ(_tStruct, deserialized);
+}
+
+TEST_F(BinaryArchiveTest, deserializeThrowsOnMissingField)
+{
+    TStructExtended deserialized;
+    EXPECT_THROW(deserialize(serialize(_tStruct), deserialized),
+                 muesli::exceptions::ValueNotFoundException);
+}
+
+TEST_F(BinaryArchiveTest, invalidMarkerCausesParseException)
+{
+    TStruct deserialized;
+    EXPECT_THROW(deserialize(std::string("\x7F"), deserialized),
+                 muesli::exceptions::ParseException);
+}
+
+TEST_F(BinaryArchiveTest, unknownFieldBeforeNullableFieldIsSkipped)
+{
+    OptionalFieldV2 newer{"added", 42};
+    OptionalField deserialized;
+    deserialize(serialize(newer), deserialized);
+    ASSERT_TRUE(deserialized._value);
+    EXPECT_EQ(42, *deserialized._value);
+
+    newer._value = boost::none;
+    deserialize(serialize(newer), deserialized);
+    EXPECT_FALSE(deserialized._value);
+}
+
+TEST_F(BinaryArchiveTest, fieldsWrittenInDifferentOrderAreLoaded)
+{
+    const ReversedSegment reversed{ReversedPoint{1, 2}, "label"};
+    Segment<Point> deserialized{Point{0, 0}, ""};
+    deserialize(serialize(reversed), deserialized);
+    EXPECT_EQ(1, deserialized._from._x);
+    EXPECT_EQ(2, deserialized._from._y);
+    EXPECT_EQ("label", deserialized._label);
+}
+
+TEST_F(BinaryArchiveTest, truncatedInputCausesParseException)
+{
+    const std::string serialized = serialize(_tStructExtended);
+    for (std::size_t length = 0; length < serialized.size(); ++length) {
+        TStructExtended deserialized;
+        EXPECT_THROW(deserialize(serialized.substr(0, length), deserialized),
+                     muesli::exceptions::ParseException)
+                << "input truncated to " << length << " bytes";
+    }
+}
+
+TEST_F(BinaryArchiveTest, oversizedLengthCausesParseException)
+{
+    // String marker, varint length 2^64 - 1, three characters
+    const std::string oversizedString =
+            std::string("\x08\xFF\xFF\xFF\xFF\xFF\xFF\xFF\xFF\xFF\x01") + "abc";
+    std::string stringValue;
+    EXPECT_THROW(deserialize(oversizedString, stringValue), muesli::exceptions::ParseException);
+
+    // PackedArray marker, UnsignedInteger elements, count and payload size 2^62, three bytes
+    const std::string oversizedPackedArray(
+            "\x0D\x04\x80\x80\x80\x80\x80\x80\x80\x80\x40"
+            "\x80\x80\x80\x80\x80\x80\x80\x80\x40\x01\x02\x03",
+            23);
+    std::vector<std::uint32_t> arrayValue;
+    EXPECT_THROW(
+            deserialize(oversizedPackedArray, arrayValue), muesli::exceptions::ParseException);
+}
+
+TEST_F(BinaryArchiveTest, invalidVarintCausesParseException)
+{
+    // UnsignedInteger marker, the tenth byte of the varint holds bits above 2^63
+    const std::string overflowing("\x04\xFF\xFF\xFF\xFF\xFF\xFF\xFF\xFF\xFF\x02", 11);
+    std::uint64_t value = 0;
+    EXPECT_THROW(deserialize(overflowing, value), muesli::exceptions::ParseException);
+
+    // UnsignedInteger marker, the tenth byte of the varint has a continuation bit
+    const std::string overlong("\x04\x80\x80\x80\x80\x80\x80\x80\x80\x80\x80\x00", 12);
+    EXPECT_THROW(deserialize(overlong, value), muesli::exceptions::ParseException);
+
+    // the largest value still decodes
+    const std::string largest("\x04\xFF\xFF\xFF\xFF\xFF\xFF\xFF\xFF\xFF\x01", 11);
+    deserialize(largest, value);
+    EXPECT_EQ(std::numeric_limits<std::uint64_t>::max(), value);
+}
+
+TEST_F(BinaryArchiveTest, oversizedLengthOfSkippedFieldCausesParseException)
+{
+    // object with an unknown key "u" whose string value is truncated
+    const std::string serialized = std::string("\x0B\x08\x01u\x08\xFF\xFF\xFF\xFF\x0F") + "abc";
+    OptionalField deserialized;
+    EXPECT_THROW(deserialize(serialized, deserialized), muesli::exceptions::ParseException);
+}
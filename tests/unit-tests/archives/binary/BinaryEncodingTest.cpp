@@ -0,0 +1,126 @@
+/*
+ * #%L
+ * %%
+ * Copyright (C) 2011 - 2016 BMW Car IT GmbH
+ * %%
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ * 
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ * 
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ * #L%
+ */
+
+#include <cstdint>
+#include <limits>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "muesli/archives/binary/detail/Encoding.h"
+#include "muesli/exceptions/ParseException.h"
+
+using namespace muesli::binary::detail;
+
+TEST(BinaryEncodingTest, zigzagMapsSmallMagnitudesToSmallValues)
+{
+    EXPECT_EQ(0u, zigzagEncode(0));
+    EXPECT_EQ(1u, zigzagEncode(-1));
+    EXPECT_EQ(2u, zigzagEncode(1));
+    EXPECT_EQ(3u, zigzagEncode(-2));
+    EXPECT_EQ(std::numeric_limits<std::uint64_t>::max(),
+              zigzagEncode(std::numeric_limits<std::int64_t>::min()));
+}
+
+TEST(BinaryEncodingTest, zigzagRoundtrip)
+{
+    const std::vector<std::int64_t> values = {0,
+                                              1,
+                                              -1,
+                                              63,
+                                              -64,
+                                              1234567,
+                                              std::numeric_limits<std::int64_t>::max(),
+                                              std::numeric_limits<std::int64_t>::min()};
+    for (std::int64_t value : values) {
+        EXPECT_EQ(value, zigzagDecode(zigzagEncode(value)));
+    }
+}
+
+TEST(BinaryEncodingTest, varintLength)
+{
+    unsigned char buffer[maxVarintLength];
+    EXPECT_EQ(1u, encodeVarint(0, buffer));
+    EXPECT_EQ(1u, encodeVarint(127, buffer));
+    EXPECT_EQ(2u, encodeVarint(128, buffer));
+    EXPECT_EQ(2u, encodeVarint(16383, buffer));
+    EXPECT_EQ(3u, encodeVarint(16384, buffer));
+    EXPECT_EQ(maxVarintLength, encodeVarint(std::numeric_limits<std::uint64_t>::max(), buffer));
+}
+
+TEST(BinaryEncodingTest, varintRoundtrip)
+{
+    const std::vector<std::uint64_t> values = {
+            0, 1, 127, 128, 300, 16384, 1ULL << 35, std::numeric_limits<std::uint64_t>::max()};
+    for (std::uint64_t value : values) {
+        unsigned char buffer[maxVarintLength];
+        const std::size_t length = encodeVarint(value, buffer);
+        const unsigned char* it = buffer;
+        EXPECT_EQ(value, decodeVarint(it, buffer + length));
+        EXPECT_EQ(buffer + length, it);
+    }
+}
+
+TEST(BinaryEncodingTest, truncatedVarintThrows)
+{
+    unsigned char buffer[maxVarintLength];
+    const std::size_t length = encodeVarint(300, buffer);
+    const unsigned char* it = buffer;
+    EXPECT_THROW(decodeVarint(it, buffer + length - 1), muesli::exceptions::ParseException);
+}
+
+TEST(BinaryEncodingTest, overflowingVarintThrows)
+{
+    // the tenth byte holds bits above 2^63
+    const unsigned char buffer[] = {
+            0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0x02};
+    const unsigned char* it = buffer;
+    EXPECT_THROW(decodeVarint(it, buffer + sizeof(buffer)), muesli::exceptions::ParseException);
+}
+
+TEST(BinaryEncodingTest, overlongVarintThrows)
+{
+    // the tenth byte has a continuation bit
+    const unsigned char buffer[] = {
+            0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x00};
+    const unsigned char* it = buffer;
+    EXPECT_THROW(decodeVarint(it, buffer + sizeof(buffer)), muesli::exceptions::ParseException);
+}
+
+TEST(BinaryEncodingTest, batchDecodeMixesSingleAndMultiByteValues)
+{
+    std::vector<std::uint64_t> values;
+    for (std::uint64_t i = 0; i < 40; ++i) {
+        values.push_back(i % 13 == 0 ? i * 1000 : i);
+    }
+    std::vector<unsigned char> buffer(values.size() * maxVarintLength);
+    std::size_t length = 0;
+    for (std::uint64_t value : values) {
+        length += encodeVarint(value, buffer.data() + length);
+    }
+
+    std::vector<std::uint64_t> decoded(values.size());
+    const unsigned char* end = decodeVarints(buffer.data(),
+                                             buffer.data() + length,
+                                             decoded.data(),
+                                             decoded.size(),
+                                             [](std::uint64_t raw) { return raw; });
+    EXPECT_EQ(buffer.data() + length, end);
+    EXPECT_EQ(values, decoded);
+}
@@ -0,0 +1,217 @@
+/*
+ * #%L
+ * %%
+ * Copyright (C) 2011 - 2016 BMW Car IT GmbH
+ * %%
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ * 
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ * 
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ * #L%
+ */
+
+#include <cstdint>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "muesli/Columnar.h"
+#include "muesli/LoadError.h"
+#include "muesli/NameValuePair.h"
+#include "muesli/streams/StringIStream.h"
+#include "muesli/streams/StringOStream.h"
+
+#include "muesli/archives/json/JsonInputArchive.h"
+#include "muesli/archives/json/JsonOutputArchive.h"
+
+#include "muesli/exceptions/ValueNotFoundException.h"
+
+#include "testtypes/TEnum.h"
+#include "testtypes/TStruct.h"
+#include "testtypes/TStructExtended.h"
+
+using namespace ::testing;
+
+using muesli::tests::testtypes::TStruct;
+using muesli::tests::testtypes::TStructExtended;
+
+namespace
+{
+struct OptionalFieldStruct
+{
+    std::int32_t _value;
+    bool _withExtra;
+};
+
+template <typename Archive>
+void serialize(Archive& archive, OptionalFieldStruct& optionalFieldStruct)
+{
+    archive(muesli::make_nvp("value", optionalFieldStruct._value));
+    if (optionalFieldStruct._withExtra) {
+        archive(muesli::make_nvp("extra", optionalFieldStruct._value));
+    }
+}
+} // namespace
+
+class ColumnarTest : public testing::Test
+{
+public:
+    ColumnarTest()
+            : _tStructs({TStruct(0.123456789, 64, "test string data"),
+                         TStruct(0.987654321, -64, "second test string")}),
+              _serializedTStructs(R"({"_size":2,)"
+                                  R"("tDouble":[0.123456789,0.987654321],)"
+                                  R"("tInt64":[64,-64],)"
+                                  R"("tString":["test string data","second test string"]})"),
+              _tStructExtendeds({TStructExtended(0.123456789,
+                                                 64,
+                                                 "test string data",
+                                                 muesli::tests::testtypes::TEnum::TLITERALA,
+                                                 32),
+                                 TStructExtended(1.5,
+                                                 -1,
+                                                 "",
+                                                 muesli::tests::testtypes::TEnum::TLITERALB,
+                                                 -32)}),
+              _serializedTStructExtendeds(R"({"_size":2,)"
+                                          R"("tDouble":[0.123456789,1.5],)"
+                                          R"("tInt64":[64,-1],)"
+                                          R"("tString":["test string data",""],)"
+                                          R"("tEnum":["TLITERALA","TLITERALB"],)"
+                                          R"("tInt32":[32,-32]})")
+    {
+    }
+
+protected:
+    std::vector<TStruct> _tStructs;
+    std::string _serializedTStructs;
+    std::vector<TStructExtended> _tStructExtendeds;
+    std::string _serializedTStructExtendeds;
+};
+
+TEST_F(ColumnarTest, writeVectorOfStructs)
+{
+    muesli::StringOStream stream;
+    muesli::JsonOutputArchive<muesli::StringOStream> jsonOutputArchive(stream);
+
+    jsonOutputArchive(muesli::make_columnar(_tStructs));
+
+    ASSERT_EQ(_serializedTStructs, stream.getString());
+}
+
+TEST_F(ColumnarTest, readVectorOfStructs)
+{
+    muesli::StringIStream stream(_serializedTStructs);
+    muesli::JsonInputArchive<muesli::StringIStream> jsonInputArchive(stream);
+
+    std::vector<TStruct> readStructs;
+    jsonInputArchive(muesli::make_columnar(readStructs));
+
+    ASSERT_EQ(_tStructs, readStructs);
+}
+
+TEST_F(ColumnarTest, writeVectorOfDerivedStructsWithEnums)
+{
+    muesli::StringOStream stream;
+    muesli::JsonOutputArchive<muesli::StringOStream> jsonOutputArchive(stream);
+
+    jsonOutputArchive(muesli::make_columnar(_tStructExtendeds));
+
+    ASSERT_EQ(_serializedTStructExtendeds, stream.getString());
+}
+
+TEST_F(ColumnarTest, readVectorOfDerivedStructsWithEnums)
+{
+    muesli::StringIStream stream(_serializedTStructExtendeds);
+    muesli::JsonInputArchive<muesli::StringIStream> jsonInputArchive(stream);
+
+    std::vector<TStructExtended> readStructs;
+    jsonInputArchive(muesli::make_columnar(readStructs));
+
+    ASSERT_EQ(_tStructExtendeds, readStructs);
+}
+
+TEST_F(ColumnarTest, writeEmptyVector)
+{
+    muesli::StringOStream stream;
+    muesli::JsonOutputArchive<muesli::StringOStream> jsonOutputArchive(stream);
+
+    const std::vector<TStruct> emptyStructs;
+    jsonOutputArchive(muesli::make_columnar(emptyStructs));
+
+    ASSERT_EQ(R"({"_size":0})", stream.getString());
+}
+
+TEST_F(ColumnarTest, writeRowsWithDifferingFieldsThrows)
+{
+    muesli::StringOStream stream;
+    muesli::JsonOutputArchive<muesli::StringOStream> jsonOutputArchive(stream);
+
+    std::vector<OptionalFieldStruct> rows = {{1, false}, {2, true}};
+
+    EXPECT_THROW(jsonOutputArchive(muesli::make_columnar(rows)), std::invalid_argument);
+}
+
+TEST_F(ColumnarTest, readShortColumnThrows)
+{
+    muesli::StringIStream stream(
+            R"({"_size":2,"tDouble":[1.0,2.0],"tInt64":[1],"tString":["a","b"]})");
+    muesli::JsonInputArchive<muesli::StringIStream> jsonInputArchive(stream);
+
+    std::vector<TStruct> readStructs;
+
+    EXPECT_THROW(jsonInputArchive(muesli::make_columnar(readStructs)),
+                 muesli::exceptions::ValueNotFoundException);
+}
+
+TEST_F(ColumnarTest, readSizeExceedingColumnsThrows)
+{
+    muesli::StringIStream stream(
+            R"({"_size":1000000000000,"tDouble":[1.0],"tInt64":[1],"tString":["a"]})");
+    muesli::JsonInputArchive<muesli::StringIStream> jsonInputArchive(stream);
+
+    std::vector<TStruct> readStructs;
+
+    EXPECT_THROW(jsonInputArchive(muesli::make_columnar(readStructs)),
+                 muesli::exceptions::ValueNotFoundException);
+    EXPECT_EQ(0, readStructs.capacity());
+}
+
+TEST_F(ColumnarTest, readSizeMismatchIsRecordedAsLoadError)
+{
+    muesli::LoadError error;
+    muesli::StringIStream stream(
+            R"({"_size":2,"tDouble":[1.0,2.0],"tInt64":[1],"tString":["a","b"]})");
+    muesli::JsonInputArchive<muesli::StringIStream> jsonInputArchive(stream, error);
+
+    std::vector<TStruct> readStructs(1);
+    jsonInputArchive(muesli::make_columnar(readStructs));
+
+    EXPECT_EQ(muesli::LoadError::Code::ValueNotFound, error.getCode());
+    EXPECT_EQ(1, readStructs.size());
+}
+
+TEST_F(ColumnarTest, rowIsResetWhenReadingARowThrows)
+{
+    muesli::StringIStream stream(R"({"rows":{"_size":2,"tDouble":[1.0,2.0],"tInt64":[1,"2"],)"
+                                 R"("tString":["a","b"]},)"
+                                 R"("single":{"tDouble":3.0,"tInt64":3,"tString":"c"}})");
+    muesli::JsonInputArchive<muesli::StringIStream> jsonInputArchive(stream);
+
+    std::vector<TStruct> readStructs;
+    auto columnar = muesli::make_columnar(readStructs);
+    EXPECT_THROW(jsonInputArchive.loadAt("/rows", columnar), std::invalid_argument);
+
+    TStruct single;
+    jsonInputArchive.loadAt("/single", single);
+    EXPECT_EQ(TStruct(3.0, 3, "c"), single);
+}
@@ -0,0 +1,130 @@
+/*
+ * #%L
+ * %%
+ * Copyright (C) 2011 - 2016 BMW Car IT GmbH
+ * %%
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ * 
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ * 
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ * #L%
+ */
+
+#include <cstdint>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "muesli/NameValuePair.h"
+#include "muesli/archives/json/ExternTemplates.h"
+
+namespace
+{
+struct Primitives
+{
+    bool _flag;
+    std::int8_t _int8;
+    std::uint64_t _uint64;
+    double _real;
+    std::string _text;
+    std::vector<std::int32_t> _numbers;
+    std::vector<std::string> _texts;
+
+    template <typename Archive>
+    void serialize(Archive& archive)
+    {
+        archive(muesli::make_nvp("flag", _flag),
+                muesli::make_nvp("int8", _int8),
+                muesli::make_nvp("uint64", _uint64),
+                muesli::make_nvp("real", _real),
+                muesli::make_nvp("text", _text),
+                muesli::make_nvp("numbers", _numbers),
+                muesli::make_nvp("texts", _texts));
+    }
+};
+} // namespace
+
+class ExternTemplatesTest : public ::testing::Test
+{
+public:
+    ExternTemplatesTest()
+            : _primitives{true, -8, 18446744073709551615u, 0.5, "text", {1, -2, 3}, {"a", "b"}},
+              _serializedPrimitives(R"({"flag":true,"int8":-8,"uint64":18446744073709551615,)"
+                                    R"("real":0.5,"text":"text","numbers":[1,-2,3],)"
+                                    R"("texts":["a","b"]})")
+    {
+    }
+
+protected:
+    void expectEqualToPrimitives(const Primitives& primitives) const
+    {
+        EXPECT_EQ(_primitives._flag, primitives._flag);
+        EXPECT_EQ(_primitives._int8, primitives._int8);
+        EXPECT_EQ(_primitives._uint64, primitives._uint64);
+        EXPECT_DOUBLE_EQ(_primitives._real, primitives._real);
+        EXPECT_EQ(_primitives._text, primitives._text);
+        EXPECT_EQ(_primitives._numbers, primitives._numbers);
+        EXPECT_EQ(_primitives._texts, primitives._texts);
+    }
+
+    const Primitives _primitives;
+    const std::string _serializedPrimitives;
+};
+
+TEST_F(ExternTemplatesTest, stringStreams)
+{
+    muesli::StringOStream outputStream;
+    muesli::JsonOutputArchive<muesli::StringOStream> jsonOutputArchive(outputStream);
+    jsonOutputArchive(_primitives);
+    EXPECT_EQ(_serializedPrimitives, outputStream.getString());
+
+    Primitives primitives{};
+    muesli::StringIStream inputStream(outputStream.getString());
+    muesli::JsonInputArchive<muesli::StringIStream> jsonInputArchive(inputStream);
+    jsonInputArchive(primitives);
+    expectEqualToPrimitives(primitives);
+}
+
+TEST_F(ExternTemplatesTest, stdStreams)
+{
+    std::stringstream stringStream;
+    muesli::StdOStreamWrapper<std::ostream> outputStream(stringStream);
+    muesli::JsonOutputArchive<muesli::StdOStreamWrapper<std::ostream>> jsonOutputArchive(
+            outputStream);
+    jsonOutputArchive(_primitives);
+    EXPECT_EQ(_serializedPrimitives, stringStream.str());
+
+    Primitives primitives{};
+    muesli::StdIStreamWrapper<std::istream> inputStream(stringStream);
+    muesli::JsonInputArchive<muesli::StdIStreamWrapper<std::istream>> jsonInputArchive(
+            inputStream);
+    jsonInputArchive(primitives);
+    expectEqualToPrimitives(primitives);
+}
+
+TEST_F(ExternTemplatesTest, anyStreams)
+{
+    muesli::StringOStream stringOStream;
+    {
+        muesli::AnyOStreamWrapper<muesli::StringOStream> outputStream(stringOStream);
+        muesli::JsonOutputArchive<muesli::AnyOStream> jsonOutputArchive(outputStream);
+        jsonOutputArchive(_primitives);
+    }
+    EXPECT_EQ(_serializedPrimitives, stringOStream.getString());
+
+    Primitives primitives{};
+    muesli::StringIStream stringIStream(stringOStream.getString());
+    muesli::AnyIStreamWrapper<muesli::StringIStream> inputStream(stringIStream);
+    muesli::JsonInputArchive<muesli::AnyIStream> jsonInputArchive(inputStream);
+    jsonInputArchive(primitives);
+    expectEqualToPrimitives(primitives);
+}
@@ -624,3 +624,20 @@ TEST_F(JsonArchiveTest, serializeDeserializeBoostMultiIndexContainer)
     jsonInputArchive(multiIndexContainerDeserialized);
     EXPECT_EQ(multiIndexContainer, multiIndexContainerDeserialized);
 }
+
+TEST_F(JsonArchiveTest, deserializeFromParsedValue)
+{
+    rapidjson::Document envelope;
+    envelope.Parse(R"({"kind":"TStruct","payload":)" + _expectedSerializedStruct + R"(})");
+    ASSERT_FALSE(envelope.HasParseError());
+
+    JsonInputArchiveImpl headerArchive(envelope);
+    std::string kind;
+    headerArchive(muesli::make_nvp("kind", kind));
+    EXPECT_EQ("TStruct", kind);
+
+    JsonInputArchiveImpl payloadArchive(envelope["payload"]);
+    muesli::tests::testtypes::TStruct tStructDeserialized;
+    payloadArchive(tStructDeserialized);
+    EXPECT_EQ(_tStruct, tStructDeserialized);
+}
@@ -0,0 +1,193 @@
+/*
+ * #%L
+ * %%
+ * Copyright (C) 2011 - 2016 BMW Car IT GmbH
+ * %%
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ * 
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ * 
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ * #L%
+ */
+
+#include <cstdint>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "muesli/NameValuePair.h"
+#include "muesli/archives/json/JsonInputArchive.h"
+#include "muesli/archives/json/JsonPointer.h"
+#include "muesli/exceptions/ParseException.h"
+#include "muesli/exceptions/ValueNotFoundException.h"
+#include "muesli/streams/StringIStream.h"
+
+namespace
+{
+struct Header
+{
+    std::string _routingKey;
+    std::int32_t _priority;
+
+    template <typename Archive>
+    void serialize(Archive& archive)
+    {
+        archive(muesli::make_nvp("routingKey", _routingKey),
+                muesli::make_nvp("priority", _priority));
+    }
+};
+} // namespace
+
+class JsonPointerTest : public ::testing::Test
+{
+public:
+    JsonPointerTest()
+            : _json(R"({"body":{"data":[1,"}",{"x":"]"}],"s":"a\"b"},)"
+                    R"( "a/b" : {"m~n":true,"ä":5,"esc\"aped":6},)"
+                    R"("header":{"routingKey":"r.k","priority":3},"list":[10,20,30]})")
+    {
+    }
+
+protected:
+    template <typename T>
+    void loadAt(const std::string& pointer, T& value)
+    {
+        muesli::StringIStream stream(_json);
+        muesli::JsonInputArchive<muesli::StringIStream> jsonInputArchive(stream);
+        jsonInputArchive.loadAt(pointer, value);
+    }
+
+    std::string _json;
+};
+
+TEST_F(JsonPointerTest, parseJsonPointer)
+{
+    using muesli::json::detail::parseJsonPointer;
+    EXPECT_EQ(std::vector<std::string>(), parseJsonPointer(""));
+    EXPECT_EQ(std::vector<std::string>({""}), parseJsonPointer("/"));
+    EXPECT_EQ(std::vector<std::string>({"a", "b", ""}), parseJsonPointer("/a/b/"));
+    EXPECT_EQ(std::vector<std::string>({"a/b", "m~n"}), parseJsonPointer("/a~1b/m~0n"));
+    EXPECT_THROW(parseJsonPointer("a"), std::invalid_argument);
+    EXPECT_THROW(parseJsonPointer("/a~2"), std::invalid_argument);
+    EXPECT_THROW(parseJsonPointer("/a~"), std::invalid_argument);
+}
+
+TEST_F(JsonPointerTest, archiveLoadAt)
+{
+    Header header;
+    loadAt("/header", header);
+    EXPECT_EQ("r.k", header._routingKey);
+    EXPECT_EQ(3, header._priority);
+
+    std::string routingKey;
+    loadAt("/header/routingKey", routingKey);
+    EXPECT_EQ("r.k", routingKey);
+
+    std::int32_t element = 0;
+    loadAt("/list/2", element);
+    EXPECT_EQ(30, element);
+
+    bool flag = false;
+    loadAt("/a~1b/m~0n", flag);
+    EXPECT_TRUE(flag);
+}
+
+TEST_F(JsonPointerTest, archiveLoadAtKeepsPosition)
+{
+    muesli::StringIStream stream(R"({"routingKey":"k","priority":1,"next":{"priority":2}})");
+    muesli::JsonInputArchive<muesli::StringIStream> jsonInputArchive(stream);
+    std::int32_t next = 0;
+    jsonInputArchive.loadAt("/next/priority", next);
+    EXPECT_EQ(2, next);
+    Header header;
+    jsonInputArchive(header);
+    EXPECT_EQ("k", header._routingKey);
+    EXPECT_EQ(1, header._priority);
+}
+
+TEST_F(JsonPointerTest, archiveLoadAtMissingValueThrows)
+{
+    std::int32_t value = 0;
+    EXPECT_THROW(loadAt("/header/missing", value), muesli::exceptions::ValueNotFoundException);
+    EXPECT_THROW(loadAt("/list/3", value), muesli::exceptions::ValueNotFoundException);
+    EXPECT_THROW(loadAt("/list/01", value), muesli::exceptions::ValueNotFoundException);
+    EXPECT_THROW(loadAt("/list/-", value), muesli::exceptions::ValueNotFoundException);
+}
+
+TEST_F(JsonPointerTest, loadJsonAtSkipsPrecedingValues)
+{
+    Header header;
+    muesli::loadJsonAt(_json, "/header", header);
+    EXPECT_EQ("r.k", header._routingKey);
+    EXPECT_EQ(3, header._priority);
+
+    std::string text;
+    muesli::loadJsonAt(_json, "/body/s", text);
+    EXPECT_EQ("a\"b", text);
+
+    std::int32_t value = 0;
+    muesli::loadJsonAt(_json, "/list/1", value);
+    EXPECT_EQ(20, value);
+    muesli::loadJsonAt(_json, "/a~1b/\xc3\xa4", value);
+    EXPECT_EQ(5, value);
+    muesli::loadJsonAt(_json, "/a~1b/esc\"aped", value);
+    EXPECT_EQ(6, value);
+    muesli::loadJsonAt(_json, "/body/data/0", value);
+    EXPECT_EQ(1, value);
+
+    std::string bracket;
+    muesli::loadJsonAt(_json, "/body/data/2/x", bracket);
+    EXPECT_EQ("]", bracket);
+}
+
+TEST_F(JsonPointerTest, loadJsonAtMissingValueThrows)
+{
+    std::int32_t value = 0;
+    EXPECT_THROW(muesli::loadJsonAt(_json, "/header/missing", value),
+                 muesli::exceptions::ValueNotFoundException);
+    EXPECT_THROW(muesli::loadJsonAt(_json, "/list/3", value),
+                 muesli::exceptions::ValueNotFoundException);
+    EXPECT_THROW(muesli::loadJsonAt(_json, "/header/priority/x", value),
+                 muesli::exceptions::ValueNotFoundException);
+    EXPECT_THROW(muesli::loadJsonAt(R"({"a":[1,2)", "/a/5", value),
+                 muesli::exceptions::ParseException);
+}
+
+TEST_F(JsonPointerTest, archiveLoadAtRestoresPositionAfterFailure)
+{
+    muesli::StringIStream stream(R"({"routingKey":"k","priority":1,"next":{"priority":"2"}})");
+    muesli::JsonInputArchive<muesli::StringIStream> jsonInputArchive(stream);
+    std::int32_t next = 0;
+    EXPECT_ANY_THROW(jsonInputArchive.loadAt("/next/priority", next));
+    Header header;
+    jsonInputArchive(header);
+    EXPECT_EQ("k", header._routingKey);
+    EXPECT_EQ(1, header._priority);
+}
+
+TEST_F(JsonPointerTest, loadJsonAtDecodesSurrogatePairs)
+{
+    std::int32_t value = 0;
+    muesli::loadJsonAt(R"({"\ud83d\ude00":1})", "/\xf0\x9f\x98\x80", value);
+    EXPECT_EQ(1, value);
+}
+
+TEST_F(JsonPointerTest, loadJsonAtInvalidSurrogatesThrow)
+{
+    std::int32_t value = 0;
+    EXPECT_THROW(muesli::loadJsonAt(R"({"\ud83dx":1})", "/x", value),
+                 muesli::exceptions::ParseException);
+    EXPECT_THROW(muesli::loadJsonAt(R"({"\ud83dA":1})", "/A", value),
+                 muesli::exceptions::ParseException);
+    EXPECT_THROW(muesli::loadJsonAt(R"({"\ude00":1})", "/x", value),
+                 muesli::exceptions::ParseException);
+}
@@ -0,0 +1,182 @@
+/*
+ * #%L
+ * %%
+ * Copyright (C) 2011 - 2016 BMW Car IT GmbH
+ * %%
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ * 
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ * 
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ * #L%
+ */
+
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <boost/optional.hpp>
+
+#include <gtest/gtest.h>
+
+#include "muesli/NameValuePair.h"
+#include "muesli/archives/json/JsonInputArchive.h"
+#include "muesli/streams/StringIStream.h"
+
+#include "testtypes/NestedStructs.h"
+#include "testtypes/TStruct.h"
+#include "testtypes/TStructExtended.h"
+
+using muesli::tests::testtypes::NestedStructPolymorphic;
+using muesli::tests::testtypes::TStruct;
+using muesli::tests::testtypes::TStructExtended;
+
+namespace
+{
+struct Sample
+{
+    std::string _name;
+    std::vector<double> _values;
+
+    template <typename Archive>
+    void serialize(Archive& archive)
+    {
+        archive(muesli::make_nvp("name", _name), muesli::make_nvp("values", _values));
+    }
+};
+
+struct Holder
+{
+    std::unique_ptr<Sample> _sample;
+
+    template <typename Archive>
+    void serialize(Archive& archive)
+    {
+        archive(muesli::make_nvp("sample", _sample));
+    }
+};
+
+struct State
+{
+    std::vector<Sample> _samples;
+    std::map<std::string, Sample> _byName;
+    boost::optional<Sample> _latest;
+
+    template <typename Archive>
+    void serialize(Archive& archive)
+    {
+        archive(muesli::make_nvp("samples", _samples),
+                muesli::make_nvp("byName", _byName),
+                muesli::make_nvp("latest", _latest));
+    }
+};
+} // namespace
+
+class JsonReloadTest : public ::testing::Test
+{
+protected:
+    template <typename T>
+    static void reload(const std::string& json, T& state)
+    {
+        muesli::StringIStream stream(json);
+        muesli::JsonInputArchive<muesli::StringIStream> jsonInputArchive(stream);
+        jsonInputArchive.reload(state);
+        EXPECT_FALSE(jsonInputArchive.isReloading());
+    }
+
+    static std::string sample(const std::string& name, const std::string& values)
+    {
+        return R"({"name":")" + name + R"(","values":)" + values + "}";
+    }
+};
+
+TEST_F(JsonReloadTest, elementsAreReusedInPlace)
+{
+    State state;
+    reload(R"({"samples":[)" + sample("a", "[1,2,3]") + "," + sample("b", "[4]") +
+                   R"(],"byName":{"x":)" + sample("x", "[5,6]") + R"(},"latest":)" +
+                   sample("l", "[7,8]") + "}",
+           state);
+    ASSERT_EQ(2, state._samples.size());
+    const Sample* firstSample = &state._samples[0];
+    const double* firstValues = state._samples[0]._values.data();
+    const Sample* mapped = &state._byName.at("x");
+    const double* mappedValues = mapped->_values.data();
+    const double* latestValues = state._latest->_values.data();
+
+    reload(R"({"samples":[)" + sample("c", "[9,10]") + R"(],"byName":{"x":)" + sample("y", "[11]") +
+                   R"(},"latest":)" + sample("m", "[12]") + "}",
+           state);
+    ASSERT_EQ(1, state._samples.size());
+    EXPECT_EQ(firstSample, &state._samples[0]);
+    EXPECT_EQ(firstValues, state._samples[0]._values.data());
+    EXPECT_EQ("c", state._samples[0]._name);
+    EXPECT_EQ((std::vector<double>{9, 10}), state._samples[0]._values);
+    EXPECT_EQ(mapped, &state._byName.at("x"));
+    EXPECT_EQ(mappedValues, state._byName.at("x")._values.data());
+    EXPECT_EQ("y", state._byName.at("x")._name);
+    EXPECT_EQ(latestValues, state._latest->_values.data());
+    EXPECT_EQ("m", state._latest->_name);
+}
+
+TEST_F(JsonReloadTest, containersGrowAndShrink)
+{
+    State state;
+    reload(R"({"samples":[)" + sample("a", "[1]") + R"(],"byName":{"x":)" + sample("x", "[]") +
+                   R"(,"y":)" + sample("y", "[]") + R"(},"latest":)" + sample("l", "[]") + "}",
+           state);
+    reload(R"({"samples":[)" + sample("a", "[1]") + "," + sample("b", "[2]") +
+                   R"(],"byName":{"y":)" + sample("y2", "[]") + R"(,"z":)" + sample("z", "[3]") +
+                   R"(},"latest":null})",
+           state);
+    ASSERT_EQ(2, state._samples.size());
+    EXPECT_EQ("b", state._samples[1]._name);
+    ASSERT_EQ(2, state._byName.size());
+    EXPECT_EQ(0, state._byName.count("x"));
+    EXPECT_EQ("y2", state._byName.at("y")._name);
+    EXPECT_EQ((std::vector<double>{3}), state._byName.at("z")._values);
+    EXPECT_FALSE(state._latest);
+}
+
+TEST_F(JsonReloadTest, pointeeIsReusedIfTheTypeMatches)
+{
+    const std::string extended =
+            R"({"_tStruct":{"_typeName":"muesli.tests.testtypes.TStructExtended",)"
+            R"("tDouble":0.5,"tInt64":1,"tString":"a","tEnum":"TLITERALA","tInt32":)";
+    NestedStructPolymorphic nested;
+    reload(extended + "2}}", nested);
+    const TStruct* pointee = nested._tStruct.get();
+    ASSERT_NE(nullptr, dynamic_cast<const TStructExtended*>(pointee));
+    EXPECT_EQ(1, nested._tStruct.use_count());
+
+    reload(extended + "3}}", nested);
+    EXPECT_EQ(pointee, nested._tStruct.get());
+    EXPECT_EQ(3, static_cast<const TStructExtended*>(pointee)->getTInt32());
+
+    reload(R"({"_tStruct":{"_typeName":"muesli.tests.testtypes.TStruct",)"
+           R"("tDouble":0.5,"tInt64":4,"tString":"b"}})",
+           nested);
+    EXPECT_EQ(nullptr, dynamic_cast<const TStructExtended*>(nested._tStruct.get()));
+    EXPECT_EQ(4, nested._tStruct->getTInt64());
+}
+
+TEST_F(JsonReloadTest, pointeeOfNonPolymorphicTypeIsReused)
+{
+    Holder holder;
+    reload(R"({"sample":)" + sample("a", "[1]") + "}", holder);
+    const Sample* pointee = holder._sample.get();
+    ASSERT_NE(nullptr, pointee);
+    reload(R"({"sample":)" + sample("b", "[2]") + "}", holder);
+    EXPECT_EQ(pointee, holder._sample.get());
+    EXPECT_EQ("b", holder._sample->_name);
+    reload(R"({"sample":null})", holder);
+    EXPECT_EQ(nullptr, holder._sample);
+}
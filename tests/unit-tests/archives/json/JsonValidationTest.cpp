@@ -0,0 +1,150 @@
+/*
+ * #%L
+ * %%
+ * Copyright (C) 2011 - 2016 BMW Car IT GmbH
+ * %%
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ * 
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ * 
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ * #L%
+ */
+
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include <boost/lexical_cast.hpp>
+
+#include <gtest/gtest.h>
+
+#include "muesli/NameValuePair.h"
+#include "muesli/archives/json/JsonInputArchive.h"
+#include "muesli/archives/json/JsonOutputArchive.h"
+#include "muesli/archives/json/Lazy.h"
+#include "muesli/exceptions/UnknownTypeException.h"
+#include "muesli/exceptions/ValueNotFoundException.h"
+#include "muesli/streams/StringIStream.h"
+
+#include "testtypes/NestedStructs.h"
+#include "testtypes/TEnum.h"
+#include "testtypes/TStruct.h"
+#include "testtypes/TStructExtended.h"
+
+using muesli::tests::testtypes::NestedStructPolymorphic;
+using muesli::tests::testtypes::TEnum;
+using muesli::tests::testtypes::TStruct;
+
+namespace
+{
+struct Message
+{
+    std::vector<TStruct> _structs;
+    std::map<std::int32_t, std::string> _names;
+    TEnum::Enum _enum;
+    muesli::Lazy<std::vector<std::string>> _lazy;
+
+    template <typename Archive>
+    void serialize(Archive& archive)
+    {
+        archive(muesli::make_nvp("structs", _structs),
+                muesli::make_nvp("names", _names),
+                muesli::make_nvp("enum", _enum),
+                muesli::make_nvp("lazy", _lazy));
+    }
+};
+} // namespace
+
+class JsonValidationTest : public ::testing::Test
+{
+protected:
+    template <typename T>
+    static void validate(const std::string& json)
+    {
+        muesli::StringIStream stream(json);
+        muesli::JsonInputArchive<muesli::StringIStream> jsonInputArchive(stream);
+        jsonInputArchive.validate<T>();
+        EXPECT_FALSE(jsonInputArchive.isValidating());
+    }
+
+    static std::string message(const std::string& structs,
+                               const std::string& names,
+                               const std::string& enumLiteral,
+                               const std::string& lazy)
+    {
+        return R"({"structs":)" + structs + R"(,"names":)" + names + R"(,"enum":)" +
+               enumLiteral + R"(,"lazy":)" + lazy + "}";
+    }
+
+    const std::string _structs =
+            R"([{"tDouble":0.5,"tInt64":1,"tString":"a"},{"tDouble":1,"tInt64":2,"tString":"b"}])";
+};
+
+TEST_F(JsonValidationTest, validMessage)
+{
+    EXPECT_NO_THROW(
+            validate<Message>(message(_structs, R"({"1":"x","2":"y"})", R"("TLITERALB")", "[]")));
+}
+
+TEST_F(JsonValidationTest, wrongFieldType)
+{
+    const std::string structs = R"([{"tDouble":0.5,"tInt64":1,"tString":2}])";
+    EXPECT_THROW(validate<Message>(message(structs, "{}", R"("TLITERALA")", "[]")),
+                 std::invalid_argument);
+}
+
+TEST_F(JsonValidationTest, missingField)
+{
+    const std::string structs = R"([{"tDouble":0.5,"tString":"a"}])";
+    EXPECT_THROW(validate<Message>(message(structs, "{}", R"("TLITERALA")", "[]")),
+                 muesli::exceptions::ValueNotFoundException);
+}
+
+TEST_F(JsonValidationTest, invalidMapKey)
+{
+    EXPECT_THROW(validate<Message>(message(_structs, R"({"one":"x"})", R"("TLITERALA")", "[]")),
+                 boost::bad_lexical_cast);
+}
+
+TEST_F(JsonValidationTest, unknownEnumLiteral)
+{
+    EXPECT_THROW(validate<Message>(message(_structs, "{}", R"("TLITERALC")", "[]")),
+                 std::invalid_argument);
+}
+
+TEST_F(JsonValidationTest, lazyFieldsAreValidated)
+{
+    EXPECT_THROW(validate<Message>(message(_structs, "{}", R"("TLITERALA")", "[1]")),
+                 std::invalid_argument);
+}
+
+TEST_F(JsonValidationTest, typeNames)
+{
+    EXPECT_NO_THROW(validate<NestedStructPolymorphic>(
+            R"({"_tStruct":{"_typeName":"muesli.tests.testtypes.TStructExtended",)"
+            R"("tDouble":0.5,"tInt64":1,"tString":"a","tEnum":"TLITERALA","tInt32":3}})"));
+    EXPECT_THROW(validate<NestedStructPolymorphic>(
+                         R"({"_tStruct":{"_typeName":"Unknown","tDouble":0.5}})"),
+                 muesli::exceptions::UnknownTypeException);
+}
+
+TEST_F(JsonValidationTest, validationModeEndsWhenValidationThrows)
+{
+    muesli::StringIStream stream(R"("text")");
+    muesli::JsonInputArchive<muesli::StringIStream> jsonInputArchive(stream);
+    EXPECT_THROW(jsonInputArchive.validate<std::int32_t>(), std::invalid_argument);
+    EXPECT_FALSE(jsonInputArchive.isValidating());
+    std::string value;
+    jsonInputArchive(value);
+    EXPECT_EQ("text", value);
+}
@@ -0,0 +1,177 @@
+/*
+ * #%L
+ * %%
+ * Copyright (C) 2011 - 2016 BMW Car IT GmbH
+ * %%
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ * 
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ * 
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ * #L%
+ */
+
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <boost/optional.hpp>
+
+#include <gtest/gtest.h>
+
+#include "muesli/NameValuePair.h"
+#include "muesli/archives/json/JsonInputArchive.h"
+#include "muesli/archives/json/JsonOutputArchive.h"
+#include "muesli/archives/json/JsonValueOutputArchive.h"
+#include "muesli/archives/json/Lazy.h"
+#include "muesli/archives/json/RawJson.h"
+#include "muesli/streams/StringIStream.h"
+#include "muesli/streams/StringOStream.h"
+
+#include "testtypes/NestedStructs.h"
+#include "testtypes/TEnum.h"
+#include "testtypes/TStruct.h"
+#include "testtypes/TStructExtended.h"
+
+using muesli::tests::testtypes::NestedStructPolymorphic;
+using muesli::tests::testtypes::TEnum;
+using muesli::tests::testtypes::TStructExtended;
+
+namespace
+{
+struct Containers
+{
+    std::vector<std::int32_t> _integers;
+    std::map<std::string, double> _map;
+    boost::optional<std::string> _absent;
+    muesli::RawJson _raw;
+
+    template <typename Archive>
+    void serialize(Archive& archive)
+    {
+        archive(muesli::make_nvp("integers", _integers),
+                muesli::make_nvp("map", _map),
+                muesli::make_nvp("absent", _absent),
+                muesli::make_nvp("raw", _raw));
+    }
+};
+
+struct Report
+{
+    std::string _title;
+    muesli::Lazy<std::map<std::string, std::vector<std::string>>> _sections;
+
+    template <typename Archive>
+    void serialize(Archive& archive)
+    {
+        archive(muesli::make_nvp("title", _title), muesli::make_nvp("sections", _sections));
+    }
+};
+} // namespace
+
+class JsonValueOutputArchiveTest : public ::testing::Test
+{
+public:
+    JsonValueOutputArchiveTest()
+            : _nestedStruct({std::make_shared<TStructExtended>(
+                      0.123456789, 64, "test string data", TEnum::TLITERALB, -32)}),
+              _containers{{1, -2, 3},
+                          {{"a", 0.5}, {"b", -1.5}},
+                          boost::none,
+                          muesli::RawJson(R"({"x":[null,true]})")}
+    {
+    }
+
+protected:
+    template <typename T>
+    static std::string serialize(const T& value)
+    {
+        muesli::StringOStream stream;
+        muesli::JsonOutputArchive<muesli::StringOStream> jsonOutputArchive(stream);
+        jsonOutputArchive(value);
+        return stream.getString();
+    }
+
+    template <typename T>
+    static void serialize(const T& value, rapidjson::Document& document)
+    {
+        muesli::JsonValueOutput output(document, document.GetAllocator());
+        muesli::JsonValueOutputArchive jsonValueOutputArchive(output);
+        jsonValueOutputArchive(value);
+    }
+
+    static std::string toString(const rapidjson::Value& value)
+    {
+        rapidjson::StringBuffer buffer;
+        rapidjson::Writer<rapidjson::StringBuffer> writer(buffer);
+        value.Accept(writer);
+        return std::string(buffer.GetString(), buffer.GetSize());
+    }
+
+    NestedStructPolymorphic _nestedStruct;
+    Containers _containers;
+};
+
+TEST_F(JsonValueOutputArchiveTest, matchesJsonOutputArchive)
+{
+    rapidjson::Document document;
+    serialize(_nestedStruct, document);
+    EXPECT_EQ(serialize(_nestedStruct), toString(document));
+
+    rapidjson::Document containers;
+    serialize(_containers, containers);
+    EXPECT_EQ(serialize(_containers), toString(containers));
+}
+
+TEST_F(JsonValueOutputArchiveTest, documentCanBeModifiedAndLoaded)
+{
+    rapidjson::Document document;
+    serialize(_nestedStruct, document);
+    ASSERT_TRUE(document.IsObject());
+    rapidjson::Value key("enriched", document.GetAllocator());
+    rapidjson::Value flag(true);
+    document.AddMember(key, flag, document.GetAllocator());
+    EXPECT_TRUE(document["enriched"].GetBool());
+
+    NestedStructPolymorphic deserialized;
+    muesli::JsonInputArchive<muesli::StringIStream> jsonInputArchive(document);
+    jsonInputArchive(deserialized);
+    EXPECT_EQ(_nestedStruct, deserialized);
+}
+
+TEST_F(JsonValueOutputArchiveTest, primitiveRoot)
+{
+    rapidjson::Document document;
+    serialize(std::string("text"), document);
+    ASSERT_TRUE(document.IsString());
+    EXPECT_EQ("text", std::string(document.GetString()));
+}
+
+TEST_F(JsonValueOutputArchiveTest, invalidRawJsonThrows)
+{
+    rapidjson::Document document;
+    Containers containers{{}, {}, boost::none, muesli::RawJson("{")};
+    EXPECT_THROW(serialize(containers, document), muesli::exceptions::ParseException);
+}
+
+TEST_F(JsonValueOutputArchiveTest, untouchedLazyIsCopied)
+{
+    const std::string json(R"({"title":"t","sections":{"a":["x","y"],"b":[]}})");
+    Report report;
+    muesli::StringIStream stream(json);
+    muesli::JsonInputArchive<muesli::StringIStream> jsonInputArchive(stream);
+    jsonInputArchive(report);
+    ASSERT_FALSE(report._sections.isLoaded());
+
+    rapidjson::Document document;
+    serialize(report, document);
+    EXPECT_EQ(json, toString(document));
+}
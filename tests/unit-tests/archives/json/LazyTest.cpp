@@ -0,0 +1,254 @@
+/*
+ * #%L
+ * %%
+ * Copyright (C) 2011 - 2016 BMW Car IT GmbH
+ * %%
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ * 
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ * 
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ * #L%
+ */
+
+#include <cstddef>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "muesli/FieldMask.h"
+#include "muesli/LoadError.h"
+#include "muesli/MemoryResource.h"
+#include "muesli/NameValuePair.h"
+#include "muesli/archives/json/JsonInputArchive.h"
+#include "muesli/archives/json/JsonOutputArchive.h"
+#include "muesli/archives/json/Lazy.h"
+#include "muesli/streams/StringIStream.h"
+#include "muesli/streams/StringOStream.h"
+
+namespace
+{
+struct Body
+{
+    std::string _text;
+    std::vector<int> _values;
+
+    template <typename Archive>
+    void serialize(Archive& archive)
+    {
+        archive(muesli::make_nvp("text", _text), muesli::make_nvp("values", _values));
+    }
+
+    bool operator==(const Body& other) const
+    {
+        return _text == other._text && _values == other._values;
+    }
+};
+
+// forwards to operator new/delete and counts the outstanding allocations
+class CountingMemoryResource : public muesli::MemoryResource
+{
+public:
+    CountingMemoryResource() : _allocations(0), _outstanding(0)
+    {
+    }
+
+    std::size_t _allocations;
+    std::size_t _outstanding;
+
+private:
+    void* doAllocate(std::size_t bytes, std::size_t alignment) override
+    {
+        ++_allocations;
+        ++_outstanding;
+        return muesli::getNewDeleteMemoryResource()->allocate(bytes, alignment);
+    }
+
+    void doDeallocate(void* ptr, std::size_t bytes, std::size_t alignment) override
+    {
+        --_outstanding;
+        muesli::getNewDeleteMemoryResource()->deallocate(ptr, bytes, alignment);
+    }
+};
+
+struct Message
+{
+    std::string _header;
+    muesli::Lazy<Body> _body;
+
+    template <typename Archive>
+    void serialize(Archive& archive)
+    {
+        archive(muesli::make_nvp("header", _header), muesli::make_nvp("body", _body));
+    }
+};
+} // namespace
+
+class LazyTest : public ::testing::Test
+{
+public:
+    LazyTest() : _serializedMessage(R"({"header":"h","body":{"text":"t","values":[1,2,3]}})")
+    {
+    }
+
+protected:
+    template <typename T>
+    static void deserialize(const std::string& serialized, T& value)
+    {
+        muesli::StringIStream stream(serialized);
+        muesli::JsonInputArchive<muesli::StringIStream> jsonInputArchive(stream);
+        jsonInputArchive(value);
+    }
+
+    template <typename T>
+    static std::string serialize(const T& value)
+    {
+        muesli::StringOStream stream;
+        muesli::JsonOutputArchive<muesli::StringOStream> jsonOutputArchive(stream);
+        jsonOutputArchive(value);
+        return stream.getString();
+    }
+
+    std::string _serializedMessage;
+};
+
+TEST_F(LazyTest, loadDefersDeserialization)
+{
+    Message message;
+    deserialize(_serializedMessage, message);
+    EXPECT_EQ("h", message._header);
+    EXPECT_FALSE(message._body.isLoaded());
+
+    const Message& constMessage = message;
+    EXPECT_EQ((Body{"t", {1, 2, 3}}), constMessage._body.get());
+    EXPECT_TRUE(message._body.isLoaded());
+}
+
+TEST_F(LazyTest, errorsAreReportedOnFirstAccess)
+{
+    Message message;
+    deserialize(R"({"header":"h","body":{"text":1,"values":[]}})", message);
+    EXPECT_THROW(message._body.get(), std::invalid_argument);
+}
+
+TEST_F(LazyTest, untouchedValueIsSavedVerbatim)
+{
+    Message message;
+    deserialize(R"({ "header" : "h", "body" : {"values":[1], "text":"t", "extra":true} })",
+                message);
+    const std::string expected(
+            R"({"header":"h","body":{"values":[1],"text":"t","extra":true}})");
+    EXPECT_EQ(expected, serialize(message));
+
+    const Message& constMessage = message;
+    EXPECT_EQ("t", constMessage._body.get()._text);
+    EXPECT_EQ(expected, serialize(message));
+}
+
+TEST_F(LazyTest, modifiedValueIsSerialized)
+{
+    Message message;
+    deserialize(_serializedMessage, message);
+    message._body.get()._values.push_back(4);
+    EXPECT_EQ(R"({"header":"h","body":{"text":"t","values":[1,2,3,4]}})", serialize(message));
+}
+
+TEST_F(LazyTest, constructedValueIsSerialized)
+{
+    Message message{"h", muesli::Lazy<Body>(Body{"t", {1, 2, 3}})};
+    EXPECT_TRUE(message._body.isLoaded());
+    EXPECT_EQ(_serializedMessage, serialize(message));
+}
+
+TEST_F(LazyTest, copyKeepsTheJson)
+{
+    Message copy;
+    {
+        Message message;
+        deserialize(_serializedMessage, message);
+        copy = message;
+    }
+    EXPECT_FALSE(copy._body.isLoaded());
+    EXPECT_EQ(_serializedMessage, serialize(copy));
+    EXPECT_EQ((Body{"t", {1, 2, 3}}), static_cast<const Message&>(copy)._body.get());
+}
+
+TEST_F(LazyTest, errorsAreRecordedIfTheArchiveRecordsErrors)
+{
+    Message message;
+    muesli::LoadError error;
+    muesli::StringIStream stream(R"({"header":"h","body":{"text":1,"values":[]}})");
+    muesli::JsonInputArchive<muesli::StringIStream> jsonInputArchive(stream, error);
+    jsonInputArchive(message);
+    EXPECT_FALSE(error);
+
+    EXPECT_NO_THROW(message._body.get());
+    EXPECT_EQ(muesli::LoadError::Code::InvalidValue, message._body.getError().getCode());
+}
+
+TEST_F(LazyTest, missingValueIsRecordedInsteadOfParsed)
+{
+    Message message;
+    muesli::LoadError error;
+    muesli::StringIStream stream(R"({"header":"h"})");
+    muesli::JsonInputArchive<muesli::StringIStream> jsonInputArchive(stream, error);
+    jsonInputArchive(message);
+    EXPECT_EQ(muesli::LoadError::Code::ValueNotFound, error.getCode());
+
+    EXPECT_EQ(muesli::LoadError::Code::ValueNotFound, message._body.getError().getCode());
+    EXPECT_EQ(Body(), message._body.get());
+}
+
+TEST_F(LazyTest, fieldMaskOfTheArchiveIsApplied)
+{
+    Message message;
+    muesli::StringIStream stream(_serializedMessage);
+    muesli::JsonInputArchive<muesli::StringIStream> jsonInputArchive(
+            stream, muesli::FieldMask{"header", "body.text"});
+    jsonInputArchive(message);
+    EXPECT_EQ((Body{"t", {}}), static_cast<const Message&>(message)._body.get());
+}
+
+TEST_F(LazyTest, reloadReusesTheDeserializedValue)
+{
+    Message message;
+    deserialize(_serializedMessage, message);
+    const int* values = message._body.get()._values.data();
+
+    muesli::StringIStream stream(R"({"header":"h","body":{"text":"u","values":[4,5,6]}})");
+    muesli::JsonInputArchive<muesli::StringIStream> jsonInputArchive(stream);
+    jsonInputArchive.reload(message);
+    const Message& constMessage = message;
+    EXPECT_EQ((Body{"u", {4, 5, 6}}), constMessage._body.get());
+    EXPECT_EQ(values, constMessage._body.get()._values.data());
+}
+
+TEST_F(LazyTest, memoryResourceOfTheArchiveIsUsedOnFirstAccess)
+{
+    // the resource is declared first: it has to outlive the first access of the Lazy
+    CountingMemoryResource resource;
+    {
+        muesli::Lazy<muesli::ResourceVector<int>> lazy;
+        {
+            muesli::StringIStream stream("[1,2,3]");
+            muesli::JsonInputArchive<muesli::StringIStream> jsonInputArchive(stream);
+            jsonInputArchive.setMemoryResource(&resource);
+            jsonInputArchive(lazy);
+        }
+        EXPECT_EQ(0, resource._allocations);
+
+        const auto& constLazy = lazy;
+        EXPECT_EQ((muesli::ResourceVector<int>{1, 2, 3}), constLazy.get());
+        EXPECT_LT(0, resource._allocations);
+        EXPECT_EQ(&resource, constLazy.get().get_allocator().getResource());
+    }
+    EXPECT_EQ(0, resource._outstanding);
+}
@@ -0,0 +1,171 @@
+/*
+ * #%L
+ * %%
+ * Copyright (C) 2011 - 2016 BMW Car IT GmbH
+ * %%
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ * 
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ * 
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ * #L%
+ */
+
+#include <cstdint>
+#include <map>
+#include <string>
+#include <tuple>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "muesli/LoadError.h"
+#include "muesli/NameValuePair.h"
+#include "muesli/archives/json/JsonInputArchive.h"
+#include "muesli/archives/json/JsonOutputArchive.h"
+#include "muesli/streams/StringIStream.h"
+
+#include "testtypes/NestedStructs.h"
+#include "testtypes/TEnum.h"
+#include "testtypes/TStruct.h"
+#include "testtypes/TStructExtended.h"
+
+using muesli::LoadError;
+using muesli::tests::testtypes::NestedStructPolymorphic;
+using muesli::tests::testtypes::TEnum;
+using muesli::tests::testtypes::TStruct;
+
+namespace
+{
+struct Message
+{
+    std::vector<TStruct> _structs;
+    std::map<std::int32_t, std::string> _names;
+    std::tuple<std::int32_t, std::string> _pair;
+
+    template <typename Archive>
+    void serialize(Archive& archive)
+    {
+        archive(muesli::make_nvp("structs", _structs),
+                muesli::make_nvp("names", _names),
+                muesli::make_nvp("pair", _pair));
+    }
+};
+} // namespace
+
+class LoadErrorTest : public ::testing::Test
+{
+protected:
+    template <typename T>
+    static LoadError load(const std::string& json, T& value)
+    {
+        LoadError error;
+        muesli::StringIStream stream(json);
+        muesli::JsonInputArchive<muesli::StringIStream> jsonInputArchive(stream, error);
+        EXPECT_TRUE(jsonInputArchive.recordsErrors());
+        jsonInputArchive(value);
+        return error;
+    }
+
+    static std::string message(const std::string& structs, const std::string& names)
+    {
+        return R"({"structs":)" + structs + R"(,"names":)" + names + R"(,"pair":[1,"a"]})";
+    }
+
+    const std::string _structs = R"([{"tDouble":0.5,"tInt64":1,"tString":"a"}])";
+};
+
+TEST_F(LoadErrorTest, validMessage)
+{
+    Message value;
+    const LoadError error = load(message(_structs, R"({"1":"x"})"), value);
+    EXPECT_FALSE(error);
+    EXPECT_EQ(LoadError::Code::None, error.getCode());
+    ASSERT_EQ(1, value._structs.size());
+    EXPECT_EQ("a", value._structs[0].getTString());
+    EXPECT_EQ("x", value._names[1]);
+    EXPECT_EQ("a", std::get<1>(value._pair));
+}
+
+TEST_F(LoadErrorTest, wrongFieldType)
+{
+    Message value;
+    const LoadError error =
+            load(message(R"([{"tDouble":0.5,"tInt64":"1","tString":"a"}])", "{}"), value);
+    EXPECT_EQ(LoadError::Code::InvalidValue, error.getCode());
+    EXPECT_EQ("Cannot read an Int64.", error.getMessage());
+}
+
+TEST_F(LoadErrorTest, missingField)
+{
+    Message value;
+    const LoadError error = load(message(R"([{"tDouble":0.5,"tString":"a"}])", "{}"), value);
+    EXPECT_EQ(LoadError::Code::ValueNotFound, error.getCode());
+}
+
+TEST_F(LoadErrorTest, invalidMapKey)
+{
+    Message value;
+    const LoadError error = load(message(_structs, R"({"one":"x"})"), value);
+    EXPECT_EQ(LoadError::Code::InvalidValue, error.getCode());
+    EXPECT_TRUE(value._names.empty());
+}
+
+TEST_F(LoadErrorTest, unknownEnumLiteral)
+{
+    std::vector<TEnum::Enum> values;
+    LoadError error = load(R"(["TLITERALA","TLITERALC"])", values);
+    EXPECT_EQ(LoadError::Code::InvalidValue, error.getCode());
+    EXPECT_EQ("Unknown enum literal \"TLITERALC\".", error.getMessage());
+
+    std::map<TEnum::Enum, std::int32_t> map;
+    error = load(R"({"TLITERALB":1,"TLITERALC":2})", map);
+    EXPECT_EQ(LoadError::Code::InvalidValue, error.getCode());
+}
+
+TEST_F(LoadErrorTest, wrongTupleSize)
+{
+    Message value;
+    const LoadError error = load(R"({"structs":[],"names":{},"pair":[1]})", value);
+    EXPECT_EQ(LoadError::Code::Parse, error.getCode());
+}
+
+TEST_F(LoadErrorTest, parseError)
+{
+    Message value;
+    const LoadError error = load(R"({"structs":[)", value);
+    EXPECT_EQ(LoadError::Code::Parse, error.getCode());
+    EXPECT_TRUE(value._structs.empty());
+}
+
+TEST_F(LoadErrorTest, unknownType)
+{
+    NestedStructPolymorphic value;
+    const LoadError error =
+            load(R"({"_tStruct":{"_typeName":"Unknown","tDouble":0.5}})", value);
+    EXPECT_EQ(LoadError::Code::UnknownType, error.getCode());
+}
+
+TEST_F(LoadErrorTest, firstErrorIsKept)
+{
+    Message value;
+    const LoadError error =
+            load(R"({"structs":[{"tDouble":"x","tInt64":"y","tString":1}],"names":[]})", value);
+    EXPECT_EQ(LoadError::Code::InvalidValue, error.getCode());
+    EXPECT_EQ("Cannot read a Double.", error.getMessage());
+}
+
+TEST_F(LoadErrorTest, errorIsThrownWithoutErrorObject)
+{
+    Message value;
+    muesli::StringIStream stream(message(R"([{"tDouble":0.5,"tString":"a"}])", "{}"));
+    muesli::JsonInputArchive<muesli::StringIStream> jsonInputArchive(stream);
+    EXPECT_FALSE(jsonInputArchive.recordsErrors());
+    EXPECT_THROW(jsonInputArchive(value), muesli::exceptions::ValueNotFoundException);
+}
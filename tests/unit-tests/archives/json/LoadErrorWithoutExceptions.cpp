@@ -0,0 +1,86 @@
+/*
+ * #%L
+ * %%
+ * Copyright (C) 2011 - 2016 BMW Car IT GmbH
+ * %%
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ * 
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ * 
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ * #L%
+ */
+
+// compiled with -fno-exceptions, see CMakeLists.txt: loading with a LoadError must not depend
+// on exception support
+
+#include <cstdint>
+#include <map>
+#include <string>
+#include <vector>
+
+#include "muesli/LoadError.h"
+#include "muesli/NameValuePair.h"
+#include "muesli/Traits.h"
+#include "muesli/archives/json/JsonInputArchive.h"
+#include "muesli/streams/StringIStream.h"
+
+namespace
+{
+enum class Priority { Low, High };
+
+struct PriorityWrapper
+{
+    static bool tryGetEnum(const std::string& literal, Priority& priority)
+    {
+        priority = literal == "HIGH" ? Priority::High : Priority::Low;
+        return literal == "HIGH" || literal == "LOW";
+    }
+
+    static Priority getEnum(const std::string& literal)
+    {
+        return literal == "HIGH" ? Priority::High : Priority::Low;
+    }
+};
+
+struct Message
+{
+    std::string _text;
+    std::vector<std::int32_t> _values;
+    std::map<Priority, std::string> _names;
+    Priority _priority;
+
+    template <typename Archive>
+    void serialize(Archive& archive)
+    {
+        archive(muesli::make_nvp("text", _text),
+                muesli::make_nvp("values", _values),
+                muesli::make_nvp("names", _names),
+                muesli::make_nvp("priority", _priority));
+    }
+};
+} // namespace
+
+namespace muesli
+{
+template <>
+struct EnumTraits<Priority>
+{
+    using Wrapper = PriorityWrapper;
+};
+} // namespace muesli
+
+bool loadWithoutExceptions(const std::string& json, muesli::LoadError& error)
+{
+    Message message;
+    muesli::StringIStream stream(json);
+    muesli::JsonInputArchive<muesli::StringIStream> jsonInputArchive(stream, error);
+    jsonInputArchive(message);
+    return !error;
+}
@@ -0,0 +1,147 @@
+/*
+ * #%L
+ * %%
+ * Copyright (C) 2011 - 2016 BMW Car IT GmbH
+ * %%
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ * 
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ * 
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ * #L%
+ */
+
+#include <string>
+
+#include <boost/optional.hpp>
+
+#include <gtest/gtest.h>
+
+#include "muesli/NameValuePair.h"
+#include "muesli/archives/json/JsonInputArchive.h"
+#include "muesli/archives/json/JsonOutputArchive.h"
+#include "muesli/archives/json/RawJson.h"
+#include "muesli/exceptions/ValueNotFoundException.h"
+#include "muesli/streams/StringIStream.h"
+#include "muesli/streams/StringOStream.h"
+
+namespace
+{
+struct Envelope
+{
+    std::string _route;
+    muesli::RawJson _payload;
+
+    template <typename Archive>
+    void serialize(Archive& archive)
+    {
+        archive(muesli::make_nvp("route", _route), muesli::make_nvp("payload", _payload));
+    }
+};
+
+struct OptionalEnvelope
+{
+    boost::optional<muesli::RawJson> _payload;
+    std::string _route;
+
+    template <typename Archive>
+    void serialize(Archive& archive)
+    {
+        archive(muesli::make_nvp("payload", _payload), muesli::make_nvp("route", _route));
+    }
+};
+} // namespace
+
+class RawJsonTest : public ::testing::Test
+{
+public:
+    RawJsonTest()
+            : _serializedEnvelope(R"({"route":"a/b","payload":{"x":[1,-2.5,{"y":null}],"z":"s"}})"),
+              _serializedPayload(R"({"x":[1,-2.5,{"y":null}],"z":"s"})")
+    {
+    }
+
+protected:
+    template <typename T>
+    static void deserialize(const std::string& serialized, T& value)
+    {
+        muesli::StringIStream stream(serialized);
+        muesli::JsonInputArchive<muesli::StringIStream> jsonInputArchive(stream);
+        jsonInputArchive(value);
+    }
+
+    template <typename T>
+    static std::string serialize(const T& value)
+    {
+        muesli::StringOStream stream;
+        muesli::JsonOutputArchive<muesli::StringOStream> jsonOutputArchive(stream);
+        jsonOutputArchive(value);
+        return stream.getString();
+    }
+
+    std::string _serializedEnvelope;
+    std::string _serializedPayload;
+};
+
+TEST_F(RawJsonTest, loadKeepsSubtreeAsJson)
+{
+    Envelope envelope;
+    deserialize(_serializedEnvelope, envelope);
+    EXPECT_EQ("a/b", envelope._route);
+    EXPECT_EQ(_serializedPayload, envelope._payload.getJson());
+}
+
+TEST_F(RawJsonTest, loadCompactsWhitespace)
+{
+    Envelope envelope;
+    deserialize(R"({ "route" : "a/b", "payload" : [ 1, "two" ,true ] })", envelope);
+    EXPECT_EQ(R"([1,"two",true])", envelope._payload.getJson());
+}
+
+TEST_F(RawJsonTest, saveWritesVerbatim)
+{
+    Envelope envelope{"a/b", muesli::RawJson(_serializedPayload)};
+    EXPECT_EQ(_serializedEnvelope, serialize(envelope));
+}
+
+TEST_F(RawJsonTest, roundtripScalars)
+{
+    for (const std::string payload : {"42", "-1.5", R"("text")", "true", "false", "null"}) {
+        Envelope envelope;
+        deserialize(R"({"route":"r","payload":)" + payload + "}", envelope);
+        EXPECT_EQ(payload, envelope._payload.getJson());
+        EXPECT_EQ(R"({"route":"r","payload":)" + payload + "}", serialize(envelope));
+    }
+}
+
+TEST_F(RawJsonTest, emptyRawJsonIsWrittenAsNull)
+{
+    Envelope envelope{"r", muesli::RawJson()};
+    EXPECT_EQ(R"({"route":"r","payload":null})", serialize(envelope));
+}
+
+TEST_F(RawJsonTest, missingValueThrows)
+{
+    Envelope envelope;
+    EXPECT_THROW(deserialize(R"({"route":"r"})", envelope),
+                 muesli::exceptions::ValueNotFoundException);
+}
+
+TEST_F(RawJsonTest, optionalRawJson)
+{
+    OptionalEnvelope envelope;
+    deserialize(R"({"payload":{"route":"inner"},"route":"outer"})", envelope);
+    ASSERT_TRUE(envelope._payload);
+    EXPECT_EQ(R"({"route":"inner"})", envelope._payload->getJson());
+    EXPECT_EQ("outer", envelope._route);
+
+    OptionalEnvelope withoutPayload;
+    deserialize(R"({"route":"outer"})", withoutPayload);
+    EXPECT_FALSE(withoutPayload._payload);
+}
@@ -0,0 +1,182 @@
+/*
+ * #%L
+ * %%
+ * Copyright (C) 2011 - 2016 BMW Car IT GmbH
+ * %%
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ * 
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ * 
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ * #L%
+ */
+
+#include <algorithm>
+#include <array>
+#include <sstream>
+#include <streambuf>
+#include <string>
+#include <vector>
+
+#include <boost/concept_check.hpp>
+#include <gtest/gtest.h>
+
+#include "muesli/archives/json/JsonInputArchive.h"
+#include "muesli/concepts/InputStream.h"
+#include "muesli/streams/AnyIStream.h"
+#include "muesli/streams/StdIStreamWrapper.h"
+#include "muesli/streams/StringIStream.h"
+
+namespace
+{
+// stream buffer which hands out 'input' in chunks of three characters and cannot seek
+class NonSeekableStreamBuffer : public std::streambuf
+{
+public:
+    explicit NonSeekableStreamBuffer(std::string input) : _input(std::move(input)), _position(0)
+    {
+    }
+
+protected:
+    int_type underflow() override
+    {
+        if (_position == _input.size()) {
+            return traits_type::eof();
+        }
+        const std::size_t count = std::min<std::size_t>(3, _input.size() - _position);
+        char* chunk = &_input[_position];
+        setg(chunk, chunk, chunk + count);
+        _position += count;
+        return traits_type::to_int_type(*chunk);
+    }
+
+private:
+    std::string _input;
+    std::size_t _position;
+};
+} // namespace
+
+TEST(AnyIStreamTest, conceptCheck)
+{
+    BOOST_CONCEPT_ASSERT(
+            (muesli::concepts::InputStream<muesli::AnyIStreamWrapper<muesli::StringIStream>>));
+}
+
+TEST(AnyIStreamTest, getCharUntilEof)
+{
+    muesli::StringIStream stream("12");
+    muesli::AnyIStreamWrapper<muesli::StringIStream> anyStream(stream);
+
+    EXPECT_EQ('1', anyStream.peek());
+    EXPECT_EQ(0, anyStream.tell());
+    EXPECT_EQ('1', anyStream.get());
+    EXPECT_EQ('2', anyStream.get());
+    EXPECT_EQ(2, anyStream.tell());
+    EXPECT_EQ('\0', anyStream.peek());
+    EXPECT_EQ('\0', anyStream.get());
+}
+
+TEST(AnyIStreamTest, getChars_RequestMoreCharsThanAvailable)
+{
+    muesli::StringIStream stream("12");
+    muesli::AnyIStreamWrapper<muesli::StringIStream> anyStream(stream);
+    std::array<muesli::AnyIStream::Char, 3> dest;
+
+    anyStream.get(dest.data(), dest.size());
+
+    EXPECT_EQ('1', dest.at(0));
+    EXPECT_EQ('2', dest.at(1));
+    EXPECT_EQ('\0', dest.at(2));
+}
+
+TEST(AnyIStreamTest, readAcrossBufferBoundaries)
+{
+    std::string input;
+    for (int i = 0; i < 10000; ++i) {
+        input += static_cast<char>('a' + i % 26);
+    }
+    muesli::StringIStream stream(input);
+    muesli::AnyIStreamWrapper<muesli::StringIStream> anyStream(stream);
+
+    for (std::size_t i = 0; i < 5000; ++i) {
+        ASSERT_EQ(i, anyStream.tell());
+        ASSERT_EQ(input[i], anyStream.get());
+    }
+    std::vector<muesli::AnyIStream::Char> rest(5000);
+    anyStream.get(rest.data(), rest.size());
+    EXPECT_EQ(input.substr(5000), std::string(rest.data(), rest.size()));
+    EXPECT_EQ(10000, anyStream.tell());
+    EXPECT_EQ('\0', anyStream.get());
+}
+
+TEST(AnyIStreamTest, wrapStdIStreamWithBinaryData)
+{
+    const std::string input("a\nb\0c", 5);
+    std::istringstream stream(input);
+    muesli::AnyIStreamWrapper<std::istringstream> anyStream(stream);
+    std::array<muesli::AnyIStream::Char, 5> dest;
+
+    anyStream.get(dest.data(), dest.size());
+
+    EXPECT_EQ(input, std::string(dest.data(), dest.size()));
+    EXPECT_EQ(5, anyStream.tell());
+}
+
+TEST(AnyIStreamTest, jsonInputArchive)
+{
+    muesli::StringIStream stream("[1,2,3]");
+    muesli::AnyIStreamWrapper<muesli::StringIStream> anyStream(stream);
+    muesli::JsonInputArchive<muesli::AnyIStream> archive(anyStream);
+    std::vector<int> value;
+    archive(value);
+    EXPECT_EQ((std::vector<int>{1, 2, 3}), value);
+}
+
+TEST(AnyIStreamTest, wrapStdIStreamWrapperWithMultipleLines)
+{
+    const std::string input = "{\n    \"a\": [\n        1,\n        2\n    ]\n}\n";
+    std::stringstream stream(input);
+    muesli::StdIStreamWrapper<std::stringstream> wrappedStream(stream);
+    muesli::AnyIStreamWrapper<muesli::StdIStreamWrapper<std::stringstream>> anyStream(
+            wrappedStream);
+    std::vector<muesli::AnyIStream::Char> dest(input.size());
+
+    anyStream.get(dest.data(), dest.size());
+
+    EXPECT_EQ(input, std::string(dest.data(), dest.size()));
+    EXPECT_EQ(input.size(), anyStream.tell());
+    EXPECT_EQ('\0', anyStream.get());
+}
+
+TEST(AnyIStreamTest, wrapNonSeekableStdIStreamWrapper)
+{
+    const std::string input = "line 1\nline 2\n";
+    NonSeekableStreamBuffer streamBuffer(input);
+    std::istream stream(&streamBuffer);
+    muesli::StdIStreamWrapper<std::istream> wrappedStream(stream);
+    muesli::AnyIStreamWrapper<muesli::StdIStreamWrapper<std::istream>> anyStream(wrappedStream);
+
+    for (std::size_t i = 0; i < input.size(); ++i) {
+        ASSERT_EQ(i, anyStream.tell());
+        ASSERT_EQ(input[i], anyStream.get());
+    }
+    EXPECT_EQ('\0', anyStream.get());
+}
+
+TEST(AnyIStreamTest, jsonInputArchiveReadsMultipleLinesThroughStdIStreamWrapper)
+{
+    std::stringstream stream("[\n    1,\n    2,\n    3\n]\n");
+    muesli::StdIStreamWrapper<std::stringstream> wrappedStream(stream);
+    muesli::AnyIStreamWrapper<muesli::StdIStreamWrapper<std::stringstream>> anyStream(
+            wrappedStream);
+    muesli::JsonInputArchive<muesli::AnyIStream> archive(anyStream);
+    std::vector<int> value;
+    archive(value);
+    EXPECT_EQ((std::vector<int>{1, 2, 3}), value);
+}
@@ -0,0 +1,87 @@
+/*
+ * #%L
+ * %%
+ * Copyright (C) 2011 - 2016 BMW Car IT GmbH
+ * %%
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ * 
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ * 
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ * #L%
+ */
+
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include <boost/concept_check.hpp>
+#include <gtest/gtest.h>
+
+#include "muesli/archives/json/JsonOutputArchive.h"
+#include "muesli/concepts/OutputStream.h"
+#include "muesli/streams/AnyOStream.h"
+#include "muesli/streams/StringOStream.h"
+
+TEST(AnyOStreamTest, conceptCheck)
+{
+    BOOST_CONCEPT_ASSERT(
+            (muesli::concepts::OutputStream<muesli::AnyOStreamWrapper<muesli::StringOStream>>));
+}
+
+TEST(AnyOStreamTest, charactersAreBufferedUntilFlush)
+{
+    muesli::StringOStream stream;
+    muesli::AnyOStreamWrapper<muesli::StringOStream> anyStream(stream);
+    anyStream.put('a');
+    anyStream.write("bc", 2);
+    EXPECT_EQ("", stream.getString());
+    anyStream.flush();
+    EXPECT_EQ("abc", stream.getString());
+}
+
+TEST(AnyOStreamTest, charactersAreWrittenOnDestruction)
+{
+    muesli::StringOStream stream;
+    {
+        muesli::AnyOStreamWrapper<muesli::StringOStream> anyStream(stream);
+        anyStream.write("abc", 3);
+    }
+    EXPECT_EQ("abc", stream.getString());
+}
+
+TEST(AnyOStreamTest, writeMoreThanBufferSize)
+{
+    std::string expected;
+    for (int i = 0; i < 10000; ++i) {
+        expected += static_cast<char>('a' + i % 26);
+    }
+    const std::string large(20000, '#');
+    expected += large;
+    expected += "end";
+
+    std::ostringstream stream;
+    muesli::AnyOStreamWrapper<std::ostringstream> anyStream(stream);
+    for (int i = 0; i < 10000; ++i) {
+        anyStream.put(expected[static_cast<std::size_t>(i)]);
+    }
+    anyStream.write(large.data(), large.size());
+    anyStream.write("end", 3);
+    anyStream.flush();
+    EXPECT_EQ(expected, stream.str());
+}
+
+TEST(AnyOStreamTest, jsonOutputArchive)
+{
+    muesli::StringOStream stream;
+    muesli::AnyOStreamWrapper<muesli::StringOStream> anyStream(stream);
+    muesli::JsonOutputArchive<muesli::AnyOStream> archive(anyStream);
+    archive(std::vector<int>{1, 2, 3});
+    EXPECT_EQ("[1,2,3]", stream.getString());
+}
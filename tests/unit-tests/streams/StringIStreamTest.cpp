@@ -168,3 +168,15 @@ TYPED_TEST(StringIStreamTest, initWithLongString)
     auto stream = TypeParam::getStream(std::string(1000, '#'));
     ASSERT_EQ('#', stream.peek());
 }
+
+TYPED_TEST(StringIStreamTest, readReturnsNumberOfExtractedChars)
+{
+    auto stream = TypeParam::getStream(std::string("a\nb\0c", 5));
+    std::array<muesli::StringIStream::Char, 4> dest;
+
+    ASSERT_EQ(4u, stream.read(dest.data(), dest.size()));
+    ASSERT_EQ(std::string("a\nb\0", 4), std::string(dest.data(), 4));
+    ASSERT_EQ(1u, stream.read(dest.data(), dest.size()));
+    ASSERT_EQ('c', dest.at(0));
+    ASSERT_EQ(0u, stream.read(dest.data(), dest.size()));
+}